@@ -0,0 +1,84 @@
+#ifndef SDL_OGL_APPCONFIG_H
+#define SDL_OGL_APPCONFIG_H
+
+#include <string>
+
+#include "FramePacer.h"
+
+// Opciones de linea de comandos
+struct AppConfig {
+    // Modo headless: sin ventana, EGL surfaceless + FBO, frames fijos y reporte JSON
+    bool headless = false;
+    int width = 800;
+    int height = 600;
+    int frames = 300;
+    // Frames iniciales excluidos de las estadisticas
+    int warmupFrames = 10;
+
+    // Frecuencia de la simulacion de paso fijo (ticks por segundo)
+    int tickRate = 60;
+
+    // Ritmo de presentacion (ver FramePacer.h)
+    PacingMode pacing = PACING_VSYNC;
+    int targetFps = 0;
+    int framesInFlight = 2;
+    int smoothingFrames = 4;
+    std::string reportPath = "-";
+    // 0 = valor por defecto de llvmpipe (LP_NUM_THREADS o numero de CPUs)
+    int llvmpipeThreads = 0;
+
+    // Grabacion/reproduccion de input (ver InputRecording.h)
+    std::string recordPath;
+    std::string replayPath;
+
+    // Microbenchmark de CPU a ejecutar en lugar de la aplicacion (ver Benchmarks.h)
+    std::string benchmark;
+    // Hilos de trabajo; 0 = cores logicos
+    int threads = 0;
+    // Fijar cada worker del JobSystem a un core
+    bool pinThreads = false;
+
+    // Envio GL desde un hilo de render dedicado (ver RenderThread.h)
+    bool renderThread = true;
+    // KB subidos por frame desde el streaming de texturas (ver TextureStreamer.h)
+    int uploadBudgetKB = 1024;
+    // Presupuesto de VRAM de la cache de texturas en MB (ver TextureCache.h)
+    int vramBudgetMB = 256;
+    // MB de niveles de mip que puede tener cargados el streaming progresivo de .tex (ver TextureStreamer.h)
+    int mipBudgetMB = 64;
+    // Crear las texturas en un hilo con contexto GL compartido (ver GpuLoader.h)
+    bool loaderThread = false;
+
+    // Directorio de binarios de programas GL (ver ProgramCache.h); vacio = sin cache. Relativo al directorio
+    // de preferencias del usuario (SDL_GetPrefPath) o, sin el, al del ejecutable; el de --program-cache ya
+    // llega absoluto
+    std::string programCacheDir = "shader_cache";
+    // Recompilar los shaders al guardarlos (ver ShaderManager.h)
+    bool hotReload = false;
+    // Cargar los modulos SPIR-V de shader_compiler si el driver tiene GL 4.6
+    bool spirv = true;
+    // Paquete de assets y shaders cocinados (ver AssetCooker.h); vacio = solo ficheros sueltos. Relativo al
+    // directorio del ejecutable (SDL_GetBasePath); el de --pack ya llega absoluto
+    std::string packPath = "data.pak";
+    // Ficheros sueltos: los originales que no van en el paquete (benchmarks, --hot-reload). El arbol de
+    // fuentes solo en Debug; vacio = directorio del ejecutable
+#ifdef SDL_OGL_SOURCE_DIR
+    std::string sourceDirectory = SDL_OGL_SOURCE_DIR;
+#else
+    std::string sourceDirectory;
+#endif
+    // Modo desarrollo (--hot-reload, --source-dir, --no-pack o --bench): se leen ficheros sueltos y se
+    // aceptan originales sin cocinar. Si no, solo el paquete y lo que falte en el es un error
+    bool devAssets = false;
+
+    // Loguea por frame el tiempo desde el timestamp del input hasta el swap
+    bool latencyLog = false;
+};
+
+bool parseAppConfig(int argc, char *argv[], AppConfig &config);
+
+// Hilos que usara llvmpipe segun LP_NUM_THREADS o, si no esta definido, los cores logicos
+int resolveLlvmpipeThreads(const AppConfig &config);
+
+
+#endif //SDL_OGL_APPCONFIG_H
@@ -0,0 +1,56 @@
+#ifndef SDL_OGL_ASSETCOOKER_H
+#define SDL_OGL_ASSETCOOKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "JobSystem.h"
+
+// Cocinado de assets: cada fichero fuente se convierte al formato que carga la aplicacion y el resultado se
+// empaqueta (ver AssetPack.h), asi el arranque no decodifica ni optimiza nada:
+//   imagenes (.png, .jpg, .jpeg, .bmp, .tga) -> .tex RGBA8 con la cadena de mips (ver TextureFile.h)
+//   .vert/.frag -> el GLSL y, con shader_compiler, sus modulos SPIR-V optimizados (ver Spirv.h)
+//   el resto (.glsl, .tex, .dds...) -> tal cual
+// Incremental: un manifiesto en el directorio de cache guarda por fuente el hash de su contenido y el de sus
+// dependencias (#include de los shaders) y los ficheros generados. Solo se cocina lo que cambio; lo que
+// generaba un fuente borrado se elimina. Los fuentes se cocinan en paralelo con el JobSystem (un job por
+// fuente; cada uno genera sus mips sin repartirlos).
+
+// Cambiar cuando cambie el resultado de alguna regla: invalida todo lo cocinado antes
+static constexpr uint32_t ASSET_COOKER_VERSION = 1;
+
+struct AssetCookOptions {
+    // Las rutas de los assets ("assets/a.png") son relativas a este directorio
+    std::string sourceDirectory;
+    // Ficheros o directorios (recursivos) relativos a sourceDirectory
+    std::vector<std::string> inputs;
+    // Resultados cocinados y manifiesto
+    std::string cacheDirectory;
+    // Paquete con todo lo cocinado; vacio = no empaquetar
+    std::string packPath;
+    // Los tres vacios = sin SPIR-V
+    std::string shaderCompiler;
+    std::string glslang;
+    std::string spirvOptimizer;
+};
+
+struct AssetCookStats {
+    size_t sourceCount = 0;
+    size_t cookedCount = 0;
+    size_t upToDateCount = 0;
+    size_t failedCount = 0;
+    // Ficheros generados que ya no corresponden a ningun fuente
+    size_t removedCount = 0;
+    bool packWritten = false;
+};
+
+// Ruta con la que la aplicacion pide el resultado cocinado de sourcePath ("assets/a.png" -> "assets/a.tex")
+std::string cookedAssetPath(const std::string &sourcePath);
+
+// Hilo worker 0 de jobs. false si algun fuente no se pudo cocinar (el resto si queda cocinado)
+bool cookAssets(const AssetCookOptions &options, JobSystem &jobs, AssetCookStats &stats);
+
+
+#endif //SDL_OGL_ASSETCOOKER_H
@@ -0,0 +1,121 @@
+#ifndef SDL_OGL_ASSETFILESYSTEM_H
+#define SDL_OGL_ASSETFILESYSTEM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "AssetPack.h"
+
+struct SDL_Surface;
+
+// Contenido de un asset. Las entradas sin comprimir apuntan dentro del paquete mapeado (sin copia); las
+// comprimidas y los ficheros sueltos tienen su propio buffer o mapeo. Copiar es barato: los bytes se
+// comparten y siguen validos mientras quede alguna copia
+class AssetData {
+public:
+    const uint8_t *data() const;
+
+    size_t size() const;
+
+    bool empty() const;
+
+    // true si data() es memoria del paquete mapeado
+    bool isZeroCopy() const;
+
+    // Pide al sistema que lea ya las paginas desde offset hasta el final (solo si esta mapeado)
+    void prefetch(size_t offset = 0) const;
+
+private:
+    friend class AssetFileSystem;
+
+    const uint8_t *bytes = nullptr;
+    size_t length = 0;
+    bool mapped = false;
+    bool zeroCopy = false;
+    std::shared_ptr<const void> owner;
+};
+
+// Sistema de ficheros de solo lectura sobre un paquete (ver AssetPack.h) mapeado en memoria: con el paquete
+// montado, cargar assets no abre ningun fichero mas. Las rutas que no estan en el paquete se leen sueltas
+// (tambien mapeadas) del directorio de setLooseDirectory; con setLooseFirst(true) el fichero suelto tiene
+// prioridad, para editar en caliente. Con setLooseEnabled(false) solo existe lo que hay en el paquete.
+// Hilos: mount/unmount/setLoose* con los loaders parados; read y exists desde cualquier hilo
+class AssetFileSystem {
+public:
+    AssetFileSystem();
+
+    ~AssetFileSystem();
+
+    AssetFileSystem(const AssetFileSystem &) = delete;
+
+    AssetFileSystem &operator=(const AssetFileSystem &) = delete;
+
+    // false si no existe o no es un paquete valido (sigue sirviendo ficheros sueltos)
+    bool mount(const std::string &packPath);
+
+    void unmount();
+
+    bool isMounted() const;
+
+    void setLooseFirst(bool looseFirst);
+
+    // false = nunca se leen ficheros sueltos (por defecto true)
+    void setLooseEnabled(bool looseEnabled);
+
+    // Las rutas relativas sueltas se buscan aqui (vacio = directorio actual)
+    void setLooseDirectory(const std::string &directory);
+
+    // Ruta en disco del fichero suelto que corresponde a path
+    std::string loosePath(const std::string &path) const;
+
+    bool exists(const std::string &path) const;
+
+    // false si no existe o una entrada comprimida esta corrupta
+    bool read(const std::string &path, AssetData &data);
+
+    size_t getEntryCount() const;
+
+    // Ficheros abiertos (el paquete y cada fichero suelto), lecturas del paquete, cuantas de ellas sin
+    // copia y lecturas de ficheros sueltos
+    size_t getFileOpenCount() const;
+
+    size_t getPackReadCount() const;
+
+    size_t getZeroCopyCount() const;
+
+    size_t getLooseReadCount() const;
+
+    void resetCounters();
+
+private:
+    const AssetPackEntry *find(const std::string &path) const;
+
+    bool readLoose(const std::string &path, AssetData &data);
+
+    std::shared_ptr<const void> pack;
+    const uint8_t *packData;
+    size_t packSize;
+    const AssetPackEntry *entries;
+    uint32_t entryCount;
+    bool looseFirst;
+    bool looseEnabled;
+    std::string looseDirectory;
+
+    std::atomic<size_t> fileOpenCount;
+    std::atomic<size_t> packReadCount;
+    std::atomic<size_t> zeroCopyCount;
+    std::atomic<size_t> looseReadCount;
+};
+
+// El de la aplicacion: lo usan todos los loaders
+AssetFileSystem &assetFileSystem();
+
+// Lee path de assetFileSystem() y lo decodifica con SDL_image; nullptr si falla (SDL_GetError).
+// En AssetImage.cpp: solo quien la usa enlaza SDL3_image
+SDL_Surface *loadAssetImage(const std::string &path);
+
+
+#endif //SDL_OGL_ASSETFILESYSTEM_H
@@ -0,0 +1,71 @@
+#ifndef SDL_OGL_ASSETPACK_H
+#define SDL_OGL_ASSETPACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Paquete de assets: cabecera + tabla de entradas ordenada por hash de la ruta (y ruta, si dos hashes
+// coinciden) + rutas normalizadas + datos. La busqueda es binaria por hash y compara la ruta para no
+// devolver otro asset ante una colision. Cada entrada empieza en un offset alineado (4KB para .tex, que se
+// sube directamente desde el mapeo; 64 bytes el resto) y va sin comprimir o en un bloque LZ4 (ver Lz4.h).
+// Se lee mapeado con AssetFileSystem.
+static constexpr uint32_t ASSET_PACK_MAGIC = 0x4B504F53; // "SOPK"
+// 2: rutas guardadas junto a su hash
+static constexpr uint32_t ASSET_PACK_VERSION = 2;
+static constexpr uint32_t ASSET_PACK_ALIGNMENT = 64;
+// La de los niveles dentro de un .tex (TEXTURE_FILE_ALIGNMENT)
+static constexpr uint32_t ASSET_PACK_TEXTURE_ALIGNMENT = 4096;
+static constexpr uint32_t ASSET_COMPRESSION_NONE = 0;
+static constexpr uint32_t ASSET_COMPRESSION_LZ4 = 1;
+
+struct AssetPackHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+};
+
+struct AssetPackEntry {
+    // hashAssetPath de la ruta normalizada
+    uint64_t pathHash;
+    // La ruta normalizada, sin '\0', en el paquete
+    uint64_t nameOffset;
+    uint64_t offset;
+    // Bytes en el paquete y bytes una vez descomprimido
+    uint64_t storedSize;
+    uint64_t size;
+    uint32_t nameSize;
+    uint32_t compression;
+    uint32_t alignment;
+    uint32_t reserved;
+};
+
+// Fichero a empaquetar: name es la ruta con la que lo pediran los loaders ("shaders/cube.vert")
+struct AssetPackInput {
+    std::string name;
+    std::string sourcePath;
+};
+
+struct AssetPackSummary {
+    size_t entryCount = 0;
+    size_t compressedCount = 0;
+    uint64_t originalBytes = 0;
+    uint64_t storedBytes = 0;
+    uint64_t packBytes = 0;
+};
+
+// Ruta relativa con '/' y sin "." ni "..": "assets/./a.png" y "assets/../assets/a.png" son "assets/a.png".
+// Las absolutas dentro del directorio actual pasan a relativas
+std::string normalizeAssetPath(const std::string &path);
+
+// FNV-1a de normalizeAssetPath(path)
+uint64_t hashAssetPath(const std::string &path);
+
+// LZ4 solo donde ahorra al menos 1/8; los .tex siempre sin comprimir. summary puede ser nullptr
+bool writeAssetPack(const std::string &path, const std::vector<AssetPackInput> &files,
+                    AssetPackSummary *summary = nullptr);
+
+
+#endif //SDL_OGL_ASSETPACK_H
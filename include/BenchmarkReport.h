@@ -0,0 +1,77 @@
+#ifndef SDL_OGL_BENCHMARKREPORT_H
+#define SDL_OGL_BENCHMARKREPORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Mide tiempos de CPU (submision) y GPU (GL_TIME_ELAPSED) por frame y los vuelca
+// como JSON. Los resultados de GPU se leen con retraso para no bloquear el pipeline.
+class BenchmarkReport {
+public:
+    BenchmarkReport();
+
+    ~BenchmarkReport();
+
+    // Los primeros warmupFrames no cuentan (compilacion de shaders, primera query de llvmpipe...)
+    void begin(int width, int height, int llvmpipeThreads, int warmupFrames);
+
+    void beginFrame();
+
+    // Ticks de simulacion ejecutados en el frame actual
+    void recordSimTicks(int ticks);
+
+    void endFrame();
+
+    // Espera total entre hilo principal y de render (ver RenderThread)
+    void setThreadWaits(double mainWaitMs, double renderWaitMs);
+
+    // Estado final de la cache de texturas (ver TextureCache)
+    void setTextureCache(double hitRate, size_t residentBytes);
+
+    // Programas de arranque servidos desde la cache de binarios (ver ProgramCache)
+    void setProgramCache(size_t hits, size_t misses, double compileMs, double savedMs);
+
+    // Bloquea hasta que la GPU termina y recoge las queries pendientes
+    void finish();
+
+    std::string toJson() const;
+
+    bool write(const std::string &path) const;
+
+private:
+    static constexpr int QUERY_COUNT = 4;
+
+    void collectQuery(int slot);
+
+    unsigned int queries[QUERY_COUNT];
+    bool queryPending[QUERY_COUNT];
+    int frameIndex;
+    int warmupFrames;
+
+    uint64_t startNS;
+    uint64_t endNS;
+    uint64_t frameStartNS;
+
+    int width;
+    int height;
+    int llvmpipeThreads;
+    double mainWaitMs;
+    double renderWaitMs;
+    double textureHitRate;
+    size_t textureResidentBytes;
+    size_t programHits;
+    size_t programMisses;
+    double programCompileMs;
+    double programSavedMs;
+    std::string renderer;
+    std::string version;
+
+    std::vector<double> cpuMs;
+    std::vector<double> gpuMs;
+    std::vector<double> simTicks;
+};
+
+
+#endif //SDL_OGL_BENCHMARKREPORT_H
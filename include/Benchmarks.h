@@ -0,0 +1,11 @@
+#ifndef SDL_OGL_BENCHMARKS_H
+#define SDL_OGL_BENCHMARKS_H
+
+#include "AppConfig.h"
+
+// Microbenchmarks de CPU seleccionados con --bench NAME. Escriben un JSON en config.reportPath
+// y no crean ventana. Devuelve false si el nombre no existe o el benchmark falla.
+bool runBenchmark(const AppConfig &config);
+
+
+#endif //SDL_OGL_BENCHMARKS_H
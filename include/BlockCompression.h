@@ -0,0 +1,43 @@
+#ifndef SDL_OGL_BLOCKCOMPRESSION_H
+#define SDL_OGL_BLOCKCOMPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "JobSystem.h"
+
+// Formatos comprimidos por bloques de 4x4 que genera el codificador
+enum BlockFormat {
+    BLOCK_FORMAT_BC1, // RGB, 4 bpp
+    BLOCK_FORMAT_BC3, // RGBA (alfa BC4), 8 bpp
+    BLOCK_FORMAT_BC4, // R (RGTC1), 4 bpp
+    BLOCK_FORMAT_BC5, // RG (RGTC2), 8 bpp
+    BLOCK_FORMAT_BC7, // RGBA, 8 bpp; solo se emite el modo 6
+    BLOCK_FORMAT_COUNT
+};
+
+const char *blockFormatName(BlockFormat format);
+
+bool parseBlockFormat(const std::string &name, BlockFormat &format);
+
+// Bytes por bloque de 4x4: 8 o 16
+size_t blockFormatBlockBytes(BlockFormat format);
+
+size_t blockFormatLevelBytes(BlockFormat format, int width, int height);
+
+// Canales RGBA que conserva el formato (para el PSNR)
+int blockFormatChannels(BlockFormat format);
+
+// rgba: width x height RGBA8 sin padding. out: blockFormatLevelBytes bytes. Con jobs reparte las filas de bloques
+void compressImage(BlockFormat format, const uint8_t *rgba, int width, int height, uint8_t *out,
+                   JobSystem *jobs = nullptr);
+
+// Inversa de compressImage (BC7: solo modo 6). Los canales que el formato no guarda quedan a 0 (alfa a 255)
+void decompressImage(BlockFormat format, const uint8_t *blocks, int width, int height, uint8_t *rgba);
+
+// PSNR en dB sobre los primeros channels canales de cada pixel RGBA8
+double computePsnr(const uint8_t *reference, const uint8_t *test, size_t pixels, int channels);
+
+
+#endif //SDL_OGL_BLOCKCOMPRESSION_H
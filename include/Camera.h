@@ -1,7 +1,9 @@
 #ifndef SDL_OGL_CAMERA_H
 #define SDL_OGL_CAMERA_H
 
+#include <cstdint>
 #include <glm.hpp>
+#include <gtc/quaternion.hpp>
 
 enum Camera_Movement {
     FORWARD,
@@ -10,35 +12,111 @@ enum Camera_Movement {
     LEFT
 };
 
+// La orientacion se guarda como cuaternion (reconstruido desde yaw/pitch solo cuando cambian)
+// y view, projection, viewProj y sus inversas se cachean hasta que algo las invalida.
 class Camera {
 public:
-    glm::vec3 position;
-    glm::vec3 front;
-    glm::vec3 up;
-    glm::vec3 right;
-    glm::vec3 worldUp;
-
-    float yaw;
-    float pitch;
-
     float movementSpeed;
     float mouseSensitivity;
-    float fov;
 
     Camera(glm::vec3 position = glm::vec3(0.0f, 0.0f, 5.0f), glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f),
            float yaw = -90.0f, float pitch = 0.0f);
 
     ~Camera();
 
-    glm::mat4 getViewMatrix() const;
+    const glm::mat4 &getViewMatrix() const;
+
+    // Vista desde otra posicion con la orientacion actual (p.ej. posicion interpolada)
+    glm::mat4 getViewMatrix(const glm::vec3 &eyePosition) const;
+
+    const glm::mat4 &getProjectionMatrix() const;
+
+    const glm::mat4 &getViewProjectionMatrix() const;
+
+    const glm::mat4 &getInverseViewMatrix() const;
+
+    const glm::mat4 &getInverseProjectionMatrix() const;
+
+    const glm::mat4 &getInverseViewProjectionMatrix() const;
+
+    // Cambia cada vez que se modifica cualquier parametro de la camara. Las caches que
+    // dependen de ella (culling, UBOs, sombras) pueden compararlo para no recalcular.
+    uint32_t getVersion() const;
 
     void processKeyboard(Camera_Movement direction, float deltaTime);
 
     void processMouse(float xOffset, float yOffset);
 
+    void lookAt(const glm::vec3 &target);
+
+    const glm::vec3 &getPosition() const;
+
+    void setPosition(const glm::vec3 &position);
+
+    const glm::quat &getOrientation() const;
+
+    const glm::vec3 &getFront() const;
+
+    const glm::vec3 &getRight() const;
+
+    const glm::vec3 &getUp() const;
+
+    float getYaw() const;
+
+    float getPitch() const;
+
+    float getFov() const;
+
+    void setFov(float fov);
+
+    void setAspectRatio(float aspectRatio);
+
+    void setClipPlanes(float nearPlane, float farPlane);
+
 private:
-    void updateCameraVectors();
+    enum DirtyFlags : uint32_t {
+        ORIENTATION_DIRTY = 1 << 0,
+        VIEW_DIRTY = 1 << 1,
+        PROJECTION_DIRTY = 1 << 2,
+        VIEW_PROJECTION_DIRTY = 1 << 3
+    };
+
+    void markDirty(uint32_t flags);
+
+    void updateOrientation() const;
+
+    void updateView() const;
+
+    void updateProjection() const;
+
+    void updateViewProjection() const;
+
+    glm::vec3 position;
+    glm::vec3 worldUp;
+    float yaw;
+    float pitch;
+
+    float fov;
+    float aspectRatio;
+    float nearPlane;
+    float farPlane;
+
+    uint32_t version;
+    mutable uint32_t dirty;
+
+    mutable glm::quat orientation;
+    mutable glm::vec3 front;
+    mutable glm::vec3 right;
+    mutable glm::vec3 up;
+    mutable glm::mat4 rotation;
+
+    mutable glm::mat4 view;
+    mutable glm::mat4 inverseView;
+    mutable glm::mat4 projection;
+    mutable glm::mat4 inverseProjection;
+    mutable glm::mat4 viewProjection;
+    mutable glm::mat4 inverseViewProjection;
 };
 
 
-#endif //SDL_OGL_CAMERA_H
\ No newline at end of file
+#endif //SDL_OGL_CAMERA_H
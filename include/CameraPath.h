@@ -0,0 +1,25 @@
+#ifndef SDL_OGL_CAMERAPATH_H
+#define SDL_OGL_CAMERAPATH_H
+
+#include <glm.hpp>
+
+class Camera;
+
+// Recorrido de camara guionizado para el modo benchmark: orbita alrededor de un
+// punto con una ligera oscilacion vertical. Depende solo de t, asi que es determinista.
+class CameraPath {
+public:
+    CameraPath(glm::vec3 target = glm::vec3(0.0f), float radius = 5.0f, float height = 1.5f, float revolutions = 1.0f);
+
+    // t en [0, 1]
+    void apply(Camera &camera, float t) const;
+
+private:
+    glm::vec3 target;
+    float radius;
+    float height;
+    float revolutions;
+};
+
+
+#endif //SDL_OGL_CAMERAPATH_H
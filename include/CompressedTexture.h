@@ -0,0 +1,37 @@
+#ifndef SDL_OGL_COMPRESSEDTEXTURE_H
+#define SDL_OGL_COMPRESSEDTEXTURE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BlockCompression.h"
+
+// Textura comprimida por bloques con su cadena de mips (nivel 0 primero). Las filas van
+// en el orden de la imagen, como en cualquier DDS (la primera fila de bloques es la superior), y se suben
+// sin voltear: la orientacion la corrige cube.vert
+struct CompressedImage {
+    BlockFormat format;
+    int width;
+    int height;
+    std::vector<std::vector<uint8_t> > levels;
+};
+
+// DDS: FourCC DXT1/DXT5/ATI1/ATI2 para BC1/3/4/5 y cabecera DX10 para BC7. readDds rechaza tamaños de mas
+// de 16384 y mas niveles de los que admite el tamaño
+bool writeDds(const std::string &path, const CompressedImage &image);
+
+bool readDds(const std::string &path, CompressedImage &image);
+
+// Requiere contexto GL. BC4/BC5 (RGTC) son core; BC1/BC3 necesitan S3TC y BC7 BPTC (las extensiones se
+// consultan en la primera llamada)
+bool isBlockFormatSupported(BlockFormat format);
+
+unsigned int blockFormatGLFormat(BlockFormat format);
+
+// Sube todos los niveles con glCompressedTexImage2D o, si el contexto no soporta el formato,
+// los descomprime en CPU y los sube como RGBA8. Devuelve el nombre de la textura
+unsigned int createCompressedTexture(const CompressedImage &image);
+
+
+#endif //SDL_OGL_COMPRESSEDTEXTURE_H
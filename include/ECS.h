@@ -0,0 +1,334 @@
+#ifndef SDL_OGL_ECS_H
+#define SDL_OGL_ECS_H
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "JobSystem.h"
+
+// ECS por arquetipos: las entidades con el mismo conjunto de componentes comparten
+// arquetipo y se guardan en chunks de 16KB alineados a linea de cache, con un array
+// contiguo por componente (SoA). Los componentes deben ser trivialmente copiables.
+
+typedef uint32_t ComponentId;
+typedef uint64_t ComponentMask;
+
+constexpr size_t ECS_CHUNK_SIZE = 16 * 1024;
+constexpr size_t ECS_CACHE_LINE = 64;
+constexpr ComponentId ECS_MAX_COMPONENTS = 64;
+
+struct Entity {
+    uint32_t index;
+    uint32_t generation;
+
+    bool operator==(const Entity &other) const {
+        return index == other.index && generation == other.generation;
+    }
+};
+
+constexpr Entity NULL_ENTITY = {UINT32_MAX, 0};
+
+struct ComponentInfo {
+    size_t size;
+    size_t alignment;
+};
+
+class ComponentRegistry {
+public:
+    template<typename T>
+    static ComponentId id() {
+        if constexpr (!std::is_same_v<T, std::remove_cv_t<T> >) {
+            // const T y T son el mismo componente
+            return id<std::remove_cv_t<T> >();
+        } else {
+            static_assert(std::is_trivially_copyable_v<T>, "ECS components must be trivially copyable");
+            static const ComponentId value = registerComponent(sizeof(T), alignof(T));
+            return value;
+        }
+    }
+
+    static const ComponentInfo &info(ComponentId id);
+
+private:
+    static ComponentId registerComponent(size_t size, size_t alignment);
+};
+
+template<typename... Ts>
+ComponentMask componentMask() {
+    return ((ComponentMask(1) << ComponentRegistry::id<Ts>()) | ... | ComponentMask(0));
+}
+
+struct Chunk {
+    uint8_t *data;
+    uint32_t count;
+};
+
+struct Archetype {
+    ComponentMask mask;
+    uint32_t capacity;
+    // Offset del array de cada componente dentro del chunk (indexado por ComponentId), UINT32_MAX si no lo tiene
+    uint32_t offsets[ECS_MAX_COMPONENTS];
+    std::vector<ComponentId> components;
+    std::vector<Chunk> chunks;
+    uint32_t entityCount;
+
+    explicit Archetype(ComponentMask mask);
+
+    ~Archetype();
+
+    Entity *entities(const Chunk &chunk) const {
+        // El array de entidades va al principio del chunk
+        return reinterpret_cast<Entity *>(chunk.data);
+    }
+
+    void *component(const Chunk &chunk, ComponentId id, uint32_t row) const {
+        return chunk.data + offsets[id] + row * ComponentRegistry::info(id).size;
+    }
+
+    template<typename T>
+    T *array(const Chunk &chunk) const {
+        return reinterpret_cast<T *>(chunk.data + offsets[ComponentRegistry::id<T>()]);
+    }
+};
+
+class World {
+public:
+    World();
+
+    ~World();
+
+    World(const World &) = delete;
+
+    World &operator=(const World &) = delete;
+
+    template<typename... Ts>
+    Entity create(const Ts &... components) {
+        const Entity entity = createEntity(componentMask<Ts...>());
+        (set<Ts>(entity, components), ...);
+        return entity;
+    }
+
+    void destroy(Entity entity);
+
+    bool isAlive(Entity entity) const;
+
+    template<typename T>
+    bool has(Entity entity) const {
+        return isAlive(entity) && (records[entity.index].archetype->mask & componentMask<T>()) != 0;
+    }
+
+    template<typename T>
+    T *get(Entity entity) {
+        if (!has<T>(entity)) {
+            return nullptr;
+        }
+        const EntityRecord &record = records[entity.index];
+        Archetype *archetype = record.archetype;
+        return static_cast<T *>(archetype->component(archetype->chunks[record.chunk], ComponentRegistry::id<T>(),
+                                                     record.row));
+    }
+
+    template<typename T>
+    void set(Entity entity, const T &value) {
+        if (T *component = get<T>(entity)) {
+            *component = value;
+        }
+    }
+
+    // Cambio estructural: mueve la entidad a otro arquetipo. Usar CommandBuffer mientras se itera
+    template<typename T>
+    void add(Entity entity, const T &value) {
+        if (!isAlive(entity)) {
+            return;
+        }
+        const ComponentMask mask = records[entity.index].archetype->mask | componentMask<T>();
+        moveEntity(entity, mask);
+        set<T>(entity, value);
+    }
+
+    template<typename T>
+    void remove(Entity entity) {
+        if (!isAlive(entity)) {
+            return;
+        }
+        moveEntity(entity, records[entity.index].archetype->mask & ~componentMask<T>());
+    }
+
+    size_t getEntityCount() const;
+
+    // Cambia cuando aparece un arquetipo nuevo; las Query lo usan para invalidar su cache
+    uint32_t getArchetypeVersion() const;
+
+    // Cambia con cada create, destroy y cambio de arquetipo de una entidad
+    uint32_t getStructureVersion() const;
+
+    const std::vector<Archetype *> &getArchetypes() const;
+
+private:
+    friend class CommandBuffer;
+
+    struct EntityRecord {
+        Archetype *archetype;
+        uint32_t chunk;
+        uint32_t row;
+        uint32_t generation;
+    };
+
+    Entity createEntity(ComponentMask mask);
+
+    Archetype *getArchetype(ComponentMask mask);
+
+    // Reserva una fila al final del arquetipo
+    void allocateRow(Archetype *archetype, Entity entity, uint32_t &chunk, uint32_t &row);
+
+    // Quita la fila moviendo la ultima entidad del arquetipo a su hueco
+    void removeRow(Archetype *archetype, uint32_t chunk, uint32_t row);
+
+    void moveEntity(Entity entity, ComponentMask mask);
+
+    // La entidad debe estar viva y tener el componente
+    void *component(Entity entity, ComponentId id);
+
+    std::unordered_map<ComponentMask, std::unique_ptr<Archetype>> archetypes;
+    std::vector<Archetype *> archetypeList;
+    std::vector<EntityRecord> records;
+    std::vector<uint32_t> freeIndices;
+    size_t entityCount;
+    uint32_t structureVersion;
+};
+
+// Query tipada: cachea los arquetipos que contienen Ts... y recorre cada chunk con un
+// bucle plano sobre los arrays de componentes. Los tipos const solo se leen.
+template<typename... Ts>
+class Query {
+public:
+    template<typename F>
+    void each(World &world, F &&function) {
+        refresh(world);
+        for (Archetype *archetype: matches) {
+            for (const Chunk &chunk: archetype->chunks) {
+                runChunk(archetype, chunk, function);
+            }
+        }
+    }
+
+    // Reparte los chunks entre los workers de jobs; function no debe hacer cambios estructurales
+    template<typename F>
+    void parallelEach(World &world, JobSystem &jobs, F &&function) {
+        refresh(world);
+        std::vector<std::pair<Archetype *, const Chunk *> > work;
+        for (Archetype *archetype: matches) {
+            for (const Chunk &chunk: archetype->chunks) {
+                work.emplace_back(archetype, &chunk);
+            }
+        }
+
+        jobs.parallelFor(0, static_cast<uint32_t>(work.size()), 4, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                runChunk(work[i].first, *work[i].second, function);
+            }
+        });
+    }
+
+    size_t count(World &world) {
+        refresh(world);
+        size_t total = 0;
+        for (const Archetype *archetype: matches) {
+            total += archetype->entityCount;
+        }
+        return total;
+    }
+
+private:
+    void refresh(World &world) {
+        if (cachedVersion == world.getArchetypeVersion() && cachedWorld == &world) {
+            return;
+        }
+        const ComponentMask mask = componentMask<Ts...>();
+        matches.clear();
+        for (Archetype *archetype: world.getArchetypes()) {
+            if ((archetype->mask & mask) == mask) {
+                matches.push_back(archetype);
+            }
+        }
+        cachedVersion = world.getArchetypeVersion();
+        cachedWorld = &world;
+    }
+
+    template<typename F>
+    static void runChunk(const Archetype *archetype, const Chunk &chunk, F &function) {
+        runArrays(chunk.count, function, archetype->array<std::remove_cv_t<Ts> >(chunk)...);
+    }
+
+    template<typename F, typename... Ps>
+    static void runArrays(uint32_t count, F &function, Ps *... arrays) {
+        for (uint32_t i = 0; i < count; i++) {
+            function(arrays[i]...);
+        }
+    }
+
+    std::vector<Archetype *> matches;
+    uint32_t cachedVersion = UINT32_MAX;
+    const World *cachedWorld = nullptr;
+};
+
+// Cambios estructurales diferidos: se graban durante la iteracion (uno por hilo) y se
+// aplican despues con apply(), cuando ningun sistema esta recorriendo el mundo. Cada comando
+// es una cabecera POD seguida de sus componentes (id y bytes) en un buffer lineal que
+// conserva la memoria, como RenderCommandList: grabar no reserva nada tras los primeros frames.
+class CommandBuffer {
+public:
+    template<typename... Ts>
+    void create(const Ts &... components) {
+        begin(ECS_COMMAND_CREATE, NULL_ENTITY, componentMask<Ts...>(), sizeof...(Ts));
+        (write(ComponentRegistry::id<Ts>(), &components, sizeof(Ts)), ...);
+    }
+
+    void destroy(Entity entity);
+
+    template<typename T>
+    void add(Entity entity, const T &value) {
+        begin(ECS_COMMAND_ADD, entity, componentMask<T>(), 1);
+        write(ComponentRegistry::id<T>(), &value, sizeof(T));
+    }
+
+    template<typename T>
+    void remove(Entity entity) {
+        begin(ECS_COMMAND_REMOVE, entity, componentMask<T>(), 0);
+    }
+
+    void apply(World &world);
+
+    size_t size() const;
+
+private:
+    enum CommandType : uint32_t {
+        ECS_COMMAND_CREATE,
+        ECS_COMMAND_DESTROY,
+        ECS_COMMAND_ADD,
+        ECS_COMMAND_REMOVE
+    };
+
+    // Detras van componentCount componentes, cada uno como ComponentId + bytes
+    struct CommandHeader {
+        CommandType type;
+        uint32_t componentCount;
+        Entity entity;
+        ComponentMask mask;
+    };
+
+    void begin(CommandType type, Entity entity, ComponentMask mask, uint32_t componentCount);
+
+    void write(ComponentId id, const void *data, size_t size);
+
+    // Se copia con memcpy: el buffer no respeta la alineacion de los componentes
+    std::vector<uint8_t> bytes;
+    size_t commandCount = 0;
+};
+
+
+#endif //SDL_OGL_ECS_H
@@ -0,0 +1,41 @@
+#ifndef SDL_OGL_FIXEDTIMESTEP_H
+#define SDL_OGL_FIXEDTIMESTEP_H
+
+#include <cstdint>
+
+// Acumulador de paso fijo: la simulacion avanza en ticks de 1/tickRate segundos
+// independientemente del framerate, y el render interpola con getAlpha().
+class FixedTimestep {
+public:
+    FixedTimestep(float tickRate = 60.0f, int maxTicksPerFrame = 8);
+
+    // Acumula frameDelta y devuelve cuantos ticks hay que simular este frame.
+    // Si se supera maxTicksPerFrame el tiempo sobrante se descarta (evita la espiral de la muerte).
+    int advance(float frameDelta);
+
+    float getStep() const;
+
+    // Fraccion del siguiente tick ya transcurrida, para interpolar entre el estado previo y el actual
+    float getAlpha() const;
+
+    void setTickRate(float tickRate);
+
+    float getAverageTicksPerFrame() const;
+
+    int getPeakTicksPerFrame() const;
+
+    uint64_t getDroppedTicks() const;
+
+private:
+    float step;
+    float accumulator;
+    int maxTicksPerFrame;
+
+    uint64_t frames;
+    uint64_t totalTicks;
+    uint64_t droppedTicks;
+    int peakTicks;
+};
+
+
+#endif //SDL_OGL_FIXEDTIMESTEP_H
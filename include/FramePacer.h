@@ -0,0 +1,61 @@
+#ifndef SDL_OGL_FRAMEPACER_H
+#define SDL_OGL_FRAMEPACER_H
+
+#include <cstdint>
+#include <deque>
+#include <glad/glad.h>
+
+enum PacingMode {
+    PACING_VSYNC,
+    PACING_ADAPTIVE_VSYNC, // swap interval -1: vsync salvo cuando el frame llega tarde
+    PACING_UNCAPPED,
+    PACING_LIMITED // limitador sleep+spin a targetFps, sin vsync
+};
+
+// Controla el ritmo de presentacion y cuantos frames puede adelantarse la CPU a la GPU.
+class FramePacer {
+public:
+    FramePacer();
+
+    ~FramePacer();
+
+    // hasSwapChain = false en headless: no hay swap interval que configurar
+    void begin(PacingMode mode, int targetFps, int maxFramesInFlight, int smoothingFrames, bool hasSwapChain);
+
+    // Bloquea mientras haya maxFramesInFlight frames sin terminar en la GPU. Llamar antes de emitir comandos GL
+    void waitForFrameSlot();
+
+    // Llamar justo despues del swap: registra la fence del frame y aplica el limitador
+    void endFrame();
+
+    // Media movil de los ultimos smoothingFrames deltas, recortando picos (p.ej. breakpoints, arrastre de ventana)
+    float smoothDelta(float rawDelta);
+
+    // Tiempo total bloqueado en fences y en el limitador, en ms
+    double getFenceWaitMs() const;
+
+    double getLimiterWaitMs() const;
+
+    static const char *modeName(PacingMode mode);
+
+private:
+    static constexpr int MAX_SMOOTHING_FRAMES = 16;
+    static constexpr float MAX_DELTA = 0.25f;
+
+    PacingMode mode;
+    uint64_t targetFrameNS;
+    int maxFramesInFlight;
+    std::deque<GLsync> fences;
+    uint64_t nextFrameNS;
+
+    float deltas[MAX_SMOOTHING_FRAMES];
+    int smoothingFrames;
+    int deltaCount;
+    int deltaIndex;
+
+    uint64_t fenceWaitNS;
+    uint64_t limiterWaitNS;
+};
+
+
+#endif //SDL_OGL_FRAMEPACER_H
@@ -0,0 +1,45 @@
+#ifndef SDL_OGL_FRAMEPACKET_H
+#define SDL_OGL_FRAMEPACKET_H
+
+#include <cstdint>
+#include <vector>
+#include <glm.hpp>
+
+#include "RenderCommands.h"
+#include "TextureCache.h"
+
+// Mismo layout std140 que CameraBlock en los shaders
+struct CameraUniforms {
+    glm::mat4 projection;
+    glm::mat4 view;
+    glm::vec4 viewPos;
+};
+
+static constexpr int FRAME_TEXTURE_UNITS = 4;
+
+// Todo lo que el hilo de render necesita para un frame. El hilo principal lo rellena y,
+// una vez enviado, no lo vuelve a tocar hasta que el render lo devuelve.
+struct FramePacket {
+    CameraUniforms camera;
+    // Version de la camara + ojo interpolado, para no resubir el UBO si no cambiaron
+    uint32_t cameraVersion;
+    glm::vec3 eyePosition;
+
+    glm::vec4 clearColor;
+    // Grabadas en paralelo, una por worker; se reproducen en orden
+    std::vector<RenderCommandList> commandLists;
+    // Textura de cada unidad; el render usa el placeholder mientras no este subida
+    TextureHandle textures[FRAME_TEXTURE_UNITS];
+    // Diametro en pixeles con el que se ve cada una (0 = no visible); decide sus mips (ver TextureStreamer)
+    float textureDemand[FRAME_TEXTURE_UNITS];
+    int textureCount;
+
+    int simTicks;
+    // Input aplicado en este frame, para medir latencia hasta el swap (0 = sin eventos)
+    uint64_t oldestEventNS;
+    uint64_t newestEventNS;
+    size_t eventCount;
+};
+
+
+#endif //SDL_OGL_FRAMEPACKET_H
@@ -0,0 +1,103 @@
+#ifndef SDL_OGL_GPULOADER_H
+#define SDL_OGL_GPULOADER_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glad/glad.h>
+#include <SDL3/SDL.h>
+
+#include "RenderTarget.h"
+
+typedef uint32_t GpuResourceId;
+
+enum GpuResourceType {
+    GPU_RESOURCE_TEXTURE,
+    GPU_RESOURCE_BUFFER,
+    GPU_RESOURCE_PROGRAM
+};
+
+// Hilo con un contexto GL compartido que crea texturas, buffers y programas fuera del hilo
+// de render. Tras crear cada recurso emite una fence; el hilo de render solo lo ve (get() != 0)
+// cuando publish() encuentra esa fence señalada.
+class GpuLoader {
+public:
+    // Hilo de carga: crea el objeto GL y devuelve su nombre
+    typedef std::function<unsigned int()> CreateFunction;
+
+    GpuLoader();
+
+    ~GpuLoader();
+
+    // shared.context (o shared.headless) debe compartir objetos con el contexto de render
+    void start(const RenderTarget &shared);
+
+    GpuResourceId load(GpuResourceType type, CreateFunction create);
+
+    // Toma posesion de una superficie que acepte uploadSurface (ver SurfaceUpload.h)
+    GpuResourceId loadTexture(SDL_Surface *surface);
+
+    GpuResourceId loadBuffer(unsigned int target, std::vector<uint8_t> data);
+
+    GpuResourceId loadProgram(const std::string &vertexPath, const std::string &fragmentPath);
+
+    // Hilo de render: publica los recursos cuya fence ya se señalo. Devuelve cuantos
+    size_t publish();
+
+    // Hilo de render: 0 mientras el recurso no este publicado
+    unsigned int get(GpuResourceId id) const;
+
+    bool isReady(GpuResourceId id) const;
+
+    bool isRunning() const;
+
+    size_t getPendingCount() const;
+
+    // Ejecuta lo que quede en cola, termina el hilo y suelta el contexto compartido
+    void stop();
+
+    // Hilo de render: borra un recurso ya publicado (p.ej. una textura expulsada de la cache)
+    void release(GpuResourceId id);
+
+    // Hilo de render: borra los recursos y las fences pendientes
+    void destroy();
+
+private:
+    struct Resource {
+        GpuResourceType type;
+        unsigned int name = 0;
+        GLsync fence = nullptr;
+        std::atomic<bool> ready{false};
+    };
+
+    struct Task {
+        GpuResourceId id;
+        CreateFunction create;
+    };
+
+    void threadLoop();
+
+    Resource &resource(GpuResourceId id) const;
+
+    RenderTarget shared;
+    std::jthread thread;
+    bool running;
+
+    mutable std::mutex mutex;
+    // Solo crece: las referencias a Resource no se invalidan
+    std::deque<Resource> resources;
+    std::deque<Task> tasks;
+    // Creados y con fence emitida, pendientes de publicar
+    std::vector<GpuResourceId> fenced;
+    bool stopping;
+    std::atomic<uint32_t> signal;
+    std::atomic<size_t> pendingCount;
+};
+
+
+#endif //SDL_OGL_GPULOADER_H
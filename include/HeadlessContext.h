@@ -0,0 +1,53 @@
+#ifndef SDL_OGL_HEADLESSCONTEXT_H
+#define SDL_OGL_HEADLESSCONTEXT_H
+
+// Contexto OpenGL sin ventana (EGL surfaceless, p.ej. Mesa llvmpipe) que renderiza
+// sobre un FBO propio. Pensado para CI/render farm sin GPU ni servidor grafico.
+class HeadlessContext {
+public:
+    HeadlessContext();
+
+    ~HeadlessContext();
+
+    bool create(int width, int height);
+
+    // Contexto que comparte objetos con share (mismo display, sin FBO propio) para un hilo de carga.
+    // No queda activo en ningun hilo; se destruye antes que share
+    bool createShared(const HeadlessContext &share);
+
+    void destroy();
+
+    bool makeCurrent() const;
+
+    // Suelta el contexto del hilo actual para que otro hilo pueda hacer makeCurrent
+    void releaseCurrent() const;
+
+    void bindFramebuffer() const;
+
+    unsigned int getFramebuffer() const;
+
+    int getWidth() const;
+
+    int getHeight() const;
+
+private:
+    bool createFramebuffer();
+
+    void *display;
+    void *config;
+    void *context;
+    void *surface;
+    // Los contextos compartidos usan el display de otro y no lo terminan
+    bool ownsDisplay;
+    // Version 4.x del contexto: 4.6 si el driver la da (SPIR-V), si no 4.1
+    int minorVersion;
+
+    int width;
+    int height;
+    unsigned int fbo;
+    unsigned int colorRbo;
+    unsigned int depthRbo;
+};
+
+
+#endif //SDL_OGL_HEADLESSCONTEXT_H
@@ -0,0 +1,48 @@
+#ifndef SDL_OGL_INPUTLATCH_H
+#define SDL_OGL_INPUTLATCH_H
+
+#include <cstdint>
+#include <vector>
+#include <SDL3/SDL.h>
+
+#include "InputRecording.h"
+
+// Agrupa el input de un frame. El raton se acumula y se aplica una sola vez, lo mas
+// tarde posible (justo antes de subir la camara); el teclado se integra con los
+// timestamps de los eventos en lugar de muestrearse una vez por frame.
+class InputLatch {
+public:
+    void addEvent(const InputEvent &event);
+
+    void addMouseMotion(const SDL_MouseMotionEvent &motion);
+
+    void addKey(const SDL_KeyboardEvent &key);
+
+    // Fraccion de [beginNS, endNS] durante la que la tecla estuvo pulsada
+    float heldFraction(SDL_Scancode scancode, uint64_t beginNS, uint64_t endNS) const;
+
+    // Movimiento de raton acumulado desde la ultima llamada; false si no hay
+    bool takeMouseDelta(float &xOffset, float &yOffset);
+
+    // Eventos del frame en orden de llegada (para grabarlos)
+    const std::vector<InputEvent> &getFrameEvents() const;
+
+    // Timestamp del evento mas antiguo del frame, 0 si no hubo input
+    uint64_t getOldestEventNS() const;
+
+    uint64_t getNewestEventNS() const;
+
+    // Consolida el estado de las teclas y empieza un frame nuevo
+    void endFrame();
+
+private:
+    bool keys[SDL_SCANCODE_COUNT] = {};
+    std::vector<InputEvent> frameEvents;
+
+    float mouseX = 0.0f;
+    float mouseY = 0.0f;
+    bool mousePending = false;
+};
+
+
+#endif //SDL_OGL_INPUTLATCH_H
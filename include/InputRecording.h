@@ -0,0 +1,69 @@
+#ifndef SDL_OGL_INPUTRECORDING_H
+#define SDL_OGL_INPUTRECORDING_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Formato binario (little-endian):
+//   cabecera: "SOIR" + uint32 version
+//   registros: uint8 tipo + payload
+//     MOUSE_MOTION: uint64 timestamp, float xrel, float yrel
+//     KEY:          uint64 timestamp, uint16 scancode, uint8 down
+//     FRAME:        float deltaTime, uint64 frameStart, uint64 frameEnd
+//                   (cierra el frame: los eventos anteriores le pertenecen)
+enum InputRecordType : uint8_t {
+    INPUT_RECORD_MOUSE_MOTION = 1,
+    INPUT_RECORD_KEY = 2,
+    INPUT_RECORD_FRAME = 3
+};
+
+struct InputEvent {
+    InputRecordType type;
+    uint64_t timestamp;
+    float xrel;
+    float yrel;
+    uint16_t scancode;
+    bool down;
+};
+
+class InputRecorder {
+public:
+    bool open(const std::string &path);
+
+    void close();
+
+    void recordEvent(const InputEvent &event);
+
+    // frameStartNS/frameEndNS: intervalo de tiempo real que integra la simulacion del frame
+    void recordFrame(float deltaTime, uint64_t frameStartNS, uint64_t frameEndNS);
+
+    uint32_t getFrameCount() const;
+
+private:
+    std::ofstream file;
+    uint32_t frameCount = 0;
+};
+
+// Reproduce una grabacion frame a frame con los deltaTime grabados, de modo que
+// Camera::processMouse/processKeyboard reciben exactamente los mismos valores.
+class InputReplay {
+public:
+    bool open(const std::string &path);
+
+    // Avanza un frame: carga sus eventos, su deltaTime y sus timestamps. false al llegar al final
+    bool nextFrame(float &deltaTime, uint64_t &frameStartNS, uint64_t &frameEndNS);
+
+    const std::vector<InputEvent> &getEvents() const;
+
+    uint32_t getFrameCount() const;
+
+private:
+    std::ifstream file;
+    std::vector<InputEvent> events;
+    uint32_t frameCount = 0;
+};
+
+
+#endif //SDL_OGL_INPUTRECORDING_H
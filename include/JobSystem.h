@@ -0,0 +1,160 @@
+#ifndef SDL_OGL_JOBSYSTEM_H
+#define SDL_OGL_JOBSYSTEM_H
+
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+class JobCounter;
+
+typedef void (*JobFunction)(void *data, uint32_t begin, uint32_t end);
+
+// Tarea POD: se copia por valor en los deques, sin reservas de memoria por tarea.
+// Si grain > 0 el rango [begin, end) se parte por la mitad hasta que no supere grain.
+struct Job {
+    JobFunction function;
+    void *data;
+    uint32_t begin;
+    uint32_t end;
+    uint32_t grain;
+    JobCounter *counter;
+};
+
+// Contador de dependencias: cuenta las tareas pendientes asociadas. Las tareas que
+// dependen de el se encolan cuando llega a cero (-1 mientras se estan encolando).
+class JobCounter {
+public:
+    int get() const {
+        return value.load(std::memory_order_acquire);
+    }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<int> value{0};
+    std::mutex mutex;
+    std::vector<Job> waiting;
+};
+
+// Deque de Chase-Lev de capacidad fija: el dueño hace push/pop por abajo, el resto roba por arriba
+class JobDeque {
+public:
+    static constexpr int64_t CAPACITY = 4096;
+
+    bool push(const Job &job);
+
+    bool pop(Job &job);
+
+    bool steal(Job &job);
+
+    int64_t size() const;
+
+private:
+    // Un ladron puede leer un slot que el dueño esta reescribiendo; en ese caso su CAS sobre top falla y
+    // el valor leido se descarta. Cada campo es atomico (relaxed, sin coste en x86) para que esa lectura
+    // concurrente no sea una carrera de datos, como los elementos atomicos de Le et al. (2013)
+    struct Slot {
+        std::atomic<JobFunction> function;
+        std::atomic<void *> data;
+        std::atomic<uint32_t> begin;
+        std::atomic<uint32_t> end;
+        std::atomic<uint32_t> grain;
+        std::atomic<JobCounter *> counter;
+
+        void store(const Job &job);
+
+        Job load() const;
+    };
+
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+    Slot slots[CAPACITY];
+};
+
+// Planificador work-stealing. El hilo que lo crea es el worker 0 y participa en las
+// esperas; los demas hilos solo ejecutan tareas. Solo los workers pueden encolar.
+// Un hilo puede ser el worker 0 de varios JobSystem a la vez; sus otros workers son exclusivos.
+class JobSystem {
+public:
+    // threadCount incluye el hilo actual. pinThreads fija cada worker a un core (solo Linux)
+    explicit JobSystem(int threadCount, bool pinThreads = false,
+                       SDL_ThreadPriority priority = SDL_THREAD_PRIORITY_NORMAL);
+
+    ~JobSystem();
+
+    JobSystem(const JobSystem &) = delete;
+
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    // Encola job. signal (opcional) se incrementa ahora y se decrementa al terminar.
+    // Si dependency no es nulo, job no se ejecuta hasta que dependency llegue a cero.
+    void schedule(const Job &job, JobCounter *signal = nullptr, JobCounter *dependency = nullptr);
+
+    // Ejecuta tareas pendientes hasta que counter llegue a cero
+    void wait(JobCounter &counter);
+
+    // Fork/join: llama function(begin, end) sobre subrangos de como mucho grain elementos
+    template<typename F>
+    void parallelFor(uint32_t begin, uint32_t end, uint32_t grain, F &&function) {
+        if (end <= begin) {
+            return;
+        }
+        if (workers.size() == 1 || end - begin <= grain) {
+            function(begin, end);
+            return;
+        }
+        using Function = std::remove_reference_t<F>;
+        JobCounter counter;
+        schedule({
+                     [](void *data, uint32_t b, uint32_t e) { (*static_cast<Function *>(data))(b, e); },
+                     const_cast<void *>(static_cast<const void *>(&function)), begin, end, std::max(grain, 1u),
+                     nullptr
+                 }, &counter);
+        wait(counter);
+    }
+
+    int getThreadCount() const;
+
+    uint64_t getExecutedCount() const;
+
+    uint64_t getStealCount() const;
+
+private:
+    struct alignas(64) Worker {
+        JobDeque deque;
+        std::atomic<uint64_t> executed{0};
+        std::atomic<uint64_t> steals{0};
+        uint32_t random = 0;
+    };
+
+    void workerLoop(int index, bool pin, SDL_ThreadPriority priority);
+
+    // Saca una tarea del deque propio o la roba de otro worker; false si no habia ninguna
+    bool findJob(int index, Job &job);
+
+    void execute(int index, Job job);
+
+    void finish(JobCounter *counter);
+
+    void push(const Job &job);
+
+    int currentWorker() const;
+
+    std::vector<std::unique_ptr<Worker> > workers;
+    std::vector<std::jthread> threads;
+    std::atomic<bool> running{true};
+    std::atomic<int> sleeping{0};
+    std::atomic<int> searching{0};
+    std::atomic<uint32_t> wakeEpoch{0};
+    // Worker 0
+    std::thread::id owner;
+};
+
+
+#endif //SDL_OGL_JOBSYSTEM_H
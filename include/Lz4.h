@@ -0,0 +1,20 @@
+#ifndef SDL_OGL_LZ4_H
+#define SDL_OGL_LZ4_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Formato de bloque LZ4 (sin la cabecera de frame): secuencias de literales + copia (offset <= 64KB).
+// Compresor voraz con tabla hash de 4 bytes; el descompresor valida todos los limites
+
+// Peor caso de la salida comprimida
+size_t lz4CompressBound(size_t size);
+
+// Bytes escritos en dst; 0 si no cabe en capacity
+size_t lz4Compress(const uint8_t *src, size_t size, uint8_t *dst, size_t capacity);
+
+// false si src no es un bloque valido que descomprima exactamente a originalSize bytes
+bool lz4Decompress(const uint8_t *src, size_t size, uint8_t *dst, size_t originalSize);
+
+
+#endif //SDL_OGL_LZ4_H
@@ -0,0 +1,40 @@
+#ifndef SDL_OGL_MIPGENERATOR_H
+#define SDL_OGL_MIPGENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "JobSystem.h"
+
+// Filtros de reduccion para la cadena de mips (separables, en unidades del nivel destino)
+enum MipFilter {
+    MIP_FILTER_BOX, // 2x2, lo mismo que suele hacer glGenerateMipmap
+    MIP_FILTER_KAISER, // sinc con ventana de Kaiser, radio 3
+    MIP_FILTER_LANCZOS, // Lanczos3
+    MIP_FILTER_COUNT
+};
+
+const char *mipFilterName(MipFilter filter);
+
+bool parseMipFilter(const std::string &name, MipFilter &filter);
+
+struct MipOptions {
+    MipFilter filter = MIP_FILTER_BOX;
+    // RGB en sRGB: se filtra en espacio lineal. Desactivar para normales y datos (BC4/BC5)
+    bool srgb = true;
+    // > 0: cada nivel conserva la fraccion de pixeles con alfa >= alphaCutoff del nivel 0 (recortes)
+    float alphaCutoff = 0.0f;
+};
+
+// Cadena de mips RGBA8 hasta 1x1 (levels[0] = rgba). Con box cada nivel se reduce del anterior; con Kaiser y
+// Lanczos, del nivel 0, para que sus lobulos no se acumulen. Con jobs reparte las filas de cada nivel
+void generateMips(const uint8_t *rgba, int width, int height, const MipOptions &options,
+                  std::vector<std::vector<uint8_t> > &levels, JobSystem *jobs = nullptr);
+
+// Fraccion de pixeles con alfa >= cutoff (0-1)
+float computeAlphaCoverage(const uint8_t *rgba, size_t pixels, float cutoff);
+
+
+#endif //SDL_OGL_MIPGENERATOR_H
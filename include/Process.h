@@ -0,0 +1,13 @@
+#ifndef SDL_OGL_PROCESS_H
+#define SDL_OGL_PROCESS_H
+
+#include <string>
+#include <vector>
+
+// Ejecuta arguments[0] (buscado en el PATH si no lleva directorio) con el resto como argumentos, sin pasar
+// por una shell: las rutas van tal cual, con espacios o comillas. stdout y stderr quedan en output.
+// true si el proceso termina con codigo 0
+bool runProcess(const std::vector<std::string> &arguments, std::string &output);
+
+
+#endif //SDL_OGL_PROCESS_H
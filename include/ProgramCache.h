@@ -0,0 +1,61 @@
+#ifndef SDL_OGL_PROGRAMCACHE_H
+#define SDL_OGL_PROGRAMCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// Cache en disco de programas enlazados (glGetProgramBinary / glProgramBinary). La clave es un hash de
+// las fuentes y del vendor, renderer y version del driver: un driver nuevo o un shader editado no
+// encuentran su binario y se compilan de nuevo. Un binario que el driver rechaza se borra.
+// Guarda tambien lo que costo compilar y enlazar cada programa, para saber el tiempo ahorrado.
+class ProgramCache {
+public:
+    ProgramCache();
+
+    // Hilo GL. Sin formatos binarios en el driver la cache queda desactivada (load/store no hacen nada)
+    bool begin(const std::string &directory);
+
+    bool isEnabled() const;
+
+    uint64_t makeKey(const std::string &vertexSource, const std::string &fragmentSource) const;
+
+    // Hilo GL: el programa ya enlazado desde su binario; 0 si no esta o el driver lo rechaza
+    unsigned int load(uint64_t key);
+
+    // Hilo GL: guarda el binario de un programa enlazado con GL_PROGRAM_BINARY_RETRIEVABLE_HINT.
+    // compileNS: lo que tardaron compilacion y enlace
+    void store(uint64_t key, unsigned int program, uint64_t compileNS);
+
+    size_t getHits() const;
+
+    size_t getMisses() const;
+
+    // Binarios que el driver no acepto (se compilaron de nuevo)
+    size_t getRejected() const;
+
+    // Compilacion evitada menos lo que costo cargar los binarios
+    double getSavedMs() const;
+
+    // Compilacion y enlace de los programas que no estaban
+    double getCompileMs() const;
+
+private:
+    std::string pathFor(uint64_t key) const;
+
+    bool enabled;
+    std::string directory;
+    // Hash de vendor, renderer y version
+    uint64_t driverHash;
+
+    mutable std::mutex mutex;
+    size_t hits;
+    size_t misses;
+    size_t rejected;
+    uint64_t savedNS;
+    uint64_t compileNS;
+};
+
+
+#endif //SDL_OGL_PROGRAMCACHE_H
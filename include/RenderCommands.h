@@ -0,0 +1,149 @@
+#ifndef SDL_OGL_RENDERCOMMANDS_H
+#define SDL_OGL_RENDERCOMMANDS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <glm.hpp>
+
+#include "Shader.h"
+
+// Comandos de render independientes del backend: structs POD con cabecera comun que se
+// graban seguidos en un arena lineal. Los handles (programa, VAO) y las locations de
+// uniforms son enteros opacos resueltos de antemano, asi que cualquier hilo puede grabar
+// sin tocar el contexto; solo la reproduccion (replayRenderCommands) llama a GL.
+
+enum RenderCommandType : uint16_t {
+    RENDER_COMMAND_SET_PROGRAM,
+    RENDER_COMMAND_SET_VERTEX_ARRAY,
+    RENDER_COMMAND_SET_UNIFORM_VEC3,
+    RENDER_COMMAND_SET_UNIFORM_MAT4,
+    RENDER_COMMAND_DRAW
+};
+
+struct RenderCommand {
+    uint16_t type;
+    uint16_t size;
+};
+
+struct SetProgramCommand {
+    static constexpr RenderCommandType TYPE = RENDER_COMMAND_SET_PROGRAM;
+    RenderCommand header;
+    uint32_t program;
+};
+
+struct SetVertexArrayCommand {
+    static constexpr RenderCommandType TYPE = RENDER_COMMAND_SET_VERTEX_ARRAY;
+    RenderCommand header;
+    uint32_t vertexArray;
+};
+
+struct SetUniformVec3Command {
+    static constexpr RenderCommandType TYPE = RENDER_COMMAND_SET_UNIFORM_VEC3;
+    RenderCommand header;
+    int32_t location;
+    float value[3];
+};
+
+struct SetUniformMat4Command {
+    static constexpr RenderCommandType TYPE = RENDER_COMMAND_SET_UNIFORM_MAT4;
+    RenderCommand header;
+    int32_t location;
+    float value[16];
+};
+
+struct DrawCommand {
+    static constexpr RenderCommandType TYPE = RENDER_COMMAND_DRAW;
+    RenderCommand header;
+    int32_t first;
+    int32_t count;
+};
+
+// Programa + locations de sus uniforms, resueltos una vez en el hilo GL (-1 = no lo usa)
+struct Material {
+    uint32_t program;
+    int32_t model;
+    int32_t objectColor;
+    int32_t lightPos;
+    int32_t lightColor;
+    int32_t lightSpace;
+};
+
+Material createMaterial(const Shader &shader);
+
+Material createMaterial(unsigned int program);
+
+// Locations fijas de los uniforms (LOCATION(n) en shaders/common.glsl). Los arrays de luces ocupan una
+// location por elemento: lightPos 4-11 y lightColor 12-19 con el maximo de 8 luces; lightSpace va detras
+enum UniformLocation : int32_t {
+    UNIFORM_MODEL = 0,
+    UNIFORM_OBJECT_COLOR = 1,
+    UNIFORM_LIGHT_POS = 4,
+    UNIFORM_LIGHT_COLOR = 12,
+    UNIFORM_LIGHT_SPACE = 20
+};
+
+// Programas cargados desde SPIR-V, que no conservan los nombres: cada location fija que el programa
+// tenga activa, -1 el resto
+Material createMaterialFromLocations(unsigned int program);
+
+struct SceneLight {
+    glm::vec3 position;
+    glm::vec3 color;
+};
+
+// Datos por instancia de un draw call
+struct DrawItem {
+    unsigned int vao;
+    int vertexCount;
+    const Material *material;
+    glm::mat4 model;
+    glm::vec3 color;
+};
+
+// Arena lineal de comandos. reset() conserva la memoria, asi que tras los primeros
+// frames grabar no reserva nada. Un hilo por lista.
+class RenderCommandList {
+public:
+    RenderCommandList();
+
+    RenderCommandList(RenderCommandList &&other) noexcept;
+
+    RenderCommandList &operator=(RenderCommandList &&other) noexcept;
+
+    void reset();
+
+    template<typename T>
+    T &add() {
+        static_assert(std::is_trivially_copyable_v<T> && sizeof(T) % 4 == 0, "Render commands must be POD");
+        auto *command = new(allocate(sizeof(T))) T;
+        command->header = {T::TYPE, static_cast<uint16_t>(sizeof(T))};
+        commandCount++;
+        return *command;
+    }
+
+    const uint8_t *data() const;
+
+    size_t size() const;
+
+    size_t getCommandCount() const;
+
+private:
+    void *allocate(size_t bytes);
+
+    std::unique_ptr<uint8_t[]> buffer;
+    size_t capacity;
+    size_t used;
+    size_t commandCount;
+};
+
+// Graba draws (ordenados por material y VAO) sin comandos de estado redundantes
+void recordDraws(const DrawItem *begin, const DrawItem *end, const SceneLight &light, RenderCommandList &list);
+
+// Reproduce la lista sobre el contexto GL actual
+void replayRenderCommands(const RenderCommandList &list);
+
+
+#endif //SDL_OGL_RENDERCOMMANDS_H
@@ -0,0 +1,16 @@
+#ifndef SDL_OGL_RENDERTARGET_H
+#define SDL_OGL_RENDERTARGET_H
+
+#include <SDL3/SDL.h>
+
+#include "HeadlessContext.h"
+
+// Contexto GL que usa un hilo: ventana SDL o contexto headless
+struct RenderTarget {
+    SDL_Window *window;
+    SDL_GLContext context;
+    HeadlessContext *headless;
+};
+
+
+#endif //SDL_OGL_RENDERTARGET_H
@@ -0,0 +1,83 @@
+#ifndef SDL_OGL_RENDERTHREAD_H
+#define SDL_OGL_RENDERTHREAD_H
+
+#include <SDL3/SDL.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "BenchmarkReport.h"
+#include "FramePacer.h"
+#include "FramePacket.h"
+#include "HeadlessContext.h"
+#include "RenderTarget.h"
+#include "ShaderManager.h"
+#include "SpscQueue.h"
+#include "TextureCache.h"
+
+// Hilo que posee el contexto GL y ejecuta los FramePacket que produce el hilo principal.
+// Hay dos paquetes: mientras el render envia el frame N, el hilo principal simula y
+// rellena el N+1. Sin hilo (threaded = false) cada paquete se renderiza al enviarlo.
+class RenderThread {
+public:
+    static constexpr int PACKET_COUNT = 2;
+
+    RenderThread();
+
+    ~RenderThread();
+
+    // El contexto debe estar activo en el hilo llamador; pasa a ser del hilo de render
+    // textures y shaders (opcionales) se actualizan en cada frame desde el hilo de render
+    void start(const RenderTarget &target, FramePacer *pacer, BenchmarkReport *report, unsigned int cameraUBO,
+               TextureCache *textures, ShaderManager *shaders, bool threaded, bool latencyLog);
+
+    // Paquete libre para el siguiente frame; bloquea si el render lleva dos frames de retraso
+    FramePacket *acquirePacket();
+
+    void submit(FramePacket *packet);
+
+    // Espera a que se rendericen los paquetes enviados y devuelve el contexto al hilo llamador
+    void stop();
+
+    bool isRunning() const;
+
+    // Tiempo total que cada lado ha esperado al otro, en ms
+    double getMainWaitMs() const;
+
+    double getRenderWaitMs() const;
+
+private:
+    void threadLoop();
+
+    void render(FramePacket &packet);
+
+    void makeCurrent() const;
+
+    void releaseCurrent() const;
+
+    RenderTarget target;
+    FramePacer *pacer;
+    BenchmarkReport *report;
+    unsigned int cameraUBO;
+    TextureCache *textures;
+    ShaderManager *shaders;
+    bool threaded;
+    bool latencyLog;
+    bool running;
+
+    // Lo ultimo que se subio al UBO, para no repetir la subida si la camara no cambio
+    uint32_t uploadedCameraVersion;
+    glm::vec3 uploadedEyePosition;
+
+    FramePacket packets[PACKET_COUNT];
+    // nullptr en submitted indica al hilo que termine
+    SpscQueue<FramePacket *, PACKET_COUNT * 2> submitted;
+    SpscQueue<FramePacket *, PACKET_COUNT * 2> freePackets;
+    std::jthread thread;
+
+    uint64_t mainWaitNS;
+    std::atomic<uint64_t> renderWaitNS;
+};
+
+
+#endif //SDL_OGL_RENDERTHREAD_H
@@ -0,0 +1,106 @@
+#ifndef SDL_OGL_SCENESYSTEMS_H
+#define SDL_OGL_SCENESYSTEMS_H
+
+#include <glm.hpp>
+
+#include "ECS.h"
+#include "JobSystem.h"
+#include "RenderCommands.h"
+#include "TransformSystem.h"
+
+// Componentes de la escena. Las matrices viven en TransformSystem; la entidad solo guarda el id.
+struct TransformComponent {
+    TransformId id;
+};
+
+struct MeshRenderer {
+    unsigned int vao;
+    int vertexCount;
+    const Material *material;
+    glm::vec3 color;
+};
+
+// Radio en espacio local, se escala con la matriz de mundo
+struct BoundingSphere {
+    float radius;
+};
+
+struct Visible {
+    bool value;
+};
+
+struct LightSource {
+    glm::vec3 color;
+};
+
+// Giro continuo alrededor de axis, en grados por grado de rotacion de la simulacion
+struct Spin {
+    glm::vec3 axis;
+    float speed;
+};
+
+// Cada sistema guarda sus queries: los arquetipos que encajan se recalculan cuando cambia el World o sus
+// arquetipos, y viven lo mismo que el sistema (no hay cache global que sobreviva a un World destruido)
+
+// Aplica la rotacion interpolada de la simulacion a las entidades con Spin
+class AnimationSystem {
+public:
+    void run(World &world, TransformSystem &transforms, float rotation);
+
+private:
+    Query<const TransformComponent, const Spin> query;
+};
+
+// Primera luz de la escena (blanca en el origen si no hay ninguna)
+class LightSystem {
+public:
+    SceneLight run(World &world, const TransformSystem &transforms);
+
+private:
+    Query<const TransformComponent, const LightSource> query;
+};
+
+// Mayor diametro proyectado, en pixeles, de las entidades visibles que usan material (0 si no se ve ninguna).
+// Es la resolucion que necesitan sus texturas (ver TextureStreamer::requestResolution)
+class TextureDemandSystem {
+public:
+    float run(World &world, const TransformSystem &transforms, const Material *material, const glm::mat4 &projection,
+              const glm::vec3 &eye, int viewportHeight);
+
+private:
+    Query<const TransformComponent, const BoundingSphere, const MeshRenderer, const Visible> query;
+};
+
+// Marca Visible segun el frustum de viewProjection. Si ni la camara, ni las transformaciones, ni las
+// entidades (creadas, destruidas o con otros componentes) cambiaron desde la ultima llamada no recorre
+// nada. Con jobs reparte los chunks entre hilos.
+class CullingSystem {
+public:
+    void run(World &world, const TransformSystem &transforms, const glm::mat4 &viewProjection,
+             JobSystem *jobs = nullptr);
+
+    size_t getVisibleCount() const;
+
+private:
+    Query<const TransformComponent, const BoundingSphere, Visible> query;
+    glm::mat4 lastViewProjection = glm::mat4(0.0f);
+    uint32_t lastStructureVersion = UINT32_MAX;
+    size_t visibleCount = 0;
+};
+
+// Recoge los draws visibles, los agrupa por material y VAO y los graba en commandLists,
+// repartidos en tramos contiguos entre los workers de jobs (una lista por tramo)
+class RenderSystem {
+public:
+    void run(World &world, const TransformSystem &transforms, const SceneLight &light, JobSystem *jobs,
+             std::vector<RenderCommandList> &commandLists);
+
+    size_t getDrawCount() const;
+
+private:
+    Query<const TransformComponent, const MeshRenderer, const Visible> query;
+    std::vector<DrawItem> draws;
+};
+
+
+#endif //SDL_OGL_SCENESYSTEMS_H
@@ -9,69 +9,26 @@
 #ifndef SHADER_H
 #define SHADER_H
 
-// TODO separar en cpp/h y generar log and check errors
+#include "ProgramCache.h"
+#include "ShaderSource.h"
+
+// Los errores de compilacion y enlace se escriben en stdout con el log del driver; si el enlace falla,
+// id = 0 y no se guarda nada en la cache
 class Shader {
 public:
     unsigned int id;
     unsigned int vertex;
     unsigned int fragment;
 
-    Shader(const char *vertexPath, const char *fragmentPath) {
-        std::string vertexSource;
-        std::string fragmentSource;
-        std::ifstream vertexFile;
-        std::ifstream fragmentFile;
-
-        try {
-            vertexFile.open(vertexPath);
-            fragmentFile.open(fragmentPath);
-
-            std::stringstream vertexStream, fragmentStream;
-
-            vertexStream << vertexFile.rdbuf();
-            fragmentStream << fragmentFile.rdbuf();
-
-            vertexFile.close();
-            fragmentFile.close();
-
-            // por que usar str si luego se usara c_str?
-            vertexSource = vertexStream.str();
-            fragmentSource = fragmentStream.str();
-        } catch (std::ifstream::failure &e) {
-            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
-        }
-
-        // por que usar c_str?
-        const char *vertexCode = vertexSource.c_str();
-        const char *fragmentCode = fragmentSource.c_str();
-
-        compileVertexShader(vertexCode);
-        compileFragmentShader(fragmentCode);
-        createShaderProgram();
-    }
-
-    void compileVertexShader(const char *vertexCode) {
-        vertex = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vertex, 1, &vertexCode, nullptr);
-        glCompileShader(vertex);
-    }
+    // Con cache, el programa sale de su binario si ya se compilo antes con las mismas fuentes y driver
+    Shader(const char *vertexPath, const char *fragmentPath, ProgramCache *cache = nullptr);
 
-    void compileFragmentShader(const char *fragmentCode) {
-        fragment = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fragment, 1, &fragmentCode, nullptr);
-        glCompileShader(fragment);
-    }
+    void compileVertexShader(const char *vertexCode);
 
-    void createShaderProgram() {
-        id = glCreateProgram();
-        glAttachShader(id, vertex);
-        glAttachShader(id, fragment);
+    void compileFragmentShader(const char *fragmentCode);
 
-        glLinkProgram(id);
-
-        glDeleteShader(vertex);
-        glDeleteShader(fragment);
-    }
+    // retrievable: se pedira su binario con glGetProgramBinary
+    void createShaderProgram(bool retrievable = false);
 
     void use() const {
         glUseProgram(id);
@@ -89,6 +46,21 @@ public:
     void setInt(const std::string &name, int value) const {
         glUniform1i(glGetUniformLocation(id, name.c_str()), value);
     }
+
+    // #version 330 no permite layout(binding), se asigna desde aqui
+    void bindUniformBlock(const std::string &name, unsigned int binding) const {
+        const unsigned int index = glGetUniformBlockIndex(id, name.c_str());
+        if (index != GL_INVALID_INDEX) {
+            glUniformBlockBinding(id, index, binding);
+        }
+    }
+
+private:
+    // Log de un shader (shader = true) o de un programa
+    static std::string infoLog(unsigned int object, bool shader);
+
+    // Escribe el log si shader no compilo
+    static void checkCompile(unsigned int shader, const char *stage);
 };
 
 
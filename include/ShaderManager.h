@@ -0,0 +1,159 @@
+#ifndef SDL_OGL_SHADERMANAGER_H
+#define SDL_OGL_SHADERMANAGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ProgramCache.h"
+#include "RenderCommands.h"
+#include "ShaderSource.h"
+
+typedef uint32_t ProgramHandle;
+
+// Programas GL compilados sin bloquear: load() lanza compilacion y enlace y update() recoge los que han
+// terminado consultando GL_COMPLETION_STATUS_KHR (KHR/ARB_parallel_shader_compile) o, sin la extension,
+// dejando pasar unos frames antes de glGetProgramiv. Un programa nuevo solo sustituye al activo si enlaza;
+// los errores se loguean sobre los ficheros originales (ver ShaderSource).
+// Con watch(), los ficheros modificados del directorio (inotify) se recompilan de la misma forma.
+// Con useSpirv(), cada etapa con modulo SPIR-V precompilado (ver Spirv.h) se carga con glShaderBinary +
+// glSpecializeShader en lugar de compilar el GLSL; si falta o el driver lo rechaza se avisa y se vuelve al
+// GLSL.
+// Hilos: todo en el hilo GL salvo bindMaterial/applyUpdates, que van en el hilo que graba los comandos.
+class ShaderManager {
+public:
+    ShaderManager();
+
+    ~ShaderManager();
+
+    // Hilo GL, antes de load(). cache puede ser nullptr
+    void begin(ProgramCache *cache);
+
+    // Uniform blocks que se enlazan en cada programa nuevo (#version 330 no permite layout(binding))
+    void setUniformBlockBinding(const std::string &name, unsigned int binding);
+
+    // Unidad de textura de cada sampler en los programas GLSL (los modulos SPIR-V ya la llevan, BINDING())
+    void setSamplerBinding(const std::string &name, int unit);
+
+    // Hilo GL, antes de load(). Necesita GL 4.6 (GL_ARB_gl_spirv); false si no hay soporte
+    bool useSpirv(const std::string &directory);
+
+    // constant_id de los modulos SPIR-V (shaders/lighting.glsl: 0 ambient, 1 specular, 2 shininess).
+    // Las que un modulo no declara se ignoran
+    void setSpecializationConstant(uint32_t id, float value);
+
+    // Lee las fuentes y lanza compilacion y enlace sin esperar al driver. Cada variante se compila la
+    // primera vez que se pide; despues se devuelve el mismo handle
+    ProgramHandle load(const std::string &vertexPath, const std::string &fragmentPath,
+                       const ShaderPermutation &permutation = ShaderPermutation());
+
+    // Bloquea hasta que terminan todas las compilaciones en curso (arranque). false si alguna fallo
+    bool finish();
+
+    // Una vez por frame: recoge lo terminado sin bloquear y relanza los programas con ficheros modificados
+    void update();
+
+    // El programa activo; 0 si aun no hay ninguno
+    unsigned int getProgram(ProgramHandle handle) const;
+
+    // Material del programa activo (por nombre o, si viene de SPIR-V, por location fija)
+    Material getMaterial(ProgramHandle handle) const;
+
+    // Hilo de grabacion: el material se reescribe en applyUpdates() cada vez que su programa se sustituye
+    void bindMaterial(ProgramHandle handle, Material *material);
+
+    // Hilo de grabacion, antes de grabar: aplica los programas que update() ha dado por buenos
+    void applyUpdates();
+
+    // Recompila lo que cambie en directory (no recursivo). Solo en Linux
+    bool watch(const std::string &directory);
+
+    bool isParallelCompileSupported() const;
+
+    // Programas activos que se cargaron desde SPIR-V
+    size_t getSpirvCount() const;
+
+    // Variantes distintas pedidas a load()
+    size_t getProgramCount() const;
+
+    // Compilaciones lanzadas, fallidas y programas sustituidos en caliente
+    size_t getCompileCount() const;
+
+    size_t getFailedCount() const;
+
+    size_t getReloadCount() const;
+
+    // Log mapeado del ultimo fallo
+    std::string getLastError() const;
+
+    // Hilo GL: borra todos los programas
+    void destroy();
+
+private:
+    struct Program {
+        std::string vertexPath;
+        std::string fragmentPath;
+        ShaderDefines defines;
+        ShaderSource vertex;
+        ShaderSource fragment;
+        unsigned int active = 0;
+        // Compilacion en curso (0 = ninguna)
+        unsigned int pending = 0;
+        unsigned int vertexShader = 0;
+        unsigned int fragmentShader = 0;
+        uint64_t key = 0;
+        uint64_t submitNS = 0;
+        int pendingFrames = 0;
+        // El activo y el pendiente vienen de SPIR-V; glslOnly tras un rechazo del driver
+        bool spirv = false;
+        bool pendingSpirv = false;
+        bool glslOnly = false;
+    };
+
+    // Programa sustituido: se borra cuando ya no puede quedar en ningun paquete en vuelo
+    struct Retired {
+        unsigned int program;
+        bool applied;
+        int frames;
+    };
+
+    void submit(ProgramHandle handle);
+
+    bool isComplete(const Program &program) const;
+
+    // Consulta el resultado del enlace; si es bueno sustituye al activo. false si fallo
+    bool complete(ProgramHandle handle);
+
+    void readChanges();
+
+    ProgramCache *cache;
+    bool parallelCompile;
+    std::vector<Program> programs;
+    // Rutas y clave de la permutacion -> handle
+    std::unordered_map<std::string, ProgramHandle> variants;
+    std::vector<std::pair<std::string, unsigned int> > blockBindings;
+    std::vector<std::pair<std::string, int> > samplerBindings;
+    std::string spirvDirectory;
+    std::vector<std::pair<uint32_t, float> > specialization;
+
+    int watchDescriptor;
+    int inotifyDescriptor;
+    std::string watchedDirectory;
+
+    // update() publica, applyUpdates() aplica
+    mutable std::mutex mutex;
+    std::vector<Material *> materials;
+    std::vector<std::pair<ProgramHandle, Material> > published;
+    std::vector<Retired> retired;
+    std::string lastError;
+
+    size_t compileCount;
+    size_t failedCount;
+    size_t reloadCount;
+};
+
+
+#endif //SDL_OGL_SHADERMANAGER_H
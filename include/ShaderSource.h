@@ -0,0 +1,57 @@
+#ifndef SDL_OGL_SHADERSOURCE_H
+#define SDL_OGL_SHADERSOURCE_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Fuente GLSL lista para glShaderSource y, por cada linea, el fichero y la linea de donde viene.
+// Con ella los errores del compilador se reportan sobre los ficheros originales
+struct ShaderSource {
+    struct Line {
+        uint32_t file;
+        uint32_t line;
+    };
+
+    std::string text;
+    // files[0] es el fichero pedido; despues, los incluidos
+    std::vector<std::string> files;
+    // lines[n - 1]: origen de la linea n de text
+    std::vector<Line> lines;
+};
+
+// Nombre y valor; se insertan como "#define NOMBRE VALOR" justo despues de #version
+typedef std::vector<std::pair<std::string, std::string> > ShaderDefines;
+
+// Variante de un programa. Cada campo llega al shader como #define (LIGHT_COUNT, TEXTURED, INSTANCED,
+// SHADOWS), asi las ramas se resuelven al compilar en lugar de con uniforms en cada fragmento
+struct ShaderPermutation {
+    uint32_t lightCount = 1;
+    bool textured = false;
+    bool instanced = false;
+    bool shadows = false;
+
+    // Distinto para cada combinacion
+    uint32_t key() const;
+
+    ShaderDefines defines() const;
+};
+
+// Variantes que se precompilan a SPIR-V (shader_compiler y el cocinado): la de por defecto y TEXTURED, la
+// del cubo. Otra variante cargada con useSpirv() compila su GLSL
+std::vector<ShaderPermutation> spirvPermutations();
+
+// Lee path expandiendo #include "fichero" (relativo al que lo incluye; cada fichero una sola vez, como
+// #pragma once) e inyecta defines. Las lineas de los defines se atribuyen a la de #version
+bool loadShaderSource(const std::string &path, ShaderSource &source, const ShaderDefines &defines = {});
+
+// Reescribe las lineas del log que citan una linea de la fuente ("0:12(5): error", "0(12) : error",
+// "ERROR: 0:12: ...") como "fichero:linea: mensaje", seguidas del texto de esa linea
+std::string mapShaderLog(const std::string &log, const ShaderSource &source);
+
+// FNV-1a del texto ya expandido: identifica la fuente exacta que se compila
+uint64_t hashShaderSource(const ShaderSource &source);
+
+
+#endif //SDL_OGL_SHADERSOURCE_H
@@ -0,0 +1,28 @@
+#ifndef SDL_OGL_SPIRV_H
+#define SDL_OGL_SPIRV_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ShaderSource.h"
+
+// Modulos SPIR-V generados offline por tools/shader_compiler (glslangValidator + spirv-opt) a partir de
+// la fuente ya expandida. El nombre lleva el hash de esa fuente: si el .glsl cambia (o cambian los defines)
+// no hay modulo y se compila el GLSL.
+
+// directory/cube.frag.<hash>.spv
+std::string spirvPath(const std::string &directory, const std::string &stagePath, const ShaderSource &source);
+
+// false si no existe o no es SPIR-V (numero magico)
+bool readSpirv(const std::string &path, std::vector<uint32_t> &words);
+
+// Instrucciones del modulo, sin contar la cabecera
+size_t countSpirvInstructions(const std::vector<uint32_t> &words);
+
+// constant_id de las constantes de especializacion que declara el modulo
+std::vector<uint32_t> spirvSpecializationIds(const std::vector<uint32_t> &words);
+
+
+#endif //SDL_OGL_SPIRV_H
@@ -0,0 +1,53 @@
+#ifndef SDL_OGL_SPSCQUEUE_H
+#define SDL_OGL_SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Cola lock-free de un productor y un consumidor, de capacidad fija (potencia de dos).
+// Cada indice solo lo escribe un hilo; pop() en vacio y push() en lleno devuelven false.
+// Para bloquear, el consumidor/productor espera sobre getSignal() con std::atomic::wait.
+template<typename T, size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    bool push(const T &value) {
+        const size_t head = writeIndex.load(std::memory_order_relaxed);
+        if (head - readIndex.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        slots[head & (Capacity - 1)] = value;
+        writeIndex.store(head + 1, std::memory_order_release);
+        signal.fetch_add(1, std::memory_order_release);
+        signal.notify_one();
+        return true;
+    }
+
+    bool pop(T &value) {
+        const size_t tail = readIndex.load(std::memory_order_relaxed);
+        if (tail == writeIndex.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = slots[tail & (Capacity - 1)];
+        readIndex.store(tail + 1, std::memory_order_release);
+        signal.fetch_add(1, std::memory_order_release);
+        signal.notify_one();
+        return true;
+    }
+
+    // Cambia con cada push/pop: leerlo antes de intentar la operacion y esperar a que cambie
+    std::atomic<uint32_t> &getSignal() {
+        return signal;
+    }
+
+private:
+    alignas(64) std::atomic<size_t> writeIndex{0};
+    alignas(64) std::atomic<size_t> readIndex{0};
+    alignas(64) std::atomic<uint32_t> signal{0};
+    T slots[Capacity];
+};
+
+
+#endif //SDL_OGL_SPSCQUEUE_H
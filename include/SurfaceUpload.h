@@ -0,0 +1,43 @@
+#ifndef SDL_OGL_SURFACEUPLOAD_H
+#define SDL_OGL_SURFACEUPLOAD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <glad/glad.h>
+#include <SDL3_image/SDL_image.h>
+
+// Subida de SDL_Surface sin pasadas extra por la CPU. Las filas se suben en el orden de la imagen
+// (la primera es la superior): la orientacion la corrigen las UV del shader, no un flip.
+// Los formatos de 8 bits por canal que GL lee tal cual se suben desde surface->pixels con su pitch;
+// RGB24/BGR24 se expanden a RGBA8 en una sola pasada SSE2 que escribe directamente en un PBO mapeado.
+
+// Como lee GL la superficie sin convertir
+struct SurfaceLayout {
+    GLenum format;
+    GLenum type;
+    // Pixeles por fila en memoria (GL_UNPACK_ROW_LENGTH) y alineacion del pitch
+    int rowLength;
+    int alignment;
+    // Formatos X8: el cuarto canal no es alfa, se lee como 1 con GL_TEXTURE_SWIZZLE_A
+    bool opaque;
+};
+
+// false si GL no puede leer la superficie tal cual
+bool describeSurface(const SDL_Surface *surface, SurfaceLayout &layout);
+
+// RGB24/BGR24 con cualquier pitch
+bool canExpandSurface(const SDL_Surface *surface);
+
+// Directa o expandible: uploadSurface la acepta sin SDL_ConvertSurface previo
+bool isSurfaceUploadable(const SDL_Surface *surface);
+
+// RGB24/BGR24 -> RGBA8 compacto (width * 4 por fila), alfa 255
+void expandSurfaceRGBA8(const SDL_Surface *surface, uint8_t *rgba);
+
+// Hilo GL: define el nivel 0 (GL_RGBA8) de la textura enlazada en GL_TEXTURE_2D. pbo != 0 se usa como
+// staging (se huerfana y se rellena); con 0 las directas se leen de la superficie y las expandidas
+// usan un PBO temporal. false si el formato no se acepta (ver isSurfaceUploadable)
+bool uploadSurface(const SDL_Surface *surface, unsigned int pbo);
+
+
+#endif //SDL_OGL_SURFACEUPLOAD_H
@@ -10,20 +10,21 @@ public:
 
     ~Texture();
 
+    // Posee el nombre GL: una copia lo borraria dos veces
+    Texture(const Texture &) = delete;
+
+    Texture &operator=(const Texture &) = delete;
+
     void loadData();
 
     unsigned int getID() const;
 
 private:
     std::string path;
-    SDL_Surface *surface;
-    SDL_PixelFormat pixelFormat;
 
     unsigned int width;
     unsigned int height;
     unsigned int id;
-    const SDL_PixelFormatDetails *pixelDetails;
-    unsigned int bytesPerPixel;
 };
 
 
@@ -0,0 +1,110 @@
+#ifndef SDL_OGL_TEXTURECACHE_H
+#define SDL_OGL_TEXTURECACHE_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "TextureStreamer.h"
+
+// Handle de una textura de la cache: el id del streamer, estable mientras tenga referencias
+typedef StreamedTextureId TextureHandle;
+
+// Cache de texturas sobre TextureStreamer. Deduplica por ruta normalizada y por contenido (dos copias del
+// mismo fichero comparten textura) y cuenta referencias por handle. acquire() solo lee una huella barata
+// (tamaño y primeros bytes: la cabecera en un .tex); si coincide con la de otra textura los workers hashean
+// los dos ficheros y update() une la copia con la original: el handle de la copia pasa a ser un alias y su
+// carga, que siguio en paralelo, se descarta. Si los bytes residentes pasan del presupuesto de VRAM,
+// update() expulsa primero las texturas sin referencias menos usadas y despues quita el nivel 0 a las
+// referenciadas, tambien por orden de uso; lo que toca GL se hace fuera del mutex.
+class TextureCache {
+public:
+    TextureCache();
+
+    // streamer ya iniciado (begin). vramBudgetBytes = 0: sin limite
+    void begin(TextureStreamer *streamer, size_t vramBudgetBytes);
+
+    // Hilo principal: devuelve el handle con una referencia mas, pidiendo la textura si no estaba
+    TextureHandle acquire(const std::string &path);
+
+    void retain(TextureHandle handle);
+
+    // Sin referencias la textura sigue residente hasta que el presupuesto la necesite
+    void release(TextureHandle handle);
+
+    // Hilo GL, una vez por frame: update del streamer y aplica el presupuesto
+    void update();
+
+    // Hilo GL, antes de update(): ver TextureStreamer::requestResolution
+    void requestResolution(TextureHandle handle, float pixels);
+
+    // Hilo GL: como TextureStreamer::getTexture, y marca la textura como usada en este frame
+    unsigned int getTexture(TextureHandle handle);
+
+    size_t getResidentBytes() const;
+
+    size_t getHits() const;
+
+    size_t getMisses() const;
+
+    // Aciertos (por ruta o contenido) / peticiones
+    double getHitRate() const;
+
+    size_t getEvictedCount() const;
+
+    size_t getDroppedMipCount() const;
+
+    TextureStreamer *getStreamer() const;
+
+private:
+    struct Entry {
+        std::string key;
+        uint64_t fingerprint = 0;
+        int references = 0;
+        uint64_t lastUsedFrame = 0;
+    };
+
+    // copy tiene la misma huella que original; se unen si el hash del contenido tambien coincide
+    struct Verification {
+        TextureHandle copy;
+        TextureHandle original;
+    };
+
+    // FNV-1a del tamaño y los primeros bytes; 0 si no se puede leer
+    static uint64_t fingerprintFile(const std::string &path);
+
+    // Con mutex: el handle de la textura a la que apunta handle, que puede ser un alias
+    TextureHandle resolve(TextureHandle handle) const;
+
+    // Con mutex: une las copias ya verificadas con sus originales
+    void mergeVerified();
+
+    // Con mutex: saca de la cache las texturas sin referencias que hay que expulsar y ordena por uso
+    // las referenciadas, a las que se quitara el nivel 0 si sigue sin caber
+    void selectVictims(std::vector<TextureHandle> &evicted, std::vector<TextureHandle> &reduced);
+
+    TextureStreamer *streamer;
+    size_t vramBudgetBytes;
+    uint64_t frame;
+
+    mutable std::mutex mutex;
+    std::unordered_map<TextureHandle, Entry> entries;
+    std::unordered_map<std::string, TextureHandle> byPath;
+    std::unordered_map<uint64_t, TextureHandle> byFingerprint;
+    // Copias unidas a su original; su id del streamer no se recicla mientras exista el alias
+    std::unordered_map<TextureHandle, TextureHandle> aliases;
+    std::vector<Verification> verifications;
+    // Ids de copias unidas y expulsadas aun ocupadas, pendientes de reciclar (solo los toca el hilo GL)
+    std::vector<TextureHandle> retired;
+
+    size_t residentBytes;
+    size_t hits;
+    size_t misses;
+    size_t evictedCount;
+    size_t droppedMipCount;
+};
+
+
+#endif //SDL_OGL_TEXTURECACHE_H
@@ -0,0 +1,81 @@
+#ifndef SDL_OGL_TEXTUREFILE_H
+#define SDL_OGL_TEXTUREFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "AssetFileSystem.h"
+#include "BlockCompression.h"
+
+// Contenedor .tex: cabecera + cadena de mips ya calculada, filas en el orden de la imagen (sin voltear: como
+// todas las texturas, la orientacion la corrige cube.vert). Cada nivel empieza en un offset multiplo de 4KB
+// para poder subirlo directamente desde el fichero mapeado.
+static constexpr uint32_t TEXTURE_FILE_MAGIC = 0x58544F53; // "SOTX"
+// 2: filas sin voltear (la version 1 las guardaba de abajo arriba)
+static constexpr uint32_t TEXTURE_FILE_VERSION = 2;
+static constexpr uint32_t TEXTURE_FILE_ALIGNMENT = 4096;
+static constexpr uint32_t TEXTURE_FILE_MAX_LEVELS = 16;
+// format: RGBA8 sin comprimir o BLOCK_FORMAT_* + 1
+static constexpr uint32_t TEXTURE_FILE_RGBA8 = 0;
+
+struct TextureFileLevel {
+    uint64_t offset;
+    uint64_t size;
+    uint32_t width;
+    uint32_t height;
+};
+
+struct TextureFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t format;
+    uint32_t levelCount;
+    uint32_t width;
+    uint32_t height;
+    TextureFileLevel levels[TEXTURE_FILE_MAX_LEVELS];
+};
+
+// levels[0] de width x height; RGBA8 o bloques de BLOCK_FORMAT_* (format como en la cabecera)
+bool writeTextureFile(const std::string &path, uint32_t format, int width, int height,
+                      const std::vector<std::vector<uint8_t> > &levels);
+
+// Fichero .tex leido de assetFileSystem() (solo lectura). Los niveles apuntan dentro del mapeo, del paquete
+// o del fichero suelto
+class MappedTextureFile {
+public:
+    MappedTextureFile();
+
+    ~MappedTextureFile();
+
+    MappedTextureFile(const MappedTextureFile &) = delete;
+
+    MappedTextureFile &operator=(const MappedTextureFile &) = delete;
+
+    bool open(const std::string &path);
+
+    void close();
+
+    // Pide al sistema que lea ya las paginas de firstLevel en adelante (desde un worker, antes de subir en el hilo GL)
+    void prefetch(uint32_t firstLevel = 0) const;
+
+    const TextureFileHeader &getHeader() const;
+
+    const uint8_t *getLevelData(uint32_t level) const;
+
+    size_t getDataBytes() const;
+
+private:
+    AssetData data;
+};
+
+// Requiere contexto GL. Sube los niveles [baseLevel, levelCount) desde el mapeo, sin glGenerateMipmap,
+// con GL_TEXTURE_BASE_LEVEL = baseLevel: los niveles mas grandes se pueden subir despues (streaming de mips)
+unsigned int createTextureFromFile(const MappedTextureFile &file, uint32_t baseLevel = 0);
+
+// Sube un nivel del fichero a la textura enlazada en GL_TEXTURE_2D (sin tocar BASE_LEVEL)
+void uploadTextureFileLevel(const MappedTextureFile &file, uint32_t level);
+
+
+#endif //SDL_OGL_TEXTUREFILE_H
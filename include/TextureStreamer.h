@@ -0,0 +1,220 @@
+#ifndef SDL_OGL_TEXTURESTREAMER_H
+#define SDL_OGL_TEXTURESTREAMER_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <glad/glad.h>
+#include <SDL3_image/SDL_image.h>
+
+#include "CompressedTexture.h"
+#include "GpuLoader.h"
+#include "JobSystem.h"
+#include "TextureFile.h"
+
+typedef uint32_t StreamedTextureId;
+
+// Carga de texturas en segundo plano: la decodificacion (IMG_Load y, si hace falta, conversion)
+// corre en los workers del JobSystem y la subida se hace en el hilo GL a traves de PBOs,
+// con un presupuesto de bytes por frame, o en el hilo de un GpuLoader si se le pasa uno.
+// Las rutas .dds y .tex (ver texture_encoder) no se decodifican: se suben tal cual, con sus mips.
+// Hasta que la fence de la subida se señala, getTexture() devuelve una textura placeholder.
+// Con presupuesto de mips (setMipBudget) los .tex empiezan solo con sus niveles pequeños y los
+// grandes se suben o se sueltan en cada update() segun la resolucion pedida con requestResolution().
+class TextureStreamer {
+public:
+    TextureStreamer();
+
+    ~TextureStreamer();
+
+    // Hilo GL: crea el placeholder. uploadBudgetBytes limita lo subido en cada update();
+    // con loader las subidas van a su contexto compartido y no cuentan en el presupuesto
+    void begin(JobSystem *jobs, size_t uploadBudgetBytes, GpuLoader *loader = nullptr);
+
+    // Antes de request(): bytes maximos entre todas las texturas .tex con streaming de mips. 0 = sin streaming
+    void setMipBudget(size_t bytes);
+
+    // Desde un worker del JobSystem (p.ej. el hilo principal). Sin workers extra decodifica en linea.
+    // Reutiliza los ids liberados con recycle()
+    StreamedTextureId request(const std::string &path);
+
+    // Desde un worker: calcula en segundo plano (en linea sin workers extra) un hash de todo el fichero
+    void hashContent(StreamedTextureId id);
+
+    // false mientras hashContent no haya terminado. hash = 0 si no se pudo leer
+    bool getContentHash(StreamedTextureId id, uint64_t &hash) const;
+
+    // Hilo GL, una vez por frame: publica las subidas terminadas y sube lo decodificado
+    void update();
+
+    // Hilo GL, antes de update(): diametro en pixeles con el que se vera la textura en este frame (se queda
+    // el mayor). Sin peticiones durante unos frames sus niveles grandes se sueltan
+    void requestResolution(StreamedTextureId id, float pixels);
+
+    // Hilo GL: la textura real si ya esta lista, si no el placeholder
+    unsigned int getTexture(StreamedTextureId id) const;
+
+    bool isReady(StreamedTextureId id) const;
+
+    // Bytes de VRAM de la textura lista (todos sus niveles); 0 si no lo esta
+    size_t getTextureBytes(StreamedTextureId id) const;
+
+    // Hilo GL: borra una textura lista; getTexture vuelve a dar el placeholder. Para recargarla hay que pedirla de nuevo
+    void evict(StreamedTextureId id);
+
+    // Hilo GL: libera el id de una textura expulsada o fallida para que request() lo reutilice. false (y no
+    // hace nada) si aun se esta cargando o hasheando
+    bool recycle(StreamedTextureId id);
+
+    // Hilo GL: sustituye la textura por otra sin su nivel 0 (lee los demas niveles de vuelta de la GPU).
+    // Devuelve los bytes liberados; 0 si solo le queda un nivel
+    size_t dropTopMip(StreamedTextureId id);
+
+    // Texturas pedidas que aun no estan listas ni han fallado
+    size_t getPendingCount() const;
+
+    size_t getReadyCount() const;
+
+    size_t getFailedCount() const;
+
+    // Bytes subidos en el ultimo update()
+    size_t getLastUploadBytes() const;
+
+    // Bytes en la GPU de las texturas con streaming de mips
+    size_t getStreamedBytes() const;
+
+    // Niveles subidos y soltados por el streaming de mips desde el principio
+    size_t getStreamedLevelsIn() const;
+
+    size_t getStreamedLevelsOut() const;
+
+    // Hilo principal: espera a que terminen las decodificaciones en curso
+    void waitForDecodes();
+
+    // Hilo GL: libera texturas, PBOs y fences
+    void destroy();
+
+private:
+    enum State {
+        STATE_DECODING,
+        STATE_DECODED,
+        STATE_UPLOADING,
+        STATE_READY,
+        STATE_FAILED,
+        STATE_EVICTED
+    };
+
+    struct Entry {
+        std::string path;
+        std::atomic<int> state{STATE_DECODING};
+        unsigned int texture = 0;
+        size_t bytes = 0;
+        // Solo con loader; la textura es entonces del loader
+        GpuResourceId resource = 0;
+        bool loaded = false;
+
+        // Streaming de mips (.tex): en la GPU estan los niveles [residentBase, levelCount)
+        std::shared_ptr<MappedTextureFile> file;
+        int residentBase = 0;
+        // Niveles que nunca se sueltan (los de la carga inicial)
+        int tailBase = 0;
+        // El mas grande que se puede subir; lo sube dropTopMip
+        int minimumBase = 0;
+        float demand = 0.0f;
+        // La de este frame, para elegir a quien quitar un nivel si el presupuesto no da
+        float lastDemand = 0.0f;
+        int idleFrames = 0;
+
+        // hashContent: hashing mientras el job esta en curso, hashed cuando contentHash ya es valido
+        std::atomic<bool> hashing{false};
+        std::atomic<bool> hashed{false};
+        std::atomic<uint64_t> contentHash{0};
+    };
+
+    // Una de tres: superficie que acepta uploadSurface, niveles leidos de un DDS o un .tex mapeado
+    struct DecodedImage {
+        StreamedTextureId id;
+        SDL_Surface *surface;
+        std::shared_ptr<CompressedImage> compressed;
+        std::shared_ptr<MappedTextureFile> mapped;
+    };
+
+    struct Upload {
+        StreamedTextureId id;
+        // 0 en las subidas sin PBO (DDS y .tex)
+        unsigned int pbo;
+        GLsync fence;
+    };
+
+    static void decodeJob(void *data, uint32_t begin, uint32_t end);
+
+    static void hashJob(void *data, uint32_t begin, uint32_t end);
+
+    void hash(StreamedTextureId id);
+
+    void decode(StreamedTextureId id);
+
+    void decodeCompressed(StreamedTextureId id);
+
+    void mapTextureFile(StreamedTextureId id);
+
+    // Con loader: la textura la crea su hilo y update() la publica cuando este lista
+    void queueLoaderUpload(StreamedTextureId id, GpuResourceId resource);
+
+    size_t imageBytes(const DecodedImage &image) const;
+
+    void fail(StreamedTextureId id);
+
+    void publish(StreamedTextureId id);
+
+    void streamMips();
+
+    // Hilo GL: suelta el nivel residentBase de una textura en streaming. Devuelve los bytes liberados
+    size_t unloadLevel(Entry &target);
+
+    // La textura en streaming con menos demanda que demand (distinta de except) que aun tiene niveles por
+    // encima de su cola inicial; nullptr si no hay ninguna
+    Entry *lowestDemandVictim(StreamedTextureId except, float demand);
+
+    // Primer nivel de la carga inicial de un .tex: el primero que cabe en MIP_STREAM_TAIL_SIZE
+    static int streamTailBase(const MappedTextureFile &file);
+
+    bool upload(const DecodedImage &image);
+
+    Entry &entry(StreamedTextureId id) const;
+
+    JobSystem *jobs;
+    GpuLoader *loader;
+    JobCounter decodes;
+    size_t uploadBudgetBytes;
+    size_t mipBudgetBytes;
+
+    // entries solo crece (deque: las referencias no se invalidan) y sus ids se reutilizan desde freeIds;
+    // decoded lo llenan los workers
+    mutable std::mutex mutex;
+    std::deque<Entry> entries;
+    std::vector<StreamedTextureId> freeIds;
+    std::deque<DecodedImage> decoded;
+    // Enviadas al loader, pendientes de que las publique
+    std::vector<StreamedTextureId> loading;
+
+    std::vector<Upload> uploads;
+    std::vector<unsigned int> freePBOs;
+    // Publicadas con streaming de mips (solo las toca el hilo GL)
+    std::vector<StreamedTextureId> streamed;
+    size_t streamedBytes;
+    size_t streamedLevelsIn;
+    size_t streamedLevelsOut;
+    unsigned int placeholder;
+    size_t lastUploadBytes;
+    std::atomic<size_t> readyCount;
+    std::atomic<size_t> failedCount;
+    std::atomic<size_t> evictedCount;
+};
+
+
+#endif //SDL_OGL_TEXTURESTREAMER_H
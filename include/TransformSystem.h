@@ -0,0 +1,78 @@
+#ifndef SDL_OGL_TRANSFORMSYSTEM_H
+#define SDL_OGL_TRANSFORMSYSTEM_H
+
+#include <cstdint>
+#include <vector>
+#include <glm.hpp>
+#include <gtc/quaternion.hpp>
+
+#include "JobSystem.h"
+
+typedef uint32_t TransformId;
+
+// Jerarquia de transformaciones en estructura de arrays (SoA). Los nodos se guardan
+// ordenados por profundidad, de modo que un padre siempre precede a sus hijos y cada
+// nivel se puede procesar en paralelo. Solo se recalculan los subarboles sucios, y de
+// cada nivel solo se recorre el rango que los contiene.
+class TransformSystem {
+public:
+    static constexpr TransformId NO_PARENT = UINT32_MAX;
+
+    // El padre debe existir ya
+    TransformId create(TransformId parent = NO_PARENT);
+
+    void setPosition(TransformId id, const glm::vec3 &position);
+
+    void setRotation(TransformId id, const glm::quat &rotation);
+
+    void setScale(TransformId id, const glm::vec3 &scale);
+
+    void setLocal(TransformId id, const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale);
+
+    const glm::mat4 &getWorld(TransformId id) const;
+
+    // Recalcula las matrices de mundo sucias, nivel a nivel; con jobs, cada nivel grande se reparte
+    void update(JobSystem *jobs = nullptr);
+
+    size_t size() const;
+
+    // Nodos recalculados en el ultimo update
+    size_t getLastUpdatedCount() const;
+
+private:
+    void sortByDepth();
+
+    void updateRange(uint32_t begin, uint32_t end, size_t &updated);
+
+    bool resolveDirty(uint32_t slot);
+
+    void updateSlot(uint32_t slot);
+
+    void markDirty(uint32_t slot);
+
+    // SoA indexado por slot (orden por profundidad)
+    std::vector<uint32_t> parents;
+    std::vector<glm::vec3> positions;
+    std::vector<glm::quat> rotations;
+    std::vector<glm::vec3> scales;
+    std::vector<glm::mat4> worlds;
+    std::vector<uint8_t> dirty;
+    std::vector<uint32_t> depths;
+
+    // levels[d]..levels[d + 1] son los slots de profundidad d
+    std::vector<uint32_t> levels;
+
+    // Por nivel, slots sucios en [dirtyBegin, dirtyEnd); vacio si begin >= end
+    std::vector<uint32_t> dirtyBegin;
+    std::vector<uint32_t> dirtyEnd;
+
+    // Los ids son estables; el slot cambia al reordenar
+    std::vector<uint32_t> idToSlot;
+    std::vector<TransformId> slotToId;
+
+    bool needsSort = false;
+    size_t lastUpdated = 0;
+};
+
+
+#endif //SDL_OGL_TRANSFORMSYSTEM_H
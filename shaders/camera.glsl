@@ -0,0 +1,7 @@
+// Camara compartida por todos los shaders (binding 0, ver CameraUniforms en main.cpp)
+layout (std140) BINDING(0) uniform CameraBlock
+{
+    mat4 projection;
+    mat4 view;
+    vec4 viewPos;
+};
@@ -0,0 +1,12 @@
+// Se incluye justo despues de #version. Al compilar a SPIR-V (glslang -G define GL_SPIRV) los nombres no
+// llegan al programa: los uniforms sueltos llevan location fija (UniformLocation en RenderCommands.h) y los
+// samplers y bloques su binding. En GLSL las macros no dejan nada
+#ifdef GL_SPIRV
+#extension GL_ARB_explicit_uniform_location : require
+#extension GL_ARB_shading_language_420pack : require
+#define LOCATION(n) layout (location = n)
+#define BINDING(n) layout (binding = n)
+#else
+#define LOCATION(n)
+#define BINDING(n)
+#endif
@@ -1,37 +1,42 @@
 #version 330 core
+#include "common.glsl"
 out vec4 FragColor;
 
-in vec3 Normal;
+// Mismo orden que las salidas de cube.vert (SPIR-V las enlaza por location)
 in vec3 FragPos;
+in vec3 Normal;
+#ifdef TEXTURED
+in vec2 TexCoord;
+
+// texture samplers
+BINDING(0) uniform sampler2D texture1;
+BINDING(1) uniform sampler2D texture2;
+#endif
+#ifdef SHADOWS
+in vec4 FragPosLightSpace;
+
+BINDING(2) uniform sampler2DShadow shadowMap;
+#endif
 
-uniform vec3 lightPos;
-uniform vec3 viewPos;
-uniform vec3 lightColor;
-uniform vec3 objectColor;
+#include "camera.glsl"
+#include "lighting.glsl"
+
+LOCATION(1) uniform vec3 objectColor;
 
 void main()
 {
-    // ambient
-    float ambientStrength = 0.1;
-    vec3 ambient = ambientStrength * lightColor;
-
-    // diffuse
     vec3 norm = normalize(Normal);
-    vec3 lightDir = normalize(lightPos - FragPos);
-    float diff = max(dot(norm, lightDir), 0.0);
-    vec3 diffuse = diff * lightColor;
+    vec3 viewDir = normalize(viewPos.xyz - FragPos);
+#ifdef SHADOWS
+    float shadow = shadowFactor(shadowMap, FragPosLightSpace);
+#else
+    float shadow = 1.0;
+#endif
 
-    // specular
-    float specularStrength = 0.5;
-    vec3 viewDir = normalize(viewPos - FragPos);
-    vec3 reflectDir = reflect(-lightDir, norm);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
-    vec3 specular = specularStrength * spec * lightColor;
-
-    vec3 result = (ambient + diffuse + specular) * objectColor;
+    vec3 result = lighting(norm, viewDir, FragPos, shadow) * objectColor;
+#ifdef TEXTURED
+    result *= mix(texture(texture1, TexCoord), texture(texture2, TexCoord), 0.2).rgb;
+#endif
     FragColor = vec4(result, 1.0);
-    // debug specular
-//    FragColor = vec4(vec3(spec), 1.0);
 //    FragColor = vec4(1.0, 0.0, 1.0, 1.0);
-
-}
\ No newline at end of file
+}
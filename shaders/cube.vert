@@ -1,18 +1,43 @@
 #version 330 core
+#include "common.glsl"
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
+#ifdef TEXTURED
+layout (location = 2) in vec2 aTexCoord;
+#endif
+#ifdef INSTANCED
+// Modelo por instancia (glVertexAttribDivisor 1): ocupa las locations 3 a 6
+layout (location = 3) in mat4 aModel;
+#else
+LOCATION(0) uniform mat4 model;
+#endif
 
 out vec3 FragPos;
 out vec3 Normal;
+#ifdef TEXTURED
+out vec2 TexCoord;
+#endif
+#ifdef SHADOWS
+LOCATION(20) uniform mat4 lightSpace;
+out vec4 FragPosLightSpace;
+#endif
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#include "camera.glsl"
 
 void main()
 {
+#ifdef INSTANCED
+    mat4 model = aModel;
+#endif
     FragPos = vec3(model * vec4(aPos, 1.0));
     Normal = mat3(transpose(inverse(model))) * aNormal;
+#ifdef TEXTURED
+    // Superficies, DDS y .tex se suben sin voltear (primera fila de la imagen en v = 0): se invierte v aqui
+    TexCoord = vec2(aTexCoord.x, 1.0 - aTexCoord.y);
+#endif
+#ifdef SHADOWS
+    FragPosLightSpace = lightSpace * vec4(FragPos, 1.0);
+#endif
 
     gl_Position = projection * view * vec4(FragPos, 1.0);
-}
\ No newline at end of file
+}
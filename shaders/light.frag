@@ -1,4 +1,5 @@
 #version 330 core
+#include "common.glsl"
 out vec4 FragColor;
 
 void main()
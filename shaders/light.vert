@@ -1,9 +1,10 @@
 #version 330 core
+#include "common.glsl"
 layout (location = 0) in vec3 aPos;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+LOCATION(0) uniform mat4 model;
+
+#include "camera.glsl"
 
 void main()
 {
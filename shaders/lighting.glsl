@@ -0,0 +1,78 @@
+// Phong con LIGHT_COUNT luces puntuales. Los valores por defecto se pueden sustituir inyectando los defines
+#ifndef LIGHT_COUNT
+#define LIGHT_COUNT 1
+#endif
+#ifndef AMBIENT_STRENGTH
+#define AMBIENT_STRENGTH 0.1
+#endif
+#ifndef SPECULAR_STRENGTH
+#define SPECULAR_STRENGTH 0.5
+#endif
+#ifndef SHININESS
+#define SHININESS 32.0
+#endif
+
+#ifdef GL_SPIRV
+// Fijadas al cargar el modulo (ShaderManager::setSpecializationConstant); por defecto, los defines
+layout (constant_id = 0) const float ambientStrength = AMBIENT_STRENGTH;
+layout (constant_id = 1) const float specularStrength = SPECULAR_STRENGTH;
+layout (constant_id = 2) const float shininess = SHININESS;
+#else
+const float ambientStrength = AMBIENT_STRENGTH;
+const float specularStrength = SPECULAR_STRENGTH;
+const float shininess = SHININESS;
+#endif
+
+#if LIGHT_COUNT > 0
+// "lightPos" / "lightColor" son el elemento 0 (ver createMaterial). Con SPIR-V, hasta 8 luces
+LOCATION(4) uniform vec3 lightPos[LIGHT_COUNT];
+LOCATION(12) uniform vec3 lightColor[LIGHT_COUNT];
+#endif
+
+// shadow: 0 = en sombra, 1 = iluminado; solo atenua difusa y especular
+vec3 lighting(vec3 norm, vec3 viewDir, vec3 fragPos, float shadow)
+{
+    vec3 result = vec3(0.0);
+#if LIGHT_COUNT > 0
+    for (int i = 0; i < LIGHT_COUNT; i++)
+    {
+        // ambient
+        vec3 ambient = ambientStrength * lightColor[i];
+
+        // diffuse
+        vec3 lightDir = normalize(lightPos[i] - fragPos);
+        float diff = max(dot(norm, lightDir), 0.0);
+        vec3 diffuse = diff * lightColor[i];
+
+        // specular
+        vec3 reflectDir = reflect(-lightDir, norm);
+        float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
+        vec3 specular = specularStrength * spec * lightColor[i];
+
+        result += ambient + shadow * (diffuse + specular);
+    }
+#endif
+    return result;
+}
+
+#ifdef SHADOWS
+// PCF 3x3 sobre un shadow map con GL_TEXTURE_COMPARE_MODE
+float shadowFactor(sampler2DShadow shadowMap, vec4 lightSpacePos)
+{
+    vec3 coords = lightSpacePos.xyz / lightSpacePos.w * 0.5 + 0.5;
+    if (coords.z > 1.0)
+    {
+        return 1.0;
+    }
+    vec2 texel = 1.0 / vec2(textureSize(shadowMap, 0));
+    float lit = 0.0;
+    for (int y = -1; y <= 1; y++)
+    {
+        for (int x = -1; x <= 1; x++)
+        {
+            lit += texture(shadowMap, vec3(coords.xy + vec2(x, y) * texel, coords.z));
+        }
+    }
+    return lit / 9.0;
+}
+#endif
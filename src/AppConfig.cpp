@@ -0,0 +1,240 @@
+#include "AppConfig.h"
+
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+static bool parseInt(const char *value, int &out, long minimum = 1) {
+    char *end = nullptr;
+    const long parsed = strtol(value, &end, 10);
+    if (end == value || *end != '\0' || parsed < minimum || parsed > INT32_MAX) {
+        return false;
+    }
+    out = static_cast<int>(parsed);
+    return true;
+}
+
+static bool parsePacingMode(const char *value, PacingMode &out) {
+    for (const PacingMode mode: {PACING_VSYNC, PACING_ADAPTIVE_VSYNC, PACING_UNCAPPED, PACING_LIMITED}) {
+        if (strcmp(value, FramePacer::modeName(mode)) == 0) {
+            out = mode;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void printUsage(const char *program) {
+    SDL_Log("Usage: %s [options]", program);
+    SDL_Log("  --headless            render offscreen through EGL and write a JSON report");
+    SDL_Log("  --size WxH            framebuffer size (default 800x600)");
+    SDL_Log("  --frames N            measured frames in headless mode");
+    SDL_Log("  --warmup N            frames excluded from the report");
+    SDL_Log("  --report FILE|-       JSON report destination (default stdout)");
+    SDL_Log("  --lp-threads N        llvmpipe rasterizer threads (LP_NUM_THREADS)");
+    SDL_Log("  --tick-rate HZ        fixed simulation tick rate (default 60)");
+    SDL_Log("  --pacing MODE         vsync, adaptive, uncapped or limit");
+    SDL_Log("  --fps N               target frame rate for the limiter (implies --pacing limit)");
+    SDL_Log("  --frames-in-flight N  frames the CPU may run ahead of the GPU, 1-3 (default 2)");
+    SDL_Log("  --smooth-frames N     frames averaged into deltaTime (1 disables smoothing)");
+    SDL_Log("  --record FILE         record input to FILE");
+    SDL_Log("  --replay FILE         replay input recorded in FILE");
+    SDL_Log("  --bench NAME          run a CPU benchmark and exit (JSON to --report)");
+    SDL_Log("  --threads N           worker threads (default: logical cores)");
+    SDL_Log("  --pin-threads         pin each job system worker to a core (Linux)");
+    SDL_Log("  --latency             log input event to swap latency every frame");
+    SDL_Log("  --no-render-thread    submit GL from the main thread");
+    SDL_Log("  --upload-budget KB    texture bytes uploaded per frame (default 1024)");
+    SDL_Log("  --loader-thread       create textures on a thread with a shared GL context");
+    SDL_Log("  --vram-budget MB      texture cache budget before eviction (default 256)");
+    SDL_Log("  --mip-budget MB       streamed .tex mip levels budget (default 64)");
+    SDL_Log("  --program-cache DIR   program binary cache directory (default shader_cache in the user's");
+    SDL_Log("                        preferences directory)");
+    SDL_Log("  --no-program-cache    always compile and link shaders from source");
+    SDL_Log("  --hot-reload          recompile shaders when their files change (Linux); loose files");
+    SDL_Log("                        take precedence over the asset pack");
+    SDL_Log("  --no-spirv            compile GLSL even if precompiled SPIR-V modules exist");
+    SDL_Log("  --pack FILE           asset pack to mount (default data.pak next to the executable)");
+    SDL_Log("  --no-pack             read assets and shaders as loose files");
+    SDL_Log("  --source-dir DIR      directory of loose files (default: the source tree in Debug builds,");
+    SDL_Log("                        else the executable's directory); allows loose files and uncooked");
+    SDL_Log("                        sources, like --hot-reload and --no-pack");
+}
+
+bool parseAppConfig(int argc, char *argv[], AppConfig &config) {
+    // --fps implica --pacing limit salvo que se pida otro modo: se resuelve al final, sin depender del orden
+    bool pacingSet = false;
+    bool sourceDirectorySet = false;
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (strcmp(arg, "--headless") == 0) {
+            config.headless = true;
+        } else if (strcmp(arg, "--bench") == 0 && value) {
+            config.benchmark = value;
+            i++;
+        } else if (strcmp(arg, "--threads") == 0 && value) {
+            if (!parseInt(value, config.threads)) {
+                SDL_Log("Invalid --threads '%s'", value);
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--pin-threads") == 0) {
+            config.pinThreads = true;
+        } else if (strcmp(arg, "--latency") == 0) {
+            config.latencyLog = true;
+        } else if (strcmp(arg, "--no-render-thread") == 0) {
+            config.renderThread = false;
+        } else if (strcmp(arg, "--loader-thread") == 0) {
+            config.loaderThread = true;
+        } else if (strcmp(arg, "--upload-budget") == 0 && value) {
+            if (!parseInt(value, config.uploadBudgetKB)) {
+                SDL_Log("Invalid --upload-budget '%s'", value);
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--vram-budget") == 0 && value) {
+            if (!parseInt(value, config.vramBudgetMB)) {
+                SDL_Log("Invalid --vram-budget '%s'", value);
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--mip-budget") == 0 && value) {
+            if (!parseInt(value, config.mipBudgetMB)) {
+                SDL_Log("Invalid --mip-budget '%s'", value);
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--program-cache") == 0 && value) {
+            // Como --pack: relativo al directorio actual
+            std::error_code error;
+            const std::filesystem::path absolute = std::filesystem::absolute(value, error);
+            config.programCacheDir = error ? value : absolute.string();
+            i++;
+        } else if (strcmp(arg, "--no-program-cache") == 0) {
+            config.programCacheDir.clear();
+        } else if (strcmp(arg, "--hot-reload") == 0) {
+            config.hotReload = true;
+        } else if (strcmp(arg, "--no-spirv") == 0) {
+            config.spirv = false;
+        } else if (strcmp(arg, "--pack") == 0 && value) {
+            // El usuario lo da relativo al directorio actual, no al del ejecutable
+            std::error_code error;
+            const std::filesystem::path absolute = std::filesystem::absolute(value, error);
+            config.packPath = error ? value : absolute.string();
+            i++;
+        } else if (strcmp(arg, "--no-pack") == 0) {
+            config.packPath.clear();
+        } else if (strcmp(arg, "--source-dir") == 0 && value) {
+            config.sourceDirectory = value;
+            sourceDirectorySet = true;
+            i++;
+        } else if (strcmp(arg, "--size") == 0 && value) {
+            if (sscanf(value, "%dx%d", &config.width, &config.height) != 2 || config.width <= 0 || config.height <= 0) {
+                SDL_Log("Invalid --size '%s', expected WIDTHxHEIGHT", value);
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--frames") == 0 && value) {
+            if (!parseInt(value, config.frames)) {
+                SDL_Log("Invalid --frames '%s'", value);
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--warmup") == 0 && value) {
+            if (!parseInt(value, config.warmupFrames, 0)) {
+                SDL_Log("Invalid --warmup '%s'", value);
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--report") == 0 && value) {
+            config.reportPath = value;
+            i++;
+        } else if (strcmp(arg, "--tick-rate") == 0 && value) {
+            if (!parseInt(value, config.tickRate)) {
+                SDL_Log("Invalid --tick-rate '%s'", value);
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--pacing") == 0 && value) {
+            if (!parsePacingMode(value, config.pacing)) {
+                SDL_Log("Invalid --pacing '%s', expected vsync, adaptive, uncapped or limit", value);
+                return false;
+            }
+            pacingSet = true;
+            i++;
+        } else if (strcmp(arg, "--fps") == 0 && value) {
+            if (!parseInt(value, config.targetFps)) {
+                SDL_Log("Invalid --fps '%s'", value);
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--frames-in-flight") == 0 && value) {
+            if (!parseInt(value, config.framesInFlight) || config.framesInFlight > 3) {
+                SDL_Log("Invalid --frames-in-flight '%s', expected 1-3", value);
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--smooth-frames") == 0 && value) {
+            if (!parseInt(value, config.smoothingFrames)) {
+                SDL_Log("Invalid --smooth-frames '%s'", value);
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--record") == 0 && value) {
+            config.recordPath = value;
+            i++;
+        } else if (strcmp(arg, "--replay") == 0 && value) {
+            config.replayPath = value;
+            i++;
+        } else if (strcmp(arg, "--lp-threads") == 0 && value) {
+            if (!parseInt(value, config.llvmpipeThreads)) {
+                SDL_Log("Invalid --lp-threads '%s'", value);
+                return false;
+            }
+            i++;
+        } else {
+            SDL_Log("Unknown argument '%s'", arg);
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+
+    if (config.threads == 0) {
+        config.threads = SDL_GetNumLogicalCPUCores();
+    }
+    if (config.targetFps > 0 && !pacingSet) {
+        config.pacing = PACING_LIMITED;
+    }
+    if (config.targetFps > 0 && config.pacing != PACING_LIMITED) {
+        SDL_Log("--fps requires --pacing limit, got --pacing %s", FramePacer::modeName(config.pacing));
+        return false;
+    }
+    if (config.pacing == PACING_LIMITED && config.targetFps == 0) {
+        SDL_Log("--pacing limit requires --fps");
+        return false;
+    }
+    if (!config.recordPath.empty() && !config.replayPath.empty()) {
+        SDL_Log("--record and --replay are mutually exclusive");
+        return false;
+    }
+    config.devAssets = config.hotReload || sourceDirectorySet || config.packPath.empty() ||
+                       !config.benchmark.empty();
+    return true;
+}
+
+int resolveLlvmpipeThreads(const AppConfig &config) {
+    if (config.llvmpipeThreads > 0) {
+        return config.llvmpipeThreads;
+    }
+    if (const char *env = getenv("LP_NUM_THREADS")) {
+        return atoi(env);
+    }
+    // llvmpipe usa un hilo por CPU, con un maximo de LP_MAX_THREADS (32)
+    return std::min(SDL_GetNumLogicalCPUCores(), 32);
+}
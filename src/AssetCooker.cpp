@@ -0,0 +1,410 @@
+#include "AssetCooker.h"
+
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <cctype>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "AssetFileSystem.h"
+#include "AssetPack.h"
+#include "MipGenerator.h"
+#include "Process.h"
+#include "ShaderSource.h"
+#include "Spirv.h"
+#include "TextureFile.h"
+
+static constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+static constexpr uint64_t FNV_PRIME = 1099511628211ull;
+static constexpr const char *MANIFEST_NAME = "manifest.txt";
+
+enum CookRule {
+    COOK_RULE_COPY,
+    COOK_RULE_TEXTURE,
+    COOK_RULE_SHADER
+};
+
+enum CookStatus {
+    COOK_STATUS_COOKED,
+    COOK_STATUS_UP_TO_DATE,
+    COOK_STATUS_FAILED
+};
+
+// Una linea del manifiesto: fuente, hash de su contenido y del de sus dependencias, y lo que genero
+struct CookRecord {
+    std::string source;
+    uint64_t hash = 0;
+    std::vector<std::string> dependencies;
+    std::vector<std::string> outputs;
+};
+
+static CookRule ruleFor(const std::string &path) {
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) {
+        return static_cast<char>(tolower(c));
+    });
+    for (const char *image: {".png", ".jpg", ".jpeg", ".bmp", ".tga"}) {
+        if (extension == image) {
+            return COOK_RULE_TEXTURE;
+        }
+    }
+    return extension == ".vert" || extension == ".frag" ? COOK_RULE_SHADER : COOK_RULE_COPY;
+}
+
+std::string cookedAssetPath(const std::string &sourcePath) {
+    if (ruleFor(sourcePath) != COOK_RULE_TEXTURE) {
+        return sourcePath;
+    }
+    return std::filesystem::path(sourcePath).replace_extension(".tex").generic_string();
+}
+
+static void hashBytes(uint64_t &hash, const void *data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ static_cast<const uint8_t *>(data)[i]) * FNV_PRIME;
+    }
+}
+
+static bool hashFile(uint64_t &hash, const std::string &path) {
+    AssetData data;
+    if (!assetFileSystem().read(path, data)) {
+        return false;
+    }
+    hashBytes(hash, data.data(), data.size());
+    return true;
+}
+
+static bool writeFile(const std::filesystem::path &path, const void *data, size_t size) {
+    std::error_code error;
+    std::filesystem::create_directories(path.parent_path(), error);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+    return static_cast<bool>(file);
+}
+
+static bool copyFile(const std::string &source, const std::filesystem::path &output) {
+    AssetData data;
+    return assetFileSystem().read(source, data) && writeFile(output, data.data(), data.size());
+}
+
+// Decodifica y genera los mips: lo que Texture hacia en cada arranque. Va dentro de un job del parallelFor de
+// cookAssets, asi que los mips se generan en este hilo: un solo nivel de paralelismo, el de los fuentes
+static bool cookTexture(const std::string &source, const std::filesystem::path &output) {
+    SDL_Surface *surface = loadAssetImage(source);
+    SDL_Surface *converted = surface ? SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA32) : nullptr;
+    SDL_DestroySurface(surface);
+    if (!converted) {
+        printf("Unable to load image %s! SDL_image Error: %s\n", source.c_str(), SDL_GetError());
+        return false;
+    }
+    const int width = converted->w;
+    const int height = converted->h;
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+    for (int y = 0; y < height; y++) {
+        memcpy(pixels.data() + static_cast<size_t>(y) * width * 4,
+               static_cast<const uint8_t *>(converted->pixels) + static_cast<size_t>(y) * converted->pitch,
+               static_cast<size_t>(width) * 4);
+    }
+    SDL_DestroySurface(converted);
+
+    std::vector<std::vector<uint8_t> > levels;
+    generateMips(pixels.data(), width, height, MipOptions(), levels);
+    std::error_code error;
+    std::filesystem::create_directories(output.parent_path(), error);
+    return writeTextureFile(output.string(), TEXTURE_FILE_RGBA8, width, height, levels);
+}
+
+static bool cookShader(const AssetCookOptions &options, const std::string &source,
+                       const std::filesystem::path &cache, const CookRecord &record) {
+    if (!copyFile(source, cache / record.outputs[0])) {
+        printf("Unable to write %s\n", (cache / record.outputs[0]).string().c_str());
+        return false;
+    }
+    if (options.shaderCompiler.empty()) {
+        return true;
+    }
+    // shader_compiler ya borra los modulos de versiones anteriores del mismo fichero
+    const std::filesystem::path directory = (cache / record.outputs[1]).parent_path();
+    std::string log;
+    const bool ok = runProcess({options.shaderCompiler, "--glslang", options.glslang, "--spirv-opt",
+                                options.spirvOptimizer, "--out", directory.string(), source}, log);
+    if (!ok) {
+        printf("%s", log.c_str());
+    }
+    return ok;
+}
+
+// Calcula hash, dependencias y salidas de record.source y lo cocina si no coincide con previous
+static CookStatus cookSource(const AssetCookOptions &options, const std::filesystem::path &sourceDirectory,
+                             const std::filesystem::path &cache, const CookRecord *previous, CookRecord &record) {
+    const std::string source = (sourceDirectory / record.source).string();
+    const CookRule rule = ruleFor(record.source);
+    uint64_t hash = FNV_OFFSET;
+    hashBytes(hash, &rule, sizeof(rule));
+    record.outputs = {cookedAssetPath(record.source)};
+    if (rule == COOK_RULE_SHADER) {
+        const bool spirv = !options.shaderCompiler.empty();
+        hashBytes(hash, &spirv, sizeof(spirv));
+        // Las dependencias salen de la fuente expandida con los defines por defecto
+        ShaderSource expanded;
+        if (!loadShaderSource(source, expanded, ShaderPermutation().defines())) {
+            printf("Unable to read %s\n", source.c_str());
+            return COOK_STATUS_FAILED;
+        }
+        for (size_t i = 0; i < expanded.files.size(); i++) {
+            const std::string name = std::filesystem::path(expanded.files[i]).lexically_relative(sourceDirectory).
+                    generic_string();
+            hashBytes(hash, name.data(), name.size());
+            if (!hashFile(hash, expanded.files[i])) {
+                return COOK_STATUS_FAILED;
+            }
+            if (i > 0) {
+                record.dependencies.push_back(name);
+            }
+        }
+        if (spirv) {
+            // Un modulo por variante precompilada; las fuentes incluidas son las mismas en todas
+            const std::string directory = (std::filesystem::path(record.source).parent_path() / "spirv").
+                    generic_string();
+            for (const ShaderPermutation &permutation: spirvPermutations()) {
+                ShaderSource variant;
+                if (!loadShaderSource(source, variant, permutation.defines())) {
+                    printf("Unable to read %s\n", source.c_str());
+                    return COOK_STATUS_FAILED;
+                }
+                const std::string module = spirvPath(directory, record.source, variant);
+                record.outputs.push_back(std::filesystem::path(module).generic_string());
+                record.outputs.push_back(module.substr(0, module.size() - 4) + ".unoptimized.spv");
+            }
+        }
+    } else if (!hashFile(hash, source)) {
+        printf("Unable to read %s\n", source.c_str());
+        return COOK_STATUS_FAILED;
+    }
+    record.hash = hash;
+
+    if (previous && previous->hash == hash && previous->outputs == record.outputs) {
+        bool present = true;
+        std::error_code error;
+        for (const std::string &output: record.outputs) {
+            present = present && std::filesystem::exists(cache / output, error);
+        }
+        if (present) {
+            return COOK_STATUS_UP_TO_DATE;
+        }
+    }
+
+    const uint64_t start = SDL_GetTicksNS();
+    bool ok;
+    if (rule == COOK_RULE_TEXTURE) {
+        ok = cookTexture(source, cache / record.outputs[0]);
+    } else if (rule == COOK_RULE_SHADER) {
+        ok = cookShader(options, source, cache, record);
+    } else {
+        ok = copyFile(source, cache / record.outputs[0]);
+    }
+    std::error_code error;
+    for (const std::string &output: record.outputs) {
+        ok = ok && std::filesystem::exists(cache / output, error);
+    }
+    if (!ok) {
+        printf("Unable to cook %s\n", record.source.c_str());
+        return COOK_STATUS_FAILED;
+    }
+    printf("Cooked %s -> %s (%.1f ms)\n", record.source.c_str(), record.outputs[0].c_str(),
+           static_cast<double>(SDL_GetTicksNS() - start) / 1000000.0);
+    return COOK_STATUS_COOKED;
+}
+
+static bool isUnoptimizedModule(const std::string &output) {
+    static const std::string suffix = ".unoptimized.spv";
+    return output.size() >= suffix.size() && output.compare(output.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+static std::string join(const std::vector<std::string> &values) {
+    std::string joined;
+    for (const std::string &value: values) {
+        joined += (joined.empty() ? "" : "|") + value;
+    }
+    return joined;
+}
+
+static std::vector<std::string> split(const std::string &joined) {
+    std::vector<std::string> values;
+    std::istringstream in(joined);
+    std::string value;
+    while (std::getline(in, value, '|')) {
+        values.push_back(value);
+    }
+    return values;
+}
+
+// Cabecera con la version: un manifiesto de otra version se descarta entero
+static std::unordered_map<std::string, CookRecord> readManifest(const std::filesystem::path &path) {
+    std::unordered_map<std::string, CookRecord> records;
+    std::ifstream file(path);
+    std::string line;
+    uint32_t version = 0;
+    if (!std::getline(file, line) || sscanf(line.c_str(), "asset-cooker %u", &version) != 1 ||
+        version != ASSET_COOKER_VERSION) {
+        return records;
+    }
+    while (std::getline(file, line)) {
+        std::istringstream in(line);
+        std::string hash;
+        std::string dependencies;
+        std::string outputs;
+        CookRecord record;
+        if (std::getline(in, hash, '\t') && std::getline(in, record.source, '\t') &&
+            std::getline(in, dependencies, '\t') && std::getline(in, outputs)) {
+            record.hash = strtoull(hash.c_str(), nullptr, 16);
+            record.dependencies = split(dependencies);
+            record.outputs = split(outputs);
+            records[record.source] = record;
+        }
+    }
+    return records;
+}
+
+static bool writeManifest(const std::filesystem::path &path, const std::vector<CookRecord> &records) {
+    std::ofstream file(path, std::ios::trunc);
+    file << "asset-cooker " << ASSET_COOKER_VERSION << "\n";
+    for (const CookRecord &record: records) {
+        char hash[24];
+        snprintf(hash, sizeof(hash), "%016" PRIx64, record.hash);
+        file << hash << "\t" << record.source << "\t" << join(record.dependencies) << "\t" << join(record.outputs)
+                << "\n";
+    }
+    return static_cast<bool>(file);
+}
+
+// Fuentes de options.inputs, relativas a sourceDirectory y ordenadas
+static bool collectSources(const AssetCookOptions &options, const std::filesystem::path &sourceDirectory,
+                           std::vector<std::string> &sources) {
+    std::error_code error;
+    for (const std::string &input: options.inputs) {
+        const std::filesystem::path path = (sourceDirectory / input).lexically_normal();
+        if (std::filesystem::is_regular_file(path, error)) {
+            sources.push_back(path.lexically_relative(sourceDirectory).generic_string());
+            continue;
+        }
+        if (!std::filesystem::is_directory(path, error)) {
+            printf("%s not found\n", path.string().c_str());
+            return false;
+        }
+        for (const auto &file: std::filesystem::recursive_directory_iterator(path, error)) {
+            if (file.is_regular_file()) {
+                sources.push_back(file.path().lexically_relative(sourceDirectory).generic_string());
+            }
+        }
+    }
+    std::sort(sources.begin(), sources.end());
+    sources.erase(std::unique(sources.begin(), sources.end()), sources.end());
+    return true;
+}
+
+bool cookAssets(const AssetCookOptions &options, JobSystem &jobs, AssetCookStats &stats) {
+    stats = AssetCookStats();
+    std::error_code error;
+    const std::filesystem::path sourceDirectory = std::filesystem::absolute(options.sourceDirectory, error).
+            lexically_normal();
+    const std::filesystem::path cache = options.cacheDirectory;
+    std::filesystem::create_directories(cache, error);
+    if (error) {
+        printf("Unable to create %s: %s\n", cache.string().c_str(), error.message().c_str());
+        return false;
+    }
+
+    std::vector<std::string> sources;
+    if (!collectSources(options, sourceDirectory, sources)) {
+        return false;
+    }
+    // Dos fuentes no pueden generar el mismo fichero ("a.png" y "a.jpg" -> "a.tex")
+    std::unordered_map<std::string, std::string> producers;
+    for (const std::string &source: sources) {
+        auto inserted = producers.emplace(cookedAssetPath(source), source);
+        if (!inserted.second) {
+            printf("%s and %s both cook to %s\n", inserted.first->second.c_str(), source.c_str(),
+                   inserted.first->first.c_str());
+            return false;
+        }
+    }
+
+    const std::filesystem::path manifestPath = cache / MANIFEST_NAME;
+    const std::unordered_map<std::string, CookRecord> previous = readManifest(manifestPath);
+    std::vector<CookRecord> records(sources.size());
+    std::vector<CookStatus> status(sources.size());
+    for (size_t i = 0; i < sources.size(); i++) {
+        records[i].source = sources[i];
+    }
+    jobs.parallelFor(0, static_cast<uint32_t>(sources.size()), 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            auto found = previous.find(records[i].source);
+            const CookRecord *old = found == previous.end() ? nullptr : &found->second;
+            status[i] = cookSource(options, sourceDirectory, cache, old, records[i]);
+            // Lo que genero antes sigue siendo suyo: no se borra y se reintenta en el siguiente cocinado
+            if (status[i] == COOK_STATUS_FAILED) {
+                records[i].hash = 0;
+                records[i].outputs = old ? old->outputs : std::vector<std::string>();
+            }
+        }
+    });
+    stats.sourceCount = sources.size();
+    for (const CookStatus value: status) {
+        stats.cookedCount += value == COOK_STATUS_COOKED;
+        stats.upToDateCount += value == COOK_STATUS_UP_TO_DATE;
+        stats.failedCount += value == COOK_STATUS_FAILED;
+    }
+
+    // Lo generado por fuentes borradas o por versiones anteriores de un fuente
+    std::unordered_set<std::string> current;
+    for (const CookRecord &record: records) {
+        current.insert(record.outputs.begin(), record.outputs.end());
+    }
+    for (const auto &entry: previous) {
+        for (const std::string &output: entry.second.outputs) {
+            if (!current.count(output) && std::filesystem::remove(cache / output, error)) {
+                stats.removedCount++;
+            }
+        }
+    }
+    if (!writeManifest(manifestPath, records)) {
+        printf("Unable to write %s\n", manifestPath.string().c_str());
+        return false;
+    }
+
+    if (!options.packPath.empty() && (stats.cookedCount || stats.removedCount ||
+                                      !std::filesystem::exists(options.packPath, error))) {
+        std::vector<AssetPackInput> files;
+        for (const CookRecord &record: records) {
+            for (const std::string &output: record.outputs) {
+                // Un fuente nuevo que fallo no tiene nada que empaquetar. El modulo sin optimizar solo lo lee
+                // el benchmark spirv desde la cache: no va al paquete
+                if (!isUnoptimizedModule(output) && std::filesystem::exists(cache / output, error)) {
+                    files.push_back({output, (cache / output).string()});
+                }
+            }
+        }
+        // Se escribe aparte y se renombra: un proceso que tenga mapeado el anterior no ve un fichero a medias
+        const std::string temporary = options.packPath + ".tmp";
+        AssetPackSummary summary;
+        if (!writeAssetPack(temporary, files, &summary)) {
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+        std::filesystem::rename(temporary, options.packPath, error);
+        if (error) {
+            printf("Unable to write %s: %s\n", options.packPath.c_str(), error.message().c_str());
+            return false;
+        }
+        stats.packWritten = true;
+        printf("%s: %zu entries (%zu LZ4), %llu bytes\n", options.packPath.c_str(), summary.entryCount,
+               summary.compressedCount, static_cast<unsigned long long>(summary.packBytes));
+    }
+    return stats.failedCount == 0;
+}
@@ -0,0 +1,305 @@
+#include "AssetFileSystem.h"
+
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+#include "Lz4.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Fichero entero mapeado en memoria, solo lectura
+class MappedFile {
+public:
+    MappedFile() : data(nullptr), size(0) {
+    }
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if (data) {
+            UnmapViewOfFile(data);
+        }
+#else
+        if (data) {
+            munmap(const_cast<uint8_t *>(data), size);
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile &) = delete;
+
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool open(const std::string &path) {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER fileSize;
+        GetFileSizeEx(file, &fileSize);
+        size = static_cast<size_t>(fileSize.QuadPart);
+        HANDLE mapping = size ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+        data = mapping ? static_cast<const uint8_t *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+        // La vista sigue valida sin los handles
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat status;
+        if (fstat(fd, &status) != 0) {
+            ::close(fd);
+            return false;
+        }
+        size = static_cast<size_t>(status.st_size);
+        void *mapped = size ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+        // El mapeo sigue valido sin el descriptor
+        ::close(fd);
+        data = mapped == MAP_FAILED ? nullptr : static_cast<const uint8_t *>(mapped);
+#endif
+        // Un fichero vacio es valido pero no se puede mapear
+        if (!data) {
+            size = 0;
+        }
+        return data || size == 0;
+    }
+
+    const uint8_t *data;
+    size_t size;
+};
+
+const uint8_t *AssetData::data() const {
+    return bytes;
+}
+
+size_t AssetData::size() const {
+    return length;
+}
+
+bool AssetData::empty() const {
+    return length == 0;
+}
+
+bool AssetData::isZeroCopy() const {
+    return zeroCopy;
+}
+
+void AssetData::prefetch(size_t offset) const {
+    if (!mapped || offset >= length) {
+        return;
+    }
+#ifdef _WIN32
+    WIN32_MEMORY_RANGE_ENTRY range = {const_cast<uint8_t *>(bytes) + offset, length - offset};
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+    // madvise necesita una direccion alineada a pagina
+    const uintptr_t start = reinterpret_cast<uintptr_t>(bytes + offset);
+    const uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const uintptr_t aligned = start / page * page;
+    madvise(reinterpret_cast<void *>(aligned), length - offset + (start - aligned), MADV_WILLNEED);
+#endif
+}
+
+AssetFileSystem::AssetFileSystem() : packData(nullptr), packSize(0), entries(nullptr), entryCount(0),
+                                     looseFirst(false), looseEnabled(true), fileOpenCount(0), packReadCount(0),
+                                     zeroCopyCount(0), looseReadCount(0) {
+}
+
+AssetFileSystem::~AssetFileSystem() {
+    unmount();
+}
+
+bool AssetFileSystem::mount(const std::string &packPath) {
+    unmount();
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(packPath)) {
+        return false;
+    }
+    fileOpenCount++;
+
+    const AssetPackHeader *header = reinterpret_cast<const AssetPackHeader *>(file->data);
+    bool valid = file->size >= sizeof(AssetPackHeader) && header->magic == ASSET_PACK_MAGIC &&
+                 header->version == ASSET_PACK_VERSION &&
+                 header->entryCount <= (file->size - sizeof(AssetPackHeader)) / sizeof(AssetPackEntry);
+    const AssetPackEntry *table = reinterpret_cast<const AssetPackEntry *>(file->data + sizeof(AssetPackHeader));
+    for (uint32_t i = 0; valid && i < header->entryCount; i++) {
+        const AssetPackEntry &entry = table[i];
+        valid = entry.offset <= file->size && entry.storedSize <= file->size - entry.offset &&
+                entry.nameOffset <= file->size && entry.nameSize <= file->size - entry.nameOffset &&
+                (entry.compression == ASSET_COMPRESSION_LZ4 ||
+                 (entry.compression == ASSET_COMPRESSION_NONE && entry.storedSize == entry.size)) &&
+                (i == 0 || table[i - 1].pathHash <= entry.pathHash);
+    }
+    if (!valid) {
+        printf("%s is not a valid asset pack\n", packPath.c_str());
+        return false;
+    }
+
+    pack = file;
+    packData = file->data;
+    packSize = file->size;
+    entries = table;
+    entryCount = header->entryCount;
+    return true;
+}
+
+void AssetFileSystem::unmount() {
+    // Los AssetData que aun apunten al paquete mantienen el mapeo
+    pack.reset();
+    packData = nullptr;
+    packSize = 0;
+    entries = nullptr;
+    entryCount = 0;
+}
+
+bool AssetFileSystem::isMounted() const {
+    return packData != nullptr;
+}
+
+void AssetFileSystem::setLooseFirst(bool looseFirst) {
+    this->looseFirst = looseFirst;
+}
+
+void AssetFileSystem::setLooseEnabled(bool looseEnabled) {
+    this->looseEnabled = looseEnabled;
+}
+
+void AssetFileSystem::setLooseDirectory(const std::string &directory) {
+    looseDirectory = directory;
+}
+
+std::string AssetFileSystem::loosePath(const std::string &path) const {
+    if (looseDirectory.empty()) {
+        return path;
+    }
+    // Solo las rutas de asset relativas; una absoluta se respeta aunque este dentro del directorio actual
+    if (std::filesystem::path(path).is_absolute()) {
+        return path;
+    }
+    return (std::filesystem::path(looseDirectory) / normalizeAssetPath(path)).string();
+}
+
+const AssetPackEntry *AssetFileSystem::find(const std::string &path) const {
+    if (!entryCount) {
+        return nullptr;
+    }
+    const std::string name = normalizeAssetPath(path);
+    const uint64_t hash = hashAssetPath(name);
+    const AssetPackEntry *end = entries + entryCount;
+    const AssetPackEntry *found = std::lower_bound(entries, end, hash, [](const AssetPackEntry &entry, uint64_t key) {
+        return entry.pathHash < key;
+    });
+    // Un hash igual no basta: la ruta tiene que coincidir
+    for (; found != end && found->pathHash == hash; found++) {
+        if (found->nameSize == name.size() && memcmp(packData + found->nameOffset, name.data(), name.size()) == 0) {
+            return found;
+        }
+    }
+    return nullptr;
+}
+
+bool AssetFileSystem::exists(const std::string &path) const {
+    std::error_code error;
+    return find(path) || (looseEnabled && std::filesystem::is_regular_file(loosePath(path), error));
+}
+
+bool AssetFileSystem::readLoose(const std::string &path, AssetData &data) {
+    if (!looseEnabled) {
+        return false;
+    }
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(loosePath(path))) {
+        return false;
+    }
+    fileOpenCount++;
+    looseReadCount++;
+    data.bytes = file->data;
+    data.length = file->size;
+    data.mapped = true;
+    data.zeroCopy = false;
+    data.owner = file;
+    return true;
+}
+
+bool AssetFileSystem::read(const std::string &path, AssetData &data) {
+    if (looseFirst && readLoose(path, data)) {
+        return true;
+    }
+    const AssetPackEntry *entry = find(path);
+    if (!entry) {
+        return !looseFirst && readLoose(path, data);
+    }
+
+    packReadCount++;
+    const uint8_t *stored = packData + entry->offset;
+    if (entry->compression == ASSET_COMPRESSION_NONE) {
+        zeroCopyCount++;
+        data.bytes = stored;
+        data.length = static_cast<size_t>(entry->size);
+        data.mapped = true;
+        data.zeroCopy = true;
+        data.owner = pack;
+        return true;
+    }
+
+    auto buffer = std::make_shared<std::vector<uint8_t> >(static_cast<size_t>(entry->size));
+    if (!lz4Decompress(stored, static_cast<size_t>(entry->storedSize), buffer->data(), buffer->size())) {
+        printf("%s: corrupted asset pack entry\n", path.c_str());
+        return false;
+    }
+    data.bytes = buffer->data();
+    data.length = buffer->size();
+    data.mapped = false;
+    data.zeroCopy = false;
+    data.owner = buffer;
+    return true;
+}
+
+size_t AssetFileSystem::getEntryCount() const {
+    return entryCount;
+}
+
+size_t AssetFileSystem::getFileOpenCount() const {
+    return fileOpenCount;
+}
+
+size_t AssetFileSystem::getPackReadCount() const {
+    return packReadCount;
+}
+
+size_t AssetFileSystem::getZeroCopyCount() const {
+    return zeroCopyCount;
+}
+
+size_t AssetFileSystem::getLooseReadCount() const {
+    return looseReadCount;
+}
+
+void AssetFileSystem::resetCounters() {
+    fileOpenCount = isMounted() ? 1 : 0;
+    packReadCount = 0;
+    zeroCopyCount = 0;
+    looseReadCount = 0;
+}
+
+AssetFileSystem &assetFileSystem() {
+    static AssetFileSystem fileSystem;
+    return fileSystem;
+}
@@ -0,0 +1,17 @@
+#include "AssetFileSystem.h"
+
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+#include <filesystem>
+
+SDL_Surface *loadAssetImage(const std::string &path) {
+    AssetData data;
+    if (!assetFileSystem().read(path, data)) {
+        SDL_SetError("Unable to open %s", path.c_str());
+        return nullptr;
+    }
+    // La extension orienta al decodificador (TGA no tiene numero magico)
+    const std::string extension = std::filesystem::path(path).extension().string();
+    return IMG_LoadTyped_IO(SDL_IOFromConstMem(data.data(), data.size()), true,
+                            extension.empty() ? nullptr : extension.c_str() + 1);
+}
@@ -0,0 +1,139 @@
+#include "AssetPack.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include "Lz4.h"
+
+static constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+static constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+std::string normalizeAssetPath(const std::string &path) {
+    std::filesystem::path normalized = std::filesystem::path(path).lexically_normal();
+    if (normalized.is_absolute()) {
+        std::error_code error;
+        const std::filesystem::path relative = normalized.lexically_relative(std::filesystem::current_path(error));
+        if (!error && !relative.empty() && *relative.begin() != "..") {
+            normalized = relative;
+        }
+    }
+    return normalized.generic_string();
+}
+
+uint64_t hashAssetPath(const std::string &path) {
+    uint64_t hash = FNV_OFFSET;
+    for (const char c: normalizeAssetPath(path)) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * FNV_PRIME;
+    }
+    return hash;
+}
+
+static uint64_t alignOffset(uint64_t offset, uint32_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+static bool readFile(const std::string &path, std::vector<uint8_t> &bytes) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return false;
+    }
+    bytes.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    return static_cast<bool>(file.read(reinterpret_cast<char *>(bytes.data()),
+                                       static_cast<std::streamsize>(bytes.size())));
+}
+
+bool writeAssetPack(const std::string &path, const std::vector<AssetPackInput> &files, AssetPackSummary *summary) {
+    struct Payload {
+        AssetPackEntry entry;
+        std::string name;
+        std::vector<uint8_t> bytes;
+    };
+    std::vector<Payload> payloads(files.size());
+    AssetPackSummary totals;
+    for (size_t i = 0; i < files.size(); i++) {
+        Payload &payload = payloads[i];
+        payload.name = normalizeAssetPath(files[i].name);
+        if (!readFile(files[i].sourcePath, payload.bytes)) {
+            printf("Unable to read %s\n", files[i].sourcePath.c_str());
+            return false;
+        }
+        AssetPackEntry &entry = payload.entry;
+        entry = {};
+        entry.pathHash = hashAssetPath(payload.name);
+        entry.size = payload.bytes.size();
+        const bool texture = std::filesystem::path(payload.name).extension() == ".tex";
+        entry.alignment = texture ? ASSET_PACK_TEXTURE_ALIGNMENT : ASSET_PACK_ALIGNMENT;
+        if (!texture && !payload.bytes.empty()) {
+            std::vector<uint8_t> compressed(lz4CompressBound(payload.bytes.size()));
+            const size_t compressedSize = lz4Compress(payload.bytes.data(), payload.bytes.size(), compressed.data(),
+                                                      compressed.size());
+            if (compressedSize && compressedSize <= payload.bytes.size() - payload.bytes.size() / 8) {
+                compressed.resize(compressedSize);
+                payload.bytes.swap(compressed);
+                entry.compression = ASSET_COMPRESSION_LZ4;
+                totals.compressedCount++;
+            }
+        }
+        entry.storedSize = payload.bytes.size();
+        totals.originalBytes += entry.size;
+        totals.storedBytes += entry.storedSize;
+    }
+
+    // Tabla ordenada: el lector busca por hash con busqueda binaria y desempata por ruta
+    std::sort(payloads.begin(), payloads.end(), [](const Payload &a, const Payload &b) {
+        return a.entry.pathHash != b.entry.pathHash ? a.entry.pathHash < b.entry.pathHash : a.name < b.name;
+    });
+    for (size_t i = 1; i < payloads.size(); i++) {
+        if (payloads[i].name == payloads[i - 1].name) {
+            printf("%s: %s is packed twice\n", path.c_str(), payloads[i].name.c_str());
+            return false;
+        }
+    }
+
+    AssetPackHeader header = {ASSET_PACK_MAGIC, ASSET_PACK_VERSION, static_cast<uint32_t>(payloads.size()), 0};
+    uint64_t offset = sizeof(header) + payloads.size() * sizeof(AssetPackEntry);
+    for (Payload &payload: payloads) {
+        payload.entry.nameOffset = offset;
+        payload.entry.nameSize = static_cast<uint32_t>(payload.name.size());
+        offset += payload.name.size();
+    }
+    const uint64_t namesEnd = offset;
+    for (Payload &payload: payloads) {
+        payload.entry.offset = alignOffset(offset, payload.entry.alignment);
+        offset = payload.entry.offset + payload.entry.storedSize;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        printf("Unable to write %s\n", path.c_str());
+        return false;
+    }
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    for (const Payload &payload: payloads) {
+        file.write(reinterpret_cast<const char *>(&payload.entry), sizeof(payload.entry));
+    }
+    for (const Payload &payload: payloads) {
+        file.write(payload.name.data(), static_cast<std::streamsize>(payload.name.size()));
+    }
+    const std::vector<char> padding(ASSET_PACK_TEXTURE_ALIGNMENT, 0);
+    uint64_t written = namesEnd;
+    for (const Payload &payload: payloads) {
+        file.write(padding.data(), static_cast<std::streamsize>(payload.entry.offset - written));
+        file.write(reinterpret_cast<const char *>(payload.bytes.data()),
+                   static_cast<std::streamsize>(payload.bytes.size()));
+        written = payload.entry.offset + payload.entry.storedSize;
+    }
+    if (!file) {
+        printf("Unable to write %s\n", path.c_str());
+        return false;
+    }
+    totals.entryCount = payloads.size();
+    totals.packBytes = written;
+    if (summary) {
+        *summary = totals;
+    }
+    return true;
+}
@@ -0,0 +1,177 @@
+#include "BenchmarkReport.h"
+
+#include <SDL3/SDL.h>
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+BenchmarkReport::BenchmarkReport() : queries{}, queryPending{}, frameIndex(0), warmupFrames(0), startNS(0), endNS(0),
+                                     frameStartNS(0), width(0), height(0), llvmpipeThreads(0),
+                                     mainWaitMs(0.0), renderWaitMs(0.0), textureHitRate(0.0),
+                                     textureResidentBytes(0), programHits(0), programMisses(0),
+                                     programCompileMs(0.0), programSavedMs(0.0) {
+}
+
+BenchmarkReport::~BenchmarkReport() {
+    if (queries[0]) {
+        glDeleteQueries(QUERY_COUNT, queries);
+    }
+}
+
+void BenchmarkReport::begin(int width, int height, int llvmpipeThreads, int warmupFrames) {
+    this->width = width;
+    this->height = height;
+    this->llvmpipeThreads = llvmpipeThreads;
+    this->warmupFrames = warmupFrames;
+
+    renderer = reinterpret_cast<const char *>(glGetString(GL_RENDERER));
+    version = reinterpret_cast<const char *>(glGetString(GL_VERSION));
+
+    glGenQueries(QUERY_COUNT, queries);
+}
+
+void BenchmarkReport::beginFrame() {
+    const int slot = frameIndex % QUERY_COUNT;
+    // El slot se reutiliza cada QUERY_COUNT frames; en ese punto la query ya suele estar lista
+    collectQuery(slot);
+
+    frameStartNS = SDL_GetTicksNS();
+    if (frameIndex == warmupFrames) {
+        startNS = frameStartNS;
+    }
+    glBeginQuery(GL_TIME_ELAPSED, queries[slot]);
+}
+
+void BenchmarkReport::recordSimTicks(int ticks) {
+    if (frameIndex >= warmupFrames) {
+        simTicks.push_back(ticks);
+    }
+}
+
+void BenchmarkReport::endFrame() {
+    const int slot = frameIndex % QUERY_COUNT;
+    glEndQuery(GL_TIME_ELAPSED);
+    queryPending[slot] = frameIndex >= warmupFrames;
+    if (!queryPending[slot]) {
+        // Descartar el resultado sin esperar por el
+        frameIndex++;
+        return;
+    }
+
+    cpuMs.push_back(static_cast<double>(SDL_GetTicksNS() - frameStartNS) / 1000000.0);
+    frameIndex++;
+}
+
+void BenchmarkReport::setThreadWaits(double mainWaitMs, double renderWaitMs) {
+    this->mainWaitMs = mainWaitMs;
+    this->renderWaitMs = renderWaitMs;
+}
+
+void BenchmarkReport::setTextureCache(double hitRate, size_t residentBytes) {
+    textureHitRate = hitRate;
+    textureResidentBytes = residentBytes;
+}
+
+void BenchmarkReport::setProgramCache(size_t hits, size_t misses, double compileMs, double savedMs) {
+    programHits = hits;
+    programMisses = misses;
+    programCompileMs = compileMs;
+    programSavedMs = savedMs;
+}
+
+void BenchmarkReport::finish() {
+    glFinish();
+    endNS = SDL_GetTicksNS();
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        collectQuery((frameIndex + i) % QUERY_COUNT);
+    }
+}
+
+void BenchmarkReport::collectQuery(int slot) {
+    if (!queryPending[slot]) {
+        return;
+    }
+    GLuint64 elapsed = 0;
+    glGetQueryObjectui64v(queries[slot], GL_QUERY_RESULT, &elapsed);
+    gpuMs.push_back(static_cast<double>(elapsed) / 1000000.0);
+    queryPending[slot] = false;
+}
+
+static void writeStats(std::ostringstream &out, const char *name, std::vector<double> samples) {
+    out << "  \"" << name << "\": {";
+    if (samples.empty()) {
+        out << "}";
+        return;
+    }
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (const double s: samples) {
+        sum += s;
+    }
+    const size_t p95 = std::min(samples.size() - 1, samples.size() * 95 / 100);
+    out << "\"avg\": " << sum / static_cast<double>(samples.size())
+            << ", \"min\": " << samples.front()
+            << ", \"p50\": " << samples[samples.size() / 2]
+            << ", \"p95\": " << samples[p95]
+            << ", \"max\": " << samples.back() << "}";
+}
+
+static std::string escape(const std::string &value) {
+    std::string escaped;
+    for (const char c: value) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+std::string BenchmarkReport::toJson() const {
+    const int measuredFrames = static_cast<int>(cpuMs.size());
+    const double seconds = measuredFrames > 0 ? static_cast<double>(endNS - startNS) / 1000000000.0 : 0.0;
+
+    std::ostringstream out;
+    out << "{\n";
+    out << "  \"renderer\": \"" << escape(renderer) << "\",\n";
+    out << "  \"version\": \"" << escape(version) << "\",\n";
+    out << "  \"width\": " << width << ",\n";
+    out << "  \"height\": " << height << ",\n";
+    out << "  \"frames\": " << measuredFrames << ",\n";
+    out << "  \"warmupFrames\": " << std::min(frameIndex, warmupFrames) << ",\n";
+    out << "  \"llvmpipeThreads\": " << llvmpipeThreads << ",\n";
+    out << "  \"seconds\": " << seconds << ",\n";
+    out << "  \"fps\": " << (seconds > 0.0 ? measuredFrames / seconds : 0.0) << ",\n";
+    out << "  \"mainThreadWaitMs\": " << mainWaitMs << ",\n";
+    out << "  \"renderThreadWaitMs\": " << renderWaitMs << ",\n";
+    out << "  \"textureCache\": {\"hitRate\": " << textureHitRate << ", \"residentBytes\": " << textureResidentBytes
+            << "},\n";
+    out << "  \"programCache\": {\"hits\": " << programHits << ", \"misses\": " << programMisses
+            << ", \"compileMs\": " << programCompileMs << ", \"savedMs\": " << programSavedMs << "},\n";
+    writeStats(out, "cpuMs", cpuMs);
+    out << ",\n";
+    writeStats(out, "gpuMs", gpuMs);
+    out << ",\n";
+    writeStats(out, "simTicksPerFrame", simTicks);
+    out << "\n}\n";
+    return out.str();
+}
+
+bool BenchmarkReport::write(const std::string &path) const {
+    const std::string json = toJson();
+    if (path.empty() || path == "-") {
+        std::cout << json;
+        return true;
+    }
+
+    std::ofstream file(path);
+    if (!file) {
+        printf("Unable to write benchmark report %s\n", path.c_str());
+        return false;
+    }
+    file << json;
+    return true;
+}
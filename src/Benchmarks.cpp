@@ -0,0 +1,1948 @@
+#include "Benchmarks.h"
+
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+#include <glad/glad.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <vector>
+#include <gtc/matrix_transform.hpp>
+
+#include "AssetCooker.h"
+#include "AssetFileSystem.h"
+#include "BlockCompression.h"
+#include "CompressedTexture.h"
+#include "ECS.h"
+#include "GpuLoader.h"
+#include "HeadlessContext.h"
+#include "JobSystem.h"
+#include "MipGenerator.h"
+#include "ProgramCache.h"
+#include "RenderCommands.h"
+#include "ShaderManager.h"
+#include "Spirv.h"
+#include "SurfaceUpload.h"
+#include "Texture.h"
+#include "TextureCache.h"
+#include "TextureFile.h"
+#include "TextureStreamer.h"
+#include "TransformSystem.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static double elapsedMs(uint64_t startNS) {
+    return static_cast<double>(SDL_GetTicksNS() - startNS) / 1000000.0;
+}
+
+// Copia un asset (del paquete o suelto) a un fichero suelto
+static bool extractAsset(const std::string &path, const std::string &destination) {
+    AssetData data;
+    if (!assetFileSystem().read(path, data)) {
+        printf("Unable to read %s\n", path.c_str());
+        return false;
+    }
+    std::ofstream file(destination, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(file);
+}
+
+// Potencias de dos hasta maxThreads, incluyendo siempre maxThreads
+static std::vector<int> threadCounts(int maxThreads) {
+    std::vector<int> counts;
+    for (int t = 1; t < maxThreads; t *= 2) {
+        counts.push_back(t);
+    }
+    counts.push_back(maxThreads);
+    return counts;
+}
+
+// 1000 raices x 10 hijos x 100 nietos ~= 1M transformaciones en 3 niveles
+static bool benchTransforms(const AppConfig &config, std::ostringstream &out) {
+    constexpr int ROOTS = 1000;
+    constexpr int CHILDREN = 10;
+    constexpr int GRANDCHILDREN = 100;
+    constexpr int ITERATIONS = 20;
+
+    TransformSystem transforms;
+    std::vector<TransformId> roots;
+    std::vector<TransformId> leaves;
+    for (int r = 0; r < ROOTS; r++) {
+        const TransformId root = transforms.create();
+        roots.push_back(root);
+        for (int c = 0; c < CHILDREN; c++) {
+            const TransformId child = transforms.create(root);
+            transforms.setPosition(child, glm::vec3(static_cast<float>(c), 0.0f, 0.0f));
+            for (int g = 0; g < GRANDCHILDREN; g++) {
+                const TransformId leaf = transforms.create(child);
+                transforms.setPosition(leaf, glm::vec3(0.0f, static_cast<float>(g), 0.0f));
+                leaves.push_back(leaf);
+            }
+        }
+    }
+    transforms.update();
+
+    out << "  \"transforms\": " << transforms.size() << ",\n";
+    out << "  \"results\": [\n";
+    bool first = true;
+    for (const int threads: threadCounts(config.threads)) {
+        JobSystem jobs(threads, config.pinThreads);
+        // Peor caso: todas las raices sucias -> se recalcula todo
+        double fullMs = 0.0;
+        for (int i = 0; i < ITERATIONS; i++) {
+            for (const TransformId root: roots) {
+                transforms.setRotation(root, glm::angleAxis(0.01f * i, glm::vec3(0.0f, 1.0f, 0.0f)));
+            }
+            const uint64_t start = SDL_GetTicksNS();
+            transforms.update(&jobs);
+            fullMs += elapsedMs(start);
+        }
+
+        // Caso tipico: 1% de hojas sucias
+        double partialMs = 0.0;
+        for (int i = 0; i < ITERATIONS; i++) {
+            for (size_t l = i; l < leaves.size(); l += 100) {
+                transforms.setScale(leaves[l], glm::vec3(1.0f + 0.01f * i));
+            }
+            const uint64_t start = SDL_GetTicksNS();
+            transforms.update(&jobs);
+            partialMs += elapsedMs(start);
+        }
+
+        // Cambio local: un subarbol (1 raiz y sus 1010 descendientes); solo se recorre su rango de cada nivel
+        double subtreeMs = 0.0;
+        for (int i = 0; i < ITERATIONS; i++) {
+            transforms.setRotation(roots[i * 37 % ROOTS], glm::angleAxis(0.02f * i, glm::vec3(0.0f, 1.0f, 0.0f)));
+            const uint64_t start = SDL_GetTicksNS();
+            transforms.update(&jobs);
+            subtreeMs += elapsedMs(start);
+        }
+
+        out << (first ? "" : ",\n") << "    {\"threads\": " << threads
+                << ", \"fullUpdateMs\": " << fullMs / ITERATIONS
+                << ", \"partialUpdateMs\": " << partialMs / ITERATIONS
+                << ", \"subtreeUpdateMs\": " << subtreeMs / ITERATIONS << "}";
+        first = false;
+    }
+    out << "\n  ]";
+    return true;
+}
+
+struct BenchPosition {
+    float x, y, z;
+};
+
+struct BenchVelocity {
+    float x, y, z;
+};
+
+struct BenchLifetime {
+    float seconds;
+};
+
+struct BenchFrozen {
+    uint8_t reason;
+};
+
+// 1M entidades con 3 componentes repartidas en 2 arquetipos (1 de cada 4 lleva un tag extra)
+static bool benchEcs(const AppConfig &config, std::ostringstream &out) {
+    constexpr int ENTITIES = 1000000;
+    constexpr int ITERATIONS = 20;
+    constexpr float DT = 1.0f / 60.0f;
+
+    World world;
+    std::vector<Entity> entities;
+    entities.reserve(ENTITIES);
+    uint64_t start = SDL_GetTicksNS();
+    for (int i = 0; i < ENTITIES; i++) {
+        const BenchPosition position = {static_cast<float>(i), 0.0f, 0.0f};
+        const BenchVelocity velocity = {1.0f, 0.5f, 0.25f};
+        const BenchLifetime lifetime = {10.0f};
+        entities.push_back(i % 4 == 0
+                               ? world.create(position, velocity, lifetime, BenchFrozen{0})
+                               : world.create(position, velocity, lifetime));
+    }
+    const double createMs = elapsedMs(start);
+
+    Query<BenchPosition, const BenchVelocity, BenchLifetime> query;
+    auto integrate = [](BenchPosition &position, const BenchVelocity &velocity, BenchLifetime &lifetime) {
+        position.x += velocity.x * DT;
+        position.y += velocity.y * DT;
+        position.z += velocity.z * DT;
+        lifetime.seconds -= DT;
+    };
+
+    out << "  \"entities\": " << world.getEntityCount() << ",\n";
+    out << "  \"archetypes\": " << world.getArchetypes().size() << ",\n";
+    out << "  \"createMs\": " << createMs << ",\n";
+    out << "  \"results\": [\n";
+    bool first = true;
+    for (const int threads: threadCounts(config.threads)) {
+        JobSystem jobs(threads, config.pinThreads);
+        double iterateMs = 0.0;
+        for (int i = 0; i < ITERATIONS; i++) {
+            start = SDL_GetTicksNS();
+            if (threads == 1) {
+                query.each(world, integrate);
+            } else {
+                query.parallelEach(world, jobs, integrate);
+            }
+            iterateMs += elapsedMs(start);
+        }
+        out << (first ? "" : ",\n") << "    {\"threads\": " << threads
+                << ", \"iterateMs\": " << iterateMs / ITERATIONS << "}";
+        first = false;
+    }
+    out << "\n  ],\n";
+
+    // Cambios estructurales diferidos: 1% de las entidades cambia de arquetipo, otro 1% se destruye y se
+    // crean tantas como se destruyen
+    CommandBuffer commands;
+    start = SDL_GetTicksNS();
+    size_t frozen = 0;
+    for (size_t i = 1; i < entities.size(); i += 100) {
+        commands.add(entities[i], BenchFrozen{1});
+        commands.destroy(entities[i + 1]);
+        commands.create(BenchPosition{0.0f, 0.0f, 0.0f}, BenchVelocity{0.0f, 0.0f, 0.0f}, BenchLifetime{1.0f});
+        frozen++;
+    }
+    const double recordMs = elapsedMs(start);
+    const size_t commandCount = commands.size();
+    const uint32_t structureVersion = world.getStructureVersion();
+    start = SDL_GetTicksNS();
+    commands.apply(world);
+    const double applyMs = elapsedMs(start);
+    size_t applied = 0;
+    Query<const BenchFrozen> frozenQuery;
+    frozenQuery.each(world, [&](const BenchFrozen &value) {
+        applied += value.reason == 1;
+    });
+    out << "  \"commands\": " << commandCount << ",\n";
+    out << "  \"recordMs\": " << recordMs << ",\n";
+    out << "  \"applyMs\": " << applyMs;
+    return applied == frozen && world.getEntityCount() == static_cast<size_t>(ENTITIES) &&
+           world.getStructureVersion() != structureVersion && commands.size() == 0;
+}
+
+// Trabajo de CPU sin acceso a memoria para medir escalado puro
+static float busyWork(uint32_t seed) {
+    float x = static_cast<float>(seed & 1023) * 0.001f;
+    for (int i = 0; i < 64; i++) {
+        x = x * 0.999f + 0.5f / (1.0f + x);
+    }
+    return x;
+}
+
+static bool benchJobs(const AppConfig &config, std::ostringstream &out) {
+    constexpr int BATCH = 4000;
+    constexpr int BATCHES = 50;
+    constexpr int CHAIN = 1000;
+    constexpr uint32_t ELEMENTS = 1u << 19;
+    constexpr uint32_t GRAIN = 1024;
+    constexpr int ITERATIONS = 10;
+
+    // Coste por tarea: lotes de tareas vacias (caben en el deque) y parallelFor con grain 1
+    double scheduleNs = 0.0;
+    double parallelForNs = 0.0;
+    double chainUs = 0.0;
+    uint64_t steals = 0;
+    {
+        JobSystem jobs(config.threads, config.pinThreads);
+        const Job empty = {[](void *, uint32_t, uint32_t) {}, nullptr, 0, 0, 0, nullptr};
+        uint64_t start = SDL_GetTicksNS();
+        for (int b = 0; b < BATCHES; b++) {
+            JobCounter counter;
+            for (int i = 0; i < BATCH; i++) {
+                jobs.schedule(empty, &counter);
+            }
+            jobs.wait(counter);
+        }
+        scheduleNs = elapsedMs(start) * 1000000.0 / (BATCH * BATCHES);
+
+        start = SDL_GetTicksNS();
+        std::atomic<uint32_t> visited(0);
+        for (int b = 0; b < BATCHES; b++) {
+            jobs.parallelFor(0, BATCH, 1, [&](uint32_t begin, uint32_t end) {
+                visited.fetch_add(end - begin, std::memory_order_relaxed);
+            });
+        }
+        parallelForNs = elapsedMs(start) * 1000000.0 / (BATCH * BATCHES);
+        if (visited.load() != static_cast<uint32_t>(BATCH * BATCHES)) {
+            SDL_Log("parallelFor visited %u of %d elements", visited.load(), BATCH * BATCHES);
+            return false;
+        }
+
+        // Cadena de dependencias: cada tarea espera al contador de la anterior
+        std::unique_ptr<JobCounter[]> counters(new JobCounter[CHAIN]);
+        int order = 0;
+        bool ordered = true;
+        struct ChainStep {
+            int *order;
+            bool *ordered;
+            int expected;
+        };
+        std::vector<ChainStep> steps(CHAIN);
+        start = SDL_GetTicksNS();
+        for (int i = 0; i < CHAIN; i++) {
+            steps[i] = {&order, &ordered, i};
+            const Job step = {
+                [](void *data, uint32_t, uint32_t) {
+                    const ChainStep *chainStep = static_cast<ChainStep *>(data);
+                    *chainStep->ordered &= *chainStep->order == chainStep->expected;
+                    (*chainStep->order)++;
+                },
+                &steps[i], 0, 0, 0, nullptr
+            };
+            jobs.schedule(step, &counters[i], i > 0 ? &counters[i - 1] : nullptr);
+        }
+        jobs.wait(counters[CHAIN - 1]);
+        chainUs = elapsedMs(start) * 1000.0 / CHAIN;
+        if (!ordered || order != CHAIN) {
+            SDL_Log("Dependency chain ran out of order");
+            return false;
+        }
+        steals = jobs.getStealCount();
+    }
+    out << "  \"scheduleNsPerTask\": " << scheduleNs << ",\n";
+    out << "  \"parallelForNsPerTask\": " << parallelForNs << ",\n";
+    out << "  \"dependencyChainUsPerTask\": " << chainUs << ",\n";
+    out << "  \"steals\": " << steals << ",\n";
+    out << "  \"cores\": " << SDL_GetNumLogicalCPUCores() << ",\n";
+
+    // Escalado de 1 a 32 hilos con parallelFor sobre trabajo de CPU
+    std::vector<float> results(ELEMENTS / GRAIN);
+    out << "  \"results\": [\n";
+    double baseMs = 0.0;
+    bool first = true;
+    for (const int threads: threadCounts(32)) {
+        JobSystem jobs(threads, config.pinThreads);
+        double ms = 0.0;
+        for (int i = 0; i < ITERATIONS; i++) {
+            const uint64_t start = SDL_GetTicksNS();
+            // Cada elemento depende del anterior: asi el compilador no vectoriza el bucle en el
+            // camino directo (1 hilo) y el de tareas, y ambos ejecutan el mismo codigo
+            jobs.parallelFor(0, ELEMENTS, GRAIN, [&](uint32_t begin, uint32_t end) {
+                float sum = 0.0f;
+                for (uint32_t e = begin; e < end; e++) {
+                    sum += busyWork(e + static_cast<uint32_t>(sum));
+                }
+                results[begin / GRAIN] = sum;
+            });
+            ms += elapsedMs(start);
+        }
+        ms /= ITERATIONS;
+        if (threads == 1) {
+            baseMs = ms;
+        }
+        out << (first ? "" : ",\n") << "    {\"threads\": " << threads << ", \"parallelForMs\": " << ms
+                << ", \"speedup\": " << baseMs / ms << ", \"steals\": " << jobs.getStealCount() << "}";
+        first = false;
+    }
+    out << "\n  ]";
+    return true;
+}
+
+// Draws ordenados por material y VAO, como los deja RenderSystem
+static std::vector<DrawItem> makeDraws(int count, const Material *materials, int materialCount) {
+    std::vector<DrawItem> draws(count);
+    for (int i = 0; i < count; i++) {
+        const int group = i * materialCount * 8 / count;
+        draws[i] = {
+            static_cast<unsigned int>(1 + group % 8), 3, &materials[group / 8],
+            glm::scale(glm::mat4(1.0f), glm::vec3(0.0f)), glm::vec3(static_cast<float>(i & 255) / 255.0f)
+        };
+    }
+    return draws;
+}
+
+// Programa minimo con los mismos uniforms que cube.frag; los triangulos son degenerados
+// para medir el coste de los comandos y no el de rasterizar
+static unsigned int createBenchProgram() {
+    const char *vertexCode = "#version 410 core\n"
+            "layout (location = 0) in vec3 aPos;\n"
+            "uniform mat4 model;\n"
+            "void main() { gl_Position = model * vec4(aPos, 1.0); }\n";
+    const char *fragmentCode = "#version 410 core\n"
+            "uniform vec3 objectColor;\n"
+            "uniform vec3 lightColor;\n"
+            "uniform vec3 lightPos;\n"
+            "out vec4 FragColor;\n"
+            "void main() { FragColor = vec4(objectColor * lightColor + lightPos * 0.001, 1.0); }\n";
+    const unsigned int vertex = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertex, 1, &vertexCode, nullptr);
+    glCompileShader(vertex);
+    const unsigned int fragment = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragment, 1, &fragmentCode, nullptr);
+    glCompileShader(fragment);
+    const unsigned int program = glCreateProgram();
+    glAttachShader(program, vertex);
+    glAttachShader(program, fragment);
+    glLinkProgram(program);
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+    return program;
+}
+
+static bool benchRenderCommands(const AppConfig &config, std::ostringstream &out) {
+    constexpr int RECORD_DRAWS = 200000;
+    constexpr int REPLAY_DRAWS = 20000;
+    constexpr int ITERATIONS = 20;
+    constexpr int MATERIALS = 4;
+
+    // La grabacion no toca GL: handles y locations ficticios
+    Material materials[MATERIALS];
+    for (int m = 0; m < MATERIALS; m++) {
+        materials[m] = {static_cast<uint32_t>(m + 1), 0, 1, 2, 3};
+    }
+    const SceneLight light = {glm::vec3(1.2f, 1.0f, 2.0f), glm::vec3(1.0f)};
+    const std::vector<DrawItem> draws = makeDraws(RECORD_DRAWS, materials, MATERIALS);
+
+    out << "  \"recordDraws\": " << RECORD_DRAWS << ",\n";
+    out << "  \"record\": [\n";
+    bool first = true;
+    for (const int threads: threadCounts(config.threads)) {
+        JobSystem jobs(threads, config.pinThreads);
+        std::vector<RenderCommandList> lists(threads);
+        size_t commands = 0;
+        double ms = 0.0;
+        for (int i = 0; i < ITERATIONS; i++) {
+            const uint64_t start = SDL_GetTicksNS();
+            jobs.parallelFor(0, threads, 1, [&](uint32_t begin, uint32_t end) {
+                for (uint32_t t = begin; t < end; t++) {
+                    lists[t].reset();
+                    recordDraws(draws.data() + draws.size() * t / threads,
+                                draws.data() + draws.size() * (t + 1) / threads, light, lists[t]);
+                }
+            });
+            ms += elapsedMs(start);
+        }
+        ms /= ITERATIONS;
+        for (const RenderCommandList &list: lists) {
+            commands += list.getCommandCount();
+        }
+        out << (first ? "" : ",\n") << "    {\"threads\": " << threads << ", \"commands\": " << commands
+                << ", \"recordMs\": " << ms
+                << ", \"commandsPerSecondPerThread\": " << commands / (ms / 1000.0) / threads << "}";
+        first = false;
+    }
+    out << "\n  ],\n";
+
+    // Reproduccion: necesita un contexto GL real (EGL headless)
+    HeadlessContext context;
+    if (!context.create(64, 64)) {
+        out << "  \"replay\": null";
+        return true;
+    }
+    context.bindFramebuffer();
+
+    const unsigned int program = createBenchProgram();
+    Material material = createMaterial(program);
+    const float vertices[] = {0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f};
+    unsigned int vbo, vaos[8];
+    glGenBuffers(1, &vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glGenVertexArrays(8, vaos);
+    for (const unsigned int vao: vaos) {
+        glBindVertexArray(vao);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *) 0);
+        glEnableVertexAttribArray(0);
+    }
+
+    std::vector<DrawItem> replayDraws = makeDraws(REPLAY_DRAWS, &material, 1);
+    for (DrawItem &draw: replayDraws) {
+        draw.vao = vaos[draw.vao - 1];
+    }
+    RenderCommandList list;
+    recordDraws(replayDraws.data(), replayDraws.data() + replayDraws.size(), light, list);
+
+    // Una pasada de calentamiento (compilacion del programa en el driver)
+    replayRenderCommands(list);
+    glFinish();
+    const uint64_t start = SDL_GetTicksNS();
+    for (int i = 0; i < ITERATIONS; i++) {
+        replayRenderCommands(list);
+    }
+    glFinish();
+    const double ms = elapsedMs(start) / ITERATIONS;
+
+    out << "  \"replay\": {\"renderer\": \"" << reinterpret_cast<const char *>(glGetString(GL_RENDERER))
+            << "\", \"commands\": " << list.getCommandCount() << ", \"replayMs\": " << ms
+            << ", \"nsPerCommand\": " << ms * 1000000.0 / static_cast<double>(list.getCommandCount()) << "}";
+
+    glDeleteVertexArrays(8, vaos);
+    glDeleteBuffers(1, &vbo);
+    glDeleteProgram(program);
+    return true;
+}
+
+// Carga de texturas: streaming (decodificacion en workers + PBO con presupuesto) frente a carga sincrona
+static bool benchTextures(const AppConfig &config, std::ostringstream &out) {
+    constexpr int TEXTURE_COUNT = 500;
+    constexpr int SYNC_COUNT = 20;
+    constexpr int MAX_FRAMES = 100000;
+    const char *paths[] = {"assets/container.jpg", "assets/awesomeface.png"};
+
+    HeadlessContext context;
+    if (!context.create(64, 64)) {
+        return false;
+    }
+    context.bindFramebuffer();
+
+    JobSystem jobs(config.threads, config.pinThreads);
+    TextureStreamer streamer;
+    streamer.begin(&jobs, static_cast<size_t>(config.uploadBudgetKB) * 1024);
+
+    const uint64_t start = SDL_GetTicksNS();
+    for (int i = 0; i < TEXTURE_COUNT; i++) {
+        streamer.request(paths[i % 2]);
+    }
+    const double requestMs = elapsedMs(start);
+
+    // Cada frame: update del streamer + clear, y glFinish para que el coste de la subida caiga en su frame
+    std::vector<double> frameMs;
+    while (streamer.getPendingCount() > 0 && static_cast<int>(frameMs.size()) < MAX_FRAMES) {
+        const uint64_t frameStart = SDL_GetTicksNS();
+        streamer.update();
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glFinish();
+        frameMs.push_back(elapsedMs(frameStart));
+    }
+    const double streamMs = elapsedMs(start);
+    streamer.waitForDecodes();
+
+    double frameSum = 0.0;
+    double frameMax = 0.0;
+    for (const double ms: frameMs) {
+        frameSum += ms;
+        frameMax = std::max(frameMax, ms);
+    }
+    const size_t loaded = streamer.getReadyCount();
+    out << "  \"uploadBudgetKB\": " << config.uploadBudgetKB << ",\n";
+    out << "  \"streamed\": {\"textures\": " << loaded << ", \"failed\": " << streamer.getFailedCount()
+            << ", \"frames\": " << frameMs.size() << ", \"requestMs\": " << requestMs
+            << ", \"totalMs\": " << streamMs
+            << ", \"texturesPerSecond\": " << static_cast<double>(loaded) / (streamMs / 1000.0)
+            << ", \"avgFrameMs\": " << (frameMs.empty() ? 0.0 : frameSum / static_cast<double>(frameMs.size()))
+            << ", \"maxFrameMs\": " << frameMax << "},\n";
+    streamer.destroy();
+
+    // Referencia: Texture carga y sube en el propio frame, que es lo que el streaming evita
+    double syncSum = 0.0;
+    double syncMax = 0.0;
+    for (int i = 0; i < SYNC_COUNT; i++) {
+        const uint64_t frameStart = SDL_GetTicksNS();
+        Texture texture(paths[i % 2]);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glFinish();
+        const double ms = elapsedMs(frameStart);
+        syncSum += ms;
+        syncMax = std::max(syncMax, ms);
+    }
+    out << "  \"sync\": {\"textures\": " << SYNC_COUNT
+            << ", \"texturesPerSecond\": " << SYNC_COUNT / (syncSum / 1000.0)
+            << ", \"avgFrameMs\": " << syncSum / SYNC_COUNT << ", \"maxFrameMs\": " << syncMax << "}";
+    return loaded + streamer.getFailedCount() == TEXTURE_COUNT;
+}
+
+// Hilo de carga con contexto compartido: latencia hasta la publicacion y verificacion del contenido
+// leyendo desde el contexto principal, que solo ve los recursos tras la fence
+static bool benchLoader(const AppConfig &, std::ostringstream &out) {
+    constexpr int BUFFER_COUNT = 200;
+    constexpr int BUFFER_BYTES = 64 * 1024;
+    constexpr int TEXTURE_COUNT = 100;
+    constexpr int TEXTURE_SIZE = 256;
+    constexpr int PROGRAM_COUNT = 4;
+
+    HeadlessContext context;
+    if (!context.create(64, 64)) {
+        return false;
+    }
+    HeadlessContext loaderContext;
+    if (!loaderContext.createShared(context)) {
+        return false;
+    }
+    context.bindFramebuffer();
+
+    GpuLoader loader;
+    loader.start({nullptr, nullptr, &loaderContext});
+
+    struct Request {
+        GpuResourceId id;
+        GpuResourceType type;
+        uint8_t seed;
+        uint64_t startNS;
+    };
+    std::vector<Request> requests;
+    const uint64_t start = SDL_GetTicksNS();
+    for (int i = 0; i < BUFFER_COUNT; i++) {
+        const uint8_t seed = static_cast<uint8_t>(i * 7);
+        std::vector<uint8_t> data(BUFFER_BYTES);
+        for (int b = 0; b < BUFFER_BYTES; b++) {
+            data[b] = static_cast<uint8_t>(seed + b);
+        }
+        requests.push_back({0, GPU_RESOURCE_BUFFER, seed, SDL_GetTicksNS()});
+        requests.back().id = loader.loadBuffer(GL_ARRAY_BUFFER, std::move(data));
+    }
+    for (int i = 0; i < TEXTURE_COUNT; i++) {
+        const uint8_t seed = static_cast<uint8_t>(i * 13);
+        SDL_Surface *surface = SDL_CreateSurface(TEXTURE_SIZE, TEXTURE_SIZE, SDL_PIXELFORMAT_RGBA32);
+        if (!surface) {
+            return false;
+        }
+        for (int y = 0; y < TEXTURE_SIZE; y++) {
+            uint8_t *row = static_cast<uint8_t *>(surface->pixels) + y * surface->pitch;
+            for (int x = 0; x < TEXTURE_SIZE * 4; x++) {
+                row[x] = static_cast<uint8_t>(seed + x + y);
+            }
+        }
+        requests.push_back({0, GPU_RESOURCE_TEXTURE, seed, SDL_GetTicksNS()});
+        requests.back().id = loader.loadTexture(surface);
+    }
+    for (int i = 0; i < PROGRAM_COUNT; i++) {
+        requests.push_back({0, GPU_RESOURCE_PROGRAM, 0, SDL_GetTicksNS()});
+        requests.back().id = loader.loadProgram("shaders/cube.vert", "shaders/cube.frag");
+    }
+
+    // "Frames" del hilo de render: publish + clear; se anota cuando ve cada recurso
+    std::vector<double> latencyMs(requests.size(), -1.0);
+    double publishMaxMs = 0.0;
+    int frames = 0;
+    while (loader.getPendingCount() > 0) {
+        const uint64_t frameStart = SDL_GetTicksNS();
+        loader.publish();
+        publishMaxMs = std::max(publishMaxMs, elapsedMs(frameStart));
+        for (size_t i = 0; i < requests.size(); i++) {
+            if (latencyMs[i] < 0.0 && loader.isReady(requests[i].id)) {
+                latencyMs[i] = elapsedMs(requests[i].startNS);
+            }
+        }
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glFinish();
+        frames++;
+    }
+    const double totalMs = elapsedMs(start);
+    for (size_t i = 0; i < requests.size(); i++) {
+        if (latencyMs[i] < 0.0) {
+            latencyMs[i] = elapsedMs(requests[i].startNS);
+        }
+    }
+
+    // Verificacion desde el contexto principal
+    int mismatches = 0;
+    std::vector<uint8_t> readback(std::max(BUFFER_BYTES, TEXTURE_SIZE * TEXTURE_SIZE * 4));
+    for (const Request &request: requests) {
+        const unsigned int name = loader.get(request.id);
+        if (!name) {
+            mismatches++;
+            continue;
+        }
+        if (request.type == GPU_RESOURCE_BUFFER) {
+            glBindBuffer(GL_ARRAY_BUFFER, name);
+            glGetBufferSubData(GL_ARRAY_BUFFER, 0, BUFFER_BYTES, readback.data());
+            for (int b = 0; b < BUFFER_BYTES; b++) {
+                if (readback[b] != static_cast<uint8_t>(request.seed + b)) {
+                    mismatches++;
+                    break;
+                }
+            }
+        } else if (request.type == GPU_RESOURCE_TEXTURE) {
+            glBindTexture(GL_TEXTURE_2D, name);
+            glPixelStorei(GL_PACK_ALIGNMENT, 4);
+            glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, readback.data());
+            for (int y = 0; y < TEXTURE_SIZE; y++) {
+                const uint8_t *row = readback.data() + y * TEXTURE_SIZE * 4;
+                if (row[0] != static_cast<uint8_t>(request.seed + y) ||
+                    row[TEXTURE_SIZE * 4 - 1] != static_cast<uint8_t>(request.seed + TEXTURE_SIZE * 4 - 1 + y)) {
+                    mismatches++;
+                    break;
+                }
+            }
+        } else {
+            int linked = 0;
+            glGetProgramiv(name, GL_LINK_STATUS, &linked);
+            mismatches += linked ? 0 : 1;
+        }
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    loader.stop();
+    loader.destroy();
+    loaderContext.destroy();
+
+    std::sort(latencyMs.begin(), latencyMs.end());
+    out << "  \"resources\": " << requests.size() << ",\n";
+    out << "  \"frames\": " << frames << ",\n";
+    out << "  \"totalMs\": " << totalMs << ",\n";
+    out << "  \"resourcesPerSecond\": " << static_cast<double>(requests.size()) / (totalMs / 1000.0) << ",\n";
+    out << "  \"publishLatencyMs\": {\"p50\": " << latencyMs[latencyMs.size() / 2]
+            << ", \"max\": " << latencyMs.back() << "},\n";
+    out << "  \"publishMaxMs\": " << publishMaxMs << ",\n";
+    out << "  \"mismatches\": " << mismatches;
+    return mismatches == 0;
+}
+
+// Codificador BC: PSNR y MPix/s por formato y numero de hilos sobre assets/container.jpg, y
+// diferencia maxima entre nuestro decodificador y el del driver al subir con glCompressedTexImage2D
+static bool benchBlockCompression(const AppConfig &config, std::ostringstream &out) {
+    const char *path = "assets/container.jpg";
+    SDL_Surface *surface = loadAssetImage(path);
+    SDL_Surface *converted = surface ? SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA32) : nullptr;
+    SDL_DestroySurface(surface);
+    if (!converted) {
+        printf("Unable to load image %s! SDL_image Error: %s\n", path, SDL_GetError());
+        return false;
+    }
+    const int width = converted->w;
+    const int height = converted->h;
+    std::vector<uint8_t> source(static_cast<size_t>(width) * height * 4);
+    for (int y = 0; y < height; y++) {
+        memcpy(source.data() + static_cast<size_t>(y) * width * 4,
+               static_cast<const uint8_t *>(converted->pixels) + static_cast<size_t>(y) * converted->pitch,
+               static_cast<size_t>(width) * 4);
+    }
+    SDL_DestroySurface(converted);
+
+    HeadlessContext context;
+    const bool hasContext = context.create(64, 64);
+    if (hasContext) {
+        context.bindFramebuffer();
+    }
+
+    const double megapixels = static_cast<double>(width) * height / 1000000.0;
+    std::vector<uint8_t> decoded(source.size());
+    std::vector<uint8_t> readback(source.size());
+    out << "  \"image\": \"" << path << "\",\n";
+    out << "  \"width\": " << width << ",\n";
+    out << "  \"height\": " << height << ",\n";
+    out << "  \"formats\": [\n";
+    for (int f = 0; f < BLOCK_FORMAT_COUNT; f++) {
+        const BlockFormat format = static_cast<BlockFormat>(f);
+        CompressedImage image = {format, width, height, {}};
+        image.levels.emplace_back(blockFormatLevelBytes(format, width, height));
+
+        out << (f ? ",\n" : "") << "    {\"format\": \"" << blockFormatName(format) << "\", \"encode\": [";
+        for (const int threads: threadCounts(config.threads)) {
+            JobSystem jobs(threads, config.pinThreads);
+            const uint64_t start = SDL_GetTicksNS();
+            compressImage(format, source.data(), width, height, image.levels[0].data(), &jobs);
+            const double ms = elapsedMs(start);
+            out << (threads > 1 ? ", " : "") << "{\"threads\": " << threads << ", \"ms\": " << ms
+                    << ", \"mpixPerSecond\": " << megapixels / (ms / 1000.0) << "}";
+        }
+        decompressImage(format, image.levels[0].data(), width, height, decoded.data());
+        out << "], \"bytes\": " << image.levels[0].size()
+                << ", \"psnr\": " << computePsnr(source.data(), decoded.data(), source.size() / 4,
+                                                   blockFormatChannels(format));
+
+        if (!hasContext) {
+            out << "}";
+            continue;
+        }
+        const bool supported = isBlockFormatSupported(format);
+        out << ", \"glSupported\": " << (supported ? "true" : "false");
+        if (supported) {
+            const uint64_t start = SDL_GetTicksNS();
+            unsigned int texture = createCompressedTexture(image);
+            glFinish();
+            const double uploadMs = elapsedMs(start);
+            glPixelStorei(GL_PACK_ALIGNMENT, 4);
+            glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, readback.data());
+            int maxDifference = 0;
+            for (size_t i = 0; i < readback.size(); i++) {
+                maxDifference = std::max(maxDifference, std::abs(readback[i] - decoded[i]));
+            }
+            glDeleteTextures(1, &texture);
+            out << ", \"uploadMs\": " << uploadMs << ", \"maxDifferenceVsDriver\": " << maxDifference;
+        }
+        out << "}";
+    }
+    out << "\n  ]";
+    return true;
+}
+
+// Saca el fichero de la cache de paginas para medir una carga en frio. Sin soporte (Windows) devuelve false
+static bool dropFileCache(const std::string &path) {
+#ifdef _WIN32
+    (void) path;
+    return false;
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    fdatasync(fd);
+    const bool dropped = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    close(fd);
+    return dropped;
+#endif
+}
+
+// Genera el .tex RGBA8 equivalente a lo que sube Texture (con todos los mips)
+static bool writeBenchTextureFile(const char *source, const std::string &path) {
+    SDL_Surface *surface = loadAssetImage(source);
+    SDL_Surface *converted = surface ? SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA32) : nullptr;
+    SDL_DestroySurface(surface);
+    if (!converted) {
+        printf("Unable to load image %s! SDL_image Error: %s\n", source, SDL_GetError());
+        return false;
+    }
+    std::vector<uint8_t> pixels(static_cast<size_t>(converted->w) * converted->h * 4);
+    for (int y = 0; y < converted->h; y++) {
+        memcpy(pixels.data() + static_cast<size_t>(y) * converted->w * 4,
+               static_cast<const uint8_t *>(converted->pixels) + static_cast<size_t>(y) * converted->pitch,
+               static_cast<size_t>(converted->w) * 4);
+    }
+    std::vector<std::vector<uint8_t> > levels;
+    generateMips(pixels.data(), converted->w, converted->h, MipOptions(), levels);
+    const bool written = writeTextureFile(path, TEXTURE_FILE_RGBA8, converted->w, converted->h, levels);
+    SDL_DestroySurface(converted);
+    return written;
+}
+
+// Carga de los assets con IMG_Load (decodificar + glGenerateMipmap) frente al .tex mapeado,
+// en frio (fuera de la cache de paginas) y en caliente. Cada medida termina con glFinish
+static bool benchTextureFile(const AppConfig &, std::ostringstream &out) {
+    constexpr int WARM_RUNS = 10;
+    const char *paths[] = {"assets/container.jpg", "assets/awesomeface.png"};
+
+    HeadlessContext context;
+    if (!context.create(64, 64)) {
+        return false;
+    }
+    context.bindFramebuffer();
+
+    const auto loadImage = [](const std::string &path) {
+        Texture texture(path);
+        glFinish();
+    };
+    const auto loadMapped = [](const std::string &path) {
+        MappedTextureFile file;
+        if (!file.open(path)) {
+            return;
+        }
+        unsigned int texture = createTextureFromFile(file);
+        glFinish();
+        glDeleteTextures(1, &texture);
+    };
+    const auto measure = [](const std::string &path, const auto &load, bool cold) {
+        double total = 0.0;
+        const int runs = cold ? 1 : WARM_RUNS;
+        for (int i = 0; i < runs; i++) {
+            if (cold) {
+                dropFileCache(path);
+            }
+            const uint64_t start = SDL_GetTicksNS();
+            load(path);
+            total += elapsedMs(start);
+        }
+        return total / runs;
+    };
+
+    bool ok = true;
+    bool coldSupported = false;
+    out << "  \"assets\": [\n";
+    for (size_t i = 0; i < std::size(paths); i++) {
+        // Las dos versiones sueltas en el mismo directorio: se mide decodificar frente a mapear
+        const std::filesystem::path source = paths[i];
+        const std::string stem = source.stem().string();
+        const std::string image = (std::filesystem::temp_directory_path() /
+                                   (stem + ".bench" + source.extension().string())).string();
+        const std::string textureFile = (std::filesystem::temp_directory_path() / (stem + ".bench.tex")).string();
+        if (!extractAsset(paths[i], image) || !writeBenchTextureFile(paths[i], textureFile)) {
+            ok = false;
+            continue;
+        }
+        coldSupported = dropFileCache(image) || coldSupported;
+
+        // Un primer pase en caliente deja compilados los caminos del driver
+        loadImage(image);
+        loadMapped(textureFile);
+        out << (i ? ",\n" : "") << "    {\"image\": \"" << paths[i] << "\", \"imageBytes\": "
+                << std::filesystem::file_size(image) << ", \"texBytes\": " << std::filesystem::file_size(textureFile)
+                << ", \"imgLoad\": {\"coldMs\": " << measure(image, loadImage, true)
+                << ", \"warmMs\": " << measure(image, loadImage, false) << "}"
+                << ", \"mapped\": {\"coldMs\": " << measure(textureFile, loadMapped, true)
+                << ", \"warmMs\": " << measure(textureFile, loadMapped, false) << "}}";
+        std::filesystem::remove(textureFile);
+        std::filesystem::remove(image);
+    }
+    out << "\n  ],\n";
+    out << "  \"coldSupported\": " << (coldSupported ? "true" : "false");
+    return ok;
+}
+
+// Cadena de mips completa por filtro y numero de hilos (MPix/s sobre el nivel 0) y cobertura de alfa
+// del ultimo nivel >= 4x4 con y sin conservarla
+static bool benchMips(const AppConfig &config, std::ostringstream &out) {
+    constexpr float ALPHA_CUTOFF = 0.5f;
+    const char *path = "assets/awesomeface.png";
+    SDL_Surface *surface = loadAssetImage(path);
+    SDL_Surface *converted = surface ? SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA32) : nullptr;
+    SDL_DestroySurface(surface);
+    if (!converted) {
+        printf("Unable to load image %s! SDL_image Error: %s\n", path, SDL_GetError());
+        return false;
+    }
+    const int width = converted->w;
+    const int height = converted->h;
+    std::vector<uint8_t> source(static_cast<size_t>(width) * height * 4);
+    for (int y = 0; y < height; y++) {
+        memcpy(source.data() + static_cast<size_t>(y) * width * 4,
+               static_cast<const uint8_t *>(converted->pixels) + static_cast<size_t>(y) * converted->pitch,
+               static_cast<size_t>(width) * 4);
+    }
+    SDL_DestroySurface(converted);
+
+    const double megapixels = static_cast<double>(width) * height / 1000000.0;
+    std::vector<std::vector<uint8_t> > levels;
+    const auto coverageAt = [&](size_t level) {
+        const size_t pixels = static_cast<size_t>(std::max(width >> level, 1)) * std::max(height >> level, 1);
+        return computeAlphaCoverage(levels[level].data(), pixels, ALPHA_CUTOFF);
+    };
+    out << "  \"image\": \"" << path << "\",\n";
+    out << "  \"width\": " << width << ",\n";
+    out << "  \"height\": " << height << ",\n";
+    // Primera pasada fuera de la medida: tablas sRGB y memoria de los niveles
+    generateMips(source.data(), width, height, MipOptions(), levels);
+    out << "  \"filters\": [\n";
+    for (int f = 0; f < MIP_FILTER_COUNT; f++) {
+        MipOptions options;
+        options.filter = static_cast<MipFilter>(f);
+        out << (f ? ",\n" : "") << "    {\"filter\": \"" << mipFilterName(options.filter) << "\", \"generate\": [";
+        for (const int threads: threadCounts(config.threads)) {
+            JobSystem jobs(threads, config.pinThreads);
+            const uint64_t start = SDL_GetTicksNS();
+            generateMips(source.data(), width, height, options, levels, &jobs);
+            const double ms = elapsedMs(start);
+            out << (threads > 1 ? ", " : "") << "{\"threads\": " << threads << ", \"ms\": " << ms
+                    << ", \"mpixPerSecond\": " << megapixels / (ms / 1000.0) << "}";
+        }
+
+        size_t level = 0;
+        while (level + 1 < levels.size() && std::max(width >> (level + 1), 1) >= 4 &&
+               std::max(height >> (level + 1), 1) >= 4) {
+            level++;
+        }
+        const float plainCoverage = coverageAt(level);
+        options.alphaCutoff = ALPHA_CUTOFF;
+        generateMips(source.data(), width, height, options, levels);
+        out << "], \"coverage\": {\"level0\": " << coverageAt(0) << ", \"level\": " << level
+                << ", \"plain\": " << plainCoverage << ", \"preserved\": " << coverageAt(level) << "}}";
+    }
+    out << "\n  ]";
+    return true;
+}
+
+// Hilo GL: updates hasta que la textura deja de estar pendiente. Devuelve el peor update en ms
+static double waitForTexture(TextureCache &cache, TextureHandle handle) {
+    double maxMs = 0.0;
+    while (cache.getStreamer()->getPendingCount() > 0) {
+        const uint64_t start = SDL_GetTicksNS();
+        cache.update();
+        maxMs = std::max(maxMs, elapsedMs(start));
+    }
+    cache.getTexture(handle);
+    return maxMs;
+}
+
+// Cache de texturas: aciertos con rutas equivalentes y con una copia del fichero, y presupuesto de VRAM
+// con texturas soltadas (se expulsan) y con todas referenciadas (pierden su nivel 0)
+static bool benchTextureCache(const AppConfig &config, std::ostringstream &out) {
+    constexpr int ACQUIRES = 100;
+    constexpr int BUDGET_TEXTURES = 8;
+    constexpr int BUDGET_SIZE = 256;
+    constexpr int KEPT = 2;
+
+    HeadlessContext context;
+    if (!context.create(64, 64)) {
+        return false;
+    }
+    context.bindFramebuffer();
+    JobSystem jobs(config.threads, config.pinThreads);
+    const std::filesystem::path temp = std::filesystem::temp_directory_path();
+
+    // Deduplicacion: cuatro nombres para el mismo contenido y una segunda imagen
+    const std::string copy = (temp / "container.copy.jpg").string();
+    std::error_code error;
+    extractAsset("assets/container.jpg", copy);
+    const std::string paths[] = {
+        "assets/container.jpg", "assets/./container.jpg", "assets/../assets/container.jpg", copy,
+        "assets/awesomeface.png"
+    };
+    {
+        TextureStreamer streamer;
+        streamer.begin(&jobs, static_cast<size_t>(config.uploadBudgetKB) * 1024);
+        TextureCache cache;
+        cache.begin(&streamer, 0);
+        const uint64_t start = SDL_GetTicksNS();
+        for (int i = 0; i < ACQUIRES; i++) {
+            cache.release(cache.acquire(paths[i % std::size(paths)]));
+        }
+        const double acquireMs = elapsedMs(start);
+        streamer.waitForDecodes();
+        waitForTexture(cache, 0);
+        out << "  \"dedupe\": {\"acquires\": " << ACQUIRES << ", \"hits\": " << cache.getHits()
+                << ", \"misses\": " << cache.getMisses() << ", \"hitRate\": " << cache.getHitRate()
+                << ", \"acquireMs\": " << acquireMs << ", \"residentBytes\": " << cache.getResidentBytes() << "},\n";
+        streamer.destroy();
+    }
+    std::filesystem::remove(copy, error);
+
+    // Presupuesto: BUDGET_TEXTURES .tex distintos (color liso), caben 3
+    std::vector<std::string> files;
+    std::vector<uint8_t> pixels(static_cast<size_t>(BUDGET_SIZE) * BUDGET_SIZE * 4);
+    std::vector<std::vector<uint8_t> > levels;
+    for (int i = 0; i < BUDGET_TEXTURES; i++) {
+        std::fill(pixels.begin(), pixels.end(), static_cast<uint8_t>(i * 30));
+        generateMips(pixels.data(), BUDGET_SIZE, BUDGET_SIZE, MipOptions(), levels);
+        files.push_back((temp / ("cache" + std::to_string(i) + ".bench.tex")).string());
+        if (!writeTextureFile(files.back(), TEXTURE_FILE_RGBA8, BUDGET_SIZE, BUDGET_SIZE, levels)) {
+            return false;
+        }
+    }
+    size_t textureBytes = 0;
+    for (const std::vector<uint8_t> &level: levels) {
+        textureBytes += level.size();
+    }
+    const size_t budget = textureBytes * 3;
+
+    TextureStreamer streamer;
+    streamer.begin(&jobs, static_cast<size_t>(config.uploadBudgetKB) * 1024);
+    TextureCache cache;
+    cache.begin(&streamer, budget);
+    // Fase 1: se cargan de una en una y solo las KEPT primeras siguen referenciadas
+    double maxUpdateMs = 0.0;
+    for (int i = 0; i < BUDGET_TEXTURES; i++) {
+        const TextureHandle handle = cache.acquire(files[i]);
+        maxUpdateMs = std::max(maxUpdateMs, waitForTexture(cache, handle));
+        if (i >= KEPT) {
+            cache.release(handle);
+        }
+    }
+    cache.update();
+    const size_t releasedResident = cache.getResidentBytes();
+    out << "  \"budgetBytes\": " << budget << ",\n";
+    out << "  \"textureBytes\": " << textureBytes << ",\n";
+    out << "  \"released\": {\"residentBytes\": " << releasedResident << ", \"evicted\": " << cache.getEvictedCount()
+            << ", \"droppedMips\": " << cache.getDroppedMipCount() << ", \"maxUpdateMs\": " << maxUpdateMs << "},\n";
+
+    // Fase 2: todas referenciadas; las expulsadas se vuelven a pedir
+    maxUpdateMs = 0.0;
+    bool allReady = true;
+    std::vector<TextureHandle> handles;
+    for (int i = 0; i < BUDGET_TEXTURES; i++) {
+        handles.push_back(cache.acquire(files[i]));
+        maxUpdateMs = std::max(maxUpdateMs, waitForTexture(cache, handles.back()));
+    }
+    cache.update();
+    // El contenido sobrevive a la reduccion: el nuevo nivel 0 sigue siendo el color liso
+    int contentMismatches = 0;
+    std::vector<uint8_t> readback;
+    for (int i = 0; i < BUDGET_TEXTURES; i++) {
+        allReady = allReady && streamer.isReady(handles[i]);
+        int width = 0;
+        int height = 0;
+        glBindTexture(GL_TEXTURE_2D, cache.getTexture(handles[i]));
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+        readback.resize(static_cast<size_t>(width) * height * 4);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, readback.data());
+        contentMismatches += std::any_of(readback.begin(), readback.end(), [i](uint8_t value) {
+            return value != static_cast<uint8_t>(i * 30);
+        });
+    }
+    const size_t referencedResident = cache.getResidentBytes();
+    out << "  \"referenced\": {\"residentBytes\": " << referencedResident << ", \"evicted\": "
+            << cache.getEvictedCount() << ", \"droppedMips\": " << cache.getDroppedMipCount()
+            << ", \"allReady\": " << (allReady ? "true" : "false") << ", \"contentMismatches\": " << contentMismatches
+            << ", \"maxUpdateMs\": " << maxUpdateMs
+            << ", \"hitRate\": " << cache.getHitRate() << "}";
+    streamer.waitForDecodes();
+    streamer.destroy();
+    for (const std::string &file: files) {
+        std::filesystem::remove(file, error);
+    }
+    return allReady && contentMismatches == 0 && releasedResident <= budget && referencedResident <= budget;
+}
+
+// Streaming progresivo de mips: arranque y VRAM con y sin streaming, y una escena en la que la demanda
+// pasa de un grupo de texturas a otro sin que los niveles cargados pasen del presupuesto
+static bool benchMipStreaming(const AppConfig &config, std::ostringstream &out) {
+    constexpr int TEXTURES = 16;
+    constexpr int SIZE = 512;
+    constexpr int SHARP = 4;
+    constexpr int PHASE_FRAMES = 90;
+
+    HeadlessContext context;
+    if (!context.create(64, 64)) {
+        return false;
+    }
+    context.bindFramebuffer();
+    JobSystem jobs(config.threads, config.pinThreads);
+    const std::filesystem::path temp = std::filesystem::temp_directory_path();
+
+    // Degradados distintos por textura, para que ningun nivel sea trivial
+    std::vector<std::string> files;
+    std::vector<uint8_t> pixels(static_cast<size_t>(SIZE) * SIZE * 4);
+    std::vector<std::vector<uint8_t> > levels;
+    for (int i = 0; i < TEXTURES; i++) {
+        for (int y = 0; y < SIZE; y++) {
+            for (int x = 0; x < SIZE; x++) {
+                uint8_t *pixel = pixels.data() + (static_cast<size_t>(y) * SIZE + x) * 4;
+                pixel[0] = static_cast<uint8_t>(x + i * 16);
+                pixel[1] = static_cast<uint8_t>(y);
+                pixel[2] = static_cast<uint8_t>((x ^ y) + i);
+                pixel[3] = 255;
+            }
+        }
+        generateMips(pixels.data(), SIZE, SIZE, MipOptions(), levels, &jobs);
+        files.push_back((temp / ("stream" + std::to_string(i) + ".bench.tex")).string());
+        if (!writeTextureFile(files.back(), TEXTURE_FILE_RGBA8, SIZE, SIZE, levels)) {
+            return false;
+        }
+    }
+    size_t textureBytes = 0;
+    for (const std::vector<uint8_t> &level: levels) {
+        textureBytes += level.size();
+    }
+    // Caben SHARP texturas completas y algo mas: al cambiar de grupo hay que soltar antes de subir
+    const size_t budget = textureBytes * SHARP + textureBytes / 2;
+
+    const auto streamAll = [&](TextureStreamer &streamer, std::vector<StreamedTextureId> &ids) {
+        for (const std::string &file: files) {
+            ids.push_back(streamer.request(file));
+        }
+        while (streamer.getPendingCount() > 0) {
+            streamer.update();
+        }
+    };
+    const auto residentBytes = [](const TextureStreamer &streamer, const std::vector<StreamedTextureId> &ids) {
+        size_t bytes = 0;
+        for (const StreamedTextureId id: ids) {
+            bytes += streamer.getTextureBytes(id);
+        }
+        return bytes;
+    };
+
+    out << "  \"textures\": " << TEXTURES << ",\n";
+    out << "  \"textureBytes\": " << textureBytes << ",\n";
+    out << "  \"budgetBytes\": " << budget << ",\n";
+    out << "  \"startup\": [";
+    size_t fullResident = 0;
+    size_t streamedResident = 0;
+    for (const bool streaming: {false, true}) {
+        TextureStreamer streamer;
+        streamer.begin(&jobs, static_cast<size_t>(config.uploadBudgetKB) * 1024);
+        streamer.setMipBudget(streaming ? budget : 0);
+        std::vector<StreamedTextureId> ids;
+        const uint64_t start = SDL_GetTicksNS();
+        streamAll(streamer, ids);
+        glFinish();
+        const double ms = elapsedMs(start);
+        (streaming ? streamedResident : fullResident) = residentBytes(streamer, ids);
+        out << (streaming ? ", " : "") << "{\"mipStreaming\": " << (streaming ? "true" : "false")
+                << ", \"readyMs\": " << ms << ", \"ready\": " << streamer.getReadyCount()
+                << ", \"residentBytes\": " << residentBytes(streamer, ids) << "}";
+        streamer.destroy();
+    }
+    out << "],\n";
+
+    // Escena: SHARP texturas a pantalla completa y SHARP a un cuarto; despues la demanda pasa al grupo siguiente
+    TextureStreamer streamer;
+    streamer.begin(&jobs, static_cast<size_t>(config.uploadBudgetKB) * 1024);
+    streamer.setMipBudget(budget);
+    std::vector<StreamedTextureId> ids;
+    streamAll(streamer, ids);
+    double maxUpdateMs = 0.0;
+    double totalUpdateMs = 0.0;
+    size_t maxStreamedBytes = 0;
+    // Frames hasta que el segundo grupo esta completo (sin esperar a que el primero suelte por inactividad)
+    int switchFrames = -1;
+    for (int frame = 0; frame < PHASE_FRAMES * 2; frame++) {
+        const int first = frame < PHASE_FRAMES ? 0 : SHARP * 2;
+        for (int i = 0; i < SHARP; i++) {
+            streamer.requestResolution(ids[first + i], static_cast<float>(SIZE));
+            streamer.requestResolution(ids[first + SHARP + i], static_cast<float>(SIZE / 4));
+        }
+        const uint64_t start = SDL_GetTicksNS();
+        streamer.update();
+        const double ms = elapsedMs(start);
+        maxUpdateMs = std::max(maxUpdateMs, ms);
+        totalUpdateMs += ms;
+        maxStreamedBytes = std::max(maxStreamedBytes, streamer.getStreamedBytes());
+        if (frame >= PHASE_FRAMES && switchFrames < 0) {
+            bool sharp = true;
+            for (int i = 0; i < SHARP; i++) {
+                sharp = sharp && streamer.getTextureBytes(ids[first + i]) >= textureBytes;
+            }
+            switchFrames = sharp ? frame - PHASE_FRAMES + 1 : -1;
+        }
+    }
+    // Al final el segundo grupo tiene todos sus niveles y el primero solo la cola
+    int sharpTextures = 0;
+    for (int i = 0; i < SHARP; i++) {
+        sharpTextures += streamer.getTextureBytes(ids[SHARP * 2 + i]) >= textureBytes;
+    }
+    out << "  \"demand\": {\"frames\": " << PHASE_FRAMES * 2 << ", \"levelsIn\": " << streamer.getStreamedLevelsIn()
+            << ", \"levelsOut\": " << streamer.getStreamedLevelsOut() << ", \"streamedBytes\": "
+            << streamer.getStreamedBytes() << ", \"maxStreamedBytes\": " << maxStreamedBytes
+            << ", \"sharpTextures\": " << sharpTextures << ", \"switchFrames\": " << switchFrames
+            << ", \"maxUpdateMs\": " << maxUpdateMs
+            << ", \"avgUpdateMs\": " << totalUpdateMs / (PHASE_FRAMES * 2) << "}";
+    streamer.destroy();
+
+    std::error_code error;
+    for (const std::string &file: files) {
+        std::filesystem::remove(file, error);
+    }
+    return streamedResident < fullResident && maxStreamedBytes <= budget && sharpTextures == SHARP;
+}
+
+// Subida de superficies: el camino anterior (convertir a RGBA32 + flip + glTexImage2D) frente a uploadSurface
+// con el formato exacto, y la expansion RGB24 -> RGBA8 frente a SDL_ConvertSurface. Comprueba el contenido
+// subido desde superficies de varios formatos con padding al final de cada fila
+static bool benchSurfaceUpload(const AppConfig &, std::ostringstream &out) {
+    constexpr int RUNS = 20;
+    constexpr int EXPAND_SIZE = 2048;
+    constexpr int CHECK_WIDTH = 333;
+    constexpr int CHECK_HEIGHT = 77;
+    const char *paths[] = {"assets/container.jpg", "assets/awesomeface.png"};
+
+    HeadlessContext context;
+    if (!context.create(64, 64)) {
+        return false;
+    }
+    context.bindFramebuffer();
+    unsigned int texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    unsigned int pbo;
+    glGenBuffers(1, &pbo);
+
+    const auto legacyUpload = [](SDL_Surface *surface) {
+        SDL_Surface *converted = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA32);
+        SDL_FlipSurface(converted, SDL_FLIP_VERTICAL);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, converted->w, converted->h, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                     converted->pixels);
+        SDL_DestroySurface(converted);
+    };
+    const auto measure = [](const auto &upload) {
+        // Un primer pase fuera de la medida deja compilados los caminos del driver
+        upload();
+        glFinish();
+        const uint64_t start = SDL_GetTicksNS();
+        for (int i = 0; i < RUNS; i++) {
+            upload();
+        }
+        glFinish();
+        return elapsedMs(start) / RUNS;
+    };
+
+    bool ok = true;
+    out << "  \"assets\": [\n";
+    for (size_t i = 0; i < std::size(paths); i++) {
+        SDL_Surface *surface = loadAssetImage(paths[i]);
+        if (!surface) {
+            printf("Unable to load image %s! SDL_image Error: %s\n", paths[i], SDL_GetError());
+            ok = false;
+            continue;
+        }
+        SurfaceLayout layout;
+        const double legacyMs = measure([&] { legacyUpload(surface); });
+        const double exactMs = measure([&] { uploadSurface(surface, pbo); });
+        out << (i ? ",\n" : "") << "    {\"image\": \"" << paths[i] << "\", \"width\": " << surface->w
+                << ", \"height\": " << surface->h << ", \"path\": \""
+                << (describeSurface(surface, layout) ? "direct" : canExpandSurface(surface) ? "expand" : "convert")
+                << "\", \"legacyMs\": " << legacyMs << ", \"exactMs\": " << exactMs << "}";
+        SDL_DestroySurface(surface);
+    }
+    out << "\n  ],\n";
+
+    // Solo la conversion en la CPU, sin GL
+    SDL_Surface *large = SDL_CreateSurface(EXPAND_SIZE, EXPAND_SIZE, SDL_PIXELFORMAT_RGB24);
+    std::vector<uint8_t> rgba(static_cast<size_t>(EXPAND_SIZE) * EXPAND_SIZE * 4);
+    for (int y = 0; y < EXPAND_SIZE; y++) {
+        memset(static_cast<uint8_t *>(large->pixels) + static_cast<size_t>(y) * large->pitch, y & 0xFF,
+               static_cast<size_t>(large->pitch));
+    }
+    const double megapixels = static_cast<double>(EXPAND_SIZE) * EXPAND_SIZE / 1000000.0;
+    const double expandMs = measure([&] { expandSurfaceRGBA8(large, rgba.data()); });
+    const double convertMs = measure([&] { SDL_DestroySurface(SDL_ConvertSurface(large, SDL_PIXELFORMAT_RGBA32)); });
+    SDL_DestroySurface(large);
+    out << "  \"expand\": {\"width\": " << EXPAND_SIZE << ", \"height\": " << EXPAND_SIZE
+            << ", \"mpixPerSecond\": " << megapixels / (expandMs / 1000.0)
+            << ", \"sdlConvertMpixPerSecond\": " << megapixels / (convertMs / 1000.0) << "},\n";
+
+    // Contenido: lo leido de vuelta debe coincidir con la conversion de SDL, sin voltear
+    const SDL_PixelFormat formats[] = {
+        SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_BGR24, SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_ARGB8888,
+        SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_BGRA8888, SDL_PIXELFORMAT_XRGB8888
+    };
+    std::vector<uint8_t> readback(static_cast<size_t>(CHECK_WIDTH) * CHECK_HEIGHT * 4);
+    uint32_t seed = 1;
+    int mismatches = 0;
+    out << "  \"formats\": [";
+    for (size_t f = 0; f < std::size(formats); f++) {
+        SDL_Surface *surface = SDL_CreateSurface(CHECK_WIDTH, CHECK_HEIGHT, formats[f]);
+        for (int y = 0; y < CHECK_HEIGHT; y++) {
+            uint8_t *row = static_cast<uint8_t *>(surface->pixels) + static_cast<size_t>(y) * surface->pitch;
+            for (int x = 0; x < surface->pitch; x++) {
+                seed = seed * 1664525u + 1013904223u;
+                row[x] = static_cast<uint8_t>(seed >> 24);
+            }
+        }
+        SDL_Surface *reference = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA32);
+        for (const unsigned int staging: {0u, pbo}) {
+            uploadSurface(surface, staging);
+            glPixelStorei(GL_PACK_ALIGNMENT, 4);
+            glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, readback.data());
+            // El swizzle de los formatos X8 se aplica al muestrear, no en la lectura
+            SurfaceLayout layout;
+            const bool opaque = describeSurface(surface, layout) && layout.opaque;
+            for (int y = 0; y < CHECK_HEIGHT; y++) {
+                const uint8_t *expected = static_cast<const uint8_t *>(reference->pixels) +
+                                          static_cast<size_t>(y) * reference->pitch;
+                const uint8_t *actual = readback.data() + static_cast<size_t>(y) * CHECK_WIDTH * 4;
+                for (int x = 0; x < CHECK_WIDTH * 4; x++) {
+                    mismatches += (opaque && x % 4 == 3 ? 0 : expected[x] != actual[x]);
+                }
+            }
+        }
+        SurfaceLayout layout;
+        out << (f ? ", " : "") << "{\"format\": \"" << SDL_GetPixelFormatName(formats[f]) << "\", \"pitch\": "
+                << surface->pitch << ", \"path\": \"" << (describeSurface(surface, layout) ? "direct" : "expand")
+                << "\"}";
+        SDL_DestroySurface(reference);
+        SDL_DestroySurface(surface);
+    }
+    out << "],\n";
+    out << "  \"mismatches\": " << mismatches;
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDeleteTextures(1, &texture);
+    glDeleteBuffers(1, &pbo);
+    return ok && mismatches == 0;
+}
+
+// Cache de binarios de programa: compilar desde las fuentes frente a arrancar con la cache vacia y llena,
+// y un binario corrupto que el driver debe rechazar (se recompila y se sobrescribe)
+static bool benchProgramCache(const AppConfig &, std::ostringstream &out) {
+    constexpr int RUNS = 5;
+    const char *programs[][2] = {
+        {"shaders/cube.vert", "shaders/cube.frag"},
+        {"shaders/light.vert", "shaders/light.frag"}
+    };
+
+    HeadlessContext context;
+    if (!context.create(64, 64)) {
+        return false;
+    }
+    context.bindFramebuffer();
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "program_cache.bench";
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+
+    int unlinked = 0;
+    const auto build = [&](ProgramCache *cache) {
+        const uint64_t start = SDL_GetTicksNS();
+        for (const auto &program: programs) {
+            const Shader shader(program[0], program[1], cache);
+            int linked = 0;
+            glGetProgramiv(shader.id, GL_LINK_STATUS, &linked);
+            unlinked += !linked;
+            glDeleteProgram(shader.id);
+        }
+        return elapsedMs(start);
+    };
+
+    double sourceMs = 0.0;
+    for (int i = 0; i < RUNS; i++) {
+        sourceMs += build(nullptr) / RUNS;
+    }
+    out << "  \"programs\": " << std::size(programs) << ",\n";
+    out << "  \"sourceMs\": " << sourceMs << ",\n";
+
+    ProgramCache cold;
+    if (!cold.begin(directory.string())) {
+        out << "  \"supported\": false";
+        return unlinked == 0;
+    }
+    const double coldMs = build(&cold);
+
+    // Cada arranque con una cache nueva sobre el mismo directorio
+    double warmMs = 0.0;
+    double savedMs = 0.0;
+    size_t hits = 0;
+    for (int i = 0; i < RUNS; i++) {
+        ProgramCache warm;
+        warm.begin(directory.string());
+        warmMs += build(&warm) / RUNS;
+        savedMs += warm.getSavedMs() / RUNS;
+        hits += warm.getHits();
+    }
+
+    // Se estropea el final de un binario
+    for (const auto &file: std::filesystem::directory_iterator(directory)) {
+        std::fstream stream(file.path(), std::ios::binary | std::ios::in | std::ios::out);
+        stream.seekp(-64, std::ios::end);
+        const std::string garbage(64, '\x5a');
+        stream.write(garbage.data(), static_cast<std::streamsize>(garbage.size()));
+        break;
+    }
+    ProgramCache corrupted;
+    corrupted.begin(directory.string());
+    build(&corrupted);
+    ProgramCache repaired;
+    repaired.begin(directory.string());
+    build(&repaired);
+
+    out << "  \"supported\": true,\n";
+    out << "  \"cold\": {\"ms\": " << coldMs << ", \"misses\": " << cold.getMisses() << ", \"compileMs\": "
+            << cold.getCompileMs() << "},\n";
+    out << "  \"warm\": {\"ms\": " << warmMs << ", \"hits\": " << hits << ", \"savedMs\": " << savedMs
+            << ", \"speedup\": " << sourceMs / warmMs << "},\n";
+    out << "  \"corrupted\": {\"hits\": " << corrupted.getHits() << ", \"rejected\": " << corrupted.getRejected()
+            << ", \"misses\": " << corrupted.getMisses() << ", \"repairedHits\": " << repaired.getHits() << "},\n";
+    out << "  \"unlinked\": " << unlinked;
+    std::filesystem::remove_all(directory, error);
+    return unlinked == 0 && hits == std::size(programs) * RUNS && corrupted.getMisses() == 1 &&
+           repaired.getHits() == std::size(programs);
+}
+
+static std::string readText(const std::string &path) {
+    AssetData data;
+    assetFileSystem().read(path, data);
+    return std::string(reinterpret_cast<const char *>(data.data()), data.size());
+}
+
+static void writeText(const std::filesystem::path &path, const std::string &text) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << text;
+}
+
+// Un #define distinto tras #version: el driver no puede reutilizar lo que ya compilo (cache de Mesa)
+static std::string shaderVariant(const std::string &source, const std::string &name) {
+    const size_t line = source.find('\n');
+    return source.substr(0, line + 1) + "#define " + name + "\n" + source.substr(line + 1);
+}
+
+// Compilacion asincrona: programas uno a uno frente a lanzar todos y esperar al final, variantes por
+// permutacion, el log de un error mapeado a su fichero y linea, y recarga en caliente de un fichero
+// observado (tambien con una edicion rota)
+static bool benchShaderManager(const AppConfig &, std::ostringstream &out) {
+    constexpr int PROGRAMS = 8;
+    constexpr int MAX_POLL_FRAMES = 500;
+
+    HeadlessContext context;
+    if (!context.create(64, 64)) {
+        return false;
+    }
+    context.bindFramebuffer();
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "shader_manager.bench";
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+    std::filesystem::create_directories(directory, error);
+    // Las variantes se escriben junto a los ficheros que incluyen
+    for (const char *include: {"common.glsl", "camera.glsl", "lighting.glsl"}) {
+        extractAsset(std::string("shaders/") + include, (directory / include).string());
+    }
+
+    const std::string vertex = readText("shaders/cube.vert");
+    const std::string fragment = readText("shaders/cube.frag");
+    const uint64_t nonce = SDL_GetTicksNS();
+    int variant = 0;
+    const auto writeVariants = [&](int count) {
+        std::vector<std::pair<std::string, std::string> > paths;
+        for (int i = 0; i < count; i++) {
+            const std::string name = "VARIANT_" + std::to_string(nonce) + "_" + std::to_string(variant++);
+            const std::filesystem::path vertexPath = directory / (name + ".vert");
+            const std::filesystem::path fragmentPath = directory / (name + ".frag");
+            writeText(vertexPath, shaderVariant(vertex, name));
+            writeText(fragmentPath, shaderVariant(fragment, name));
+            paths.emplace_back(vertexPath.string(), fragmentPath.string());
+        }
+        return paths;
+    };
+
+    ShaderManager probe;
+    probe.begin(nullptr);
+    out << "  \"parallelCompile\": " << (probe.isParallelCompileSupported() ? "true" : "false") << ",\n";
+
+    bool ok = true;
+    const auto sequentialPaths = writeVariants(PROGRAMS);
+    ShaderManager sequential;
+    sequential.begin(nullptr);
+    uint64_t start = SDL_GetTicksNS();
+    for (const auto &paths: sequentialPaths) {
+        sequential.load(paths.first, paths.second);
+        ok = sequential.finish() && ok;
+    }
+    const double sequentialMs = elapsedMs(start);
+    sequential.destroy();
+
+    const auto batchPaths = writeVariants(PROGRAMS);
+    ShaderManager batch;
+    batch.begin(nullptr);
+    start = SDL_GetTicksNS();
+    for (const auto &paths: batchPaths) {
+        batch.load(paths.first, paths.second);
+    }
+    const double submitMs = elapsedMs(start);
+    ok = batch.finish() && ok;
+    const double batchMs = elapsedMs(start);
+    batch.destroy();
+    out << "  \"programs\": " << PROGRAMS << ",\n";
+    out << "  \"sequentialMs\": " << sequentialMs << ",\n";
+    out << "  \"batch\": {\"submitMs\": " << submitMs << ", \"ms\": " << batchMs << ", \"speedup\": "
+            << sequentialMs / batchMs << "},\n";
+
+    // Todas las combinaciones, pedidas dos veces: la segunda no compila nada
+    ShaderManager permutations;
+    permutations.begin(nullptr);
+    std::vector<ProgramHandle> handles;
+    start = SDL_GetTicksNS();
+    for (int pass = 0; pass < 2; pass++) {
+        size_t index = 0;
+        for (const uint32_t lightCount: {1u, 2u, 4u}) {
+            for (uint32_t flags = 0; flags < 8; flags++) {
+                ShaderPermutation permutation;
+                permutation.lightCount = lightCount;
+                permutation.textured = flags & 1;
+                permutation.instanced = flags & 2;
+                permutation.shadows = flags & 4;
+                const ProgramHandle handle = permutations.load("shaders/cube.vert", "shaders/cube.frag",
+                                                               permutation);
+                if (pass == 0) {
+                    handles.push_back(handle);
+                }
+                ok = ok && handles[index++] == handle;
+            }
+        }
+    }
+    ok = permutations.finish() && ok;
+    const double permutationsMs = elapsedMs(start);
+    // Sin TEXTURED el sampler no existe en el programa: no queda rama que evaluar
+    ShaderPermutation textured;
+    textured.textured = true;
+    const bool folded =
+            glGetUniformLocation(permutations.getProgram(permutations.load("shaders/cube.vert", "shaders/cube.frag")),
+                                 "texture1") == -1 &&
+            glGetUniformLocation(permutations.getProgram(permutations.load("shaders/cube.vert", "shaders/cube.frag",
+                                                                           textured)), "texture1") != -1;
+    const bool lazy = permutations.getCompileCount() == handles.size() &&
+                      permutations.getProgramCount() == handles.size();
+    out << "  \"permutations\": {\"variants\": " << permutations.getProgramCount() << ", \"compiles\": "
+            << permutations.getCompileCount() << ", \"ms\": " << permutationsMs << ", \"folded\": "
+            << (folded ? "true" : "false") << "},\n";
+    permutations.destroy();
+
+    // El error esta en la linea 7 del fichero
+    const std::filesystem::path brokenPath = directory / "broken.frag";
+    writeText(brokenPath, "#version 330 core\nout vec4 FragColor;\n\nuniform vec3 objectColor;\n\nvoid main() {\n"
+              "    FragColor = vec4(objectColor, undefinedAlpha);\n}\n");
+    ShaderManager broken;
+    broken.begin(nullptr);
+    broken.load("shaders/light.vert", brokenPath.string());
+    const bool brokenFailed = !broken.finish();
+    const std::string brokenLog = broken.getLastError();
+    const bool mapped = brokenLog.find(brokenPath.string() + ":7:") != std::string::npos;
+    broken.destroy();
+    out << "  \"errorMapped\": " << (mapped ? "true" : "false") << ",\n";
+
+    // Recarga: se reescribe el fragment shader y se llama a update() como lo haria el hilo de render
+    bool reloaded = false;
+    bool keptOnError = false;
+    double maxUpdateMs = 0.0;
+#ifdef __linux__
+    const auto reloadPaths = writeVariants(1);
+    ShaderManager reload;
+    reload.begin(nullptr);
+    reload.watch(directory.string());
+    const ProgramHandle handle = reload.load(reloadPaths[0].first, reloadPaths[0].second);
+    ok = reload.finish() && ok;
+    Material material = createMaterial(reload.getProgram(handle));
+    reload.bindMaterial(handle, &material);
+    const unsigned int original = material.program;
+
+    const auto pollUntil = [&](const auto &done) {
+        for (int frame = 0; frame < MAX_POLL_FRAMES && !done(); frame++) {
+            const uint64_t updateStart = SDL_GetTicksNS();
+            reload.update();
+            maxUpdateMs = std::max(maxUpdateMs, elapsedMs(updateStart));
+            reload.applyUpdates();
+            SDL_Delay(1);
+        }
+        return done();
+    };
+
+    writeText(reloadPaths[0].second, shaderVariant(fragment, "RELOADED_" + std::to_string(nonce)));
+    reloaded = pollUntil([&] { return reload.getReloadCount() == 1; }) && material.program != original &&
+               material.program == reload.getProgram(handle);
+
+    const unsigned int current = reload.getProgram(handle);
+    writeText(reloadPaths[0].second, shaderVariant(fragment, "BROKEN") + "\nthis is not glsl\n");
+    keptOnError = pollUntil([&] { return reload.getFailedCount() == 1; }) && reload.getProgram(handle) == current &&
+                  material.program == current;
+    reload.destroy();
+#else
+    reloaded = keptOnError = true;
+#endif
+    out << "  \"hotReload\": {\"reloaded\": " << (reloaded ? "true" : "false") << ", \"keptOnError\": "
+            << (keptOnError ? "true" : "false") << ", \"maxUpdateMs\": " << maxUpdateMs << "}";
+
+    std::filesystem::remove_all(directory, error);
+    return ok && lazy && folded && brokenFailed && mapped && reloaded && keptOnError;
+}
+
+// Modulos SPIR-V de shader_compiler (cmake: target shaders-spirv): instrucciones sin optimizar y optimizadas
+// por etapa, y arranque (load + finish, sin cache de binarios) desde SPIR-V frente a GLSL
+static bool benchSpirv(const AppConfig &, std::ostringstream &out) {
+    constexpr int RUNS = 5;
+    const char *directory = "shaders/spirv";
+    const char *programs[][2] = {
+        {"shaders/cube.vert", "shaders/cube.frag"},
+        {"shaders/light.vert", "shaders/light.frag"}
+    };
+
+    HeadlessContext context;
+    if (!context.create(64, 64)) {
+        return false;
+    }
+    context.bindFramebuffer();
+
+    size_t modules = 0;
+    bool first = true;
+    out << "  \"stages\": [";
+    for (const auto &program: programs) {
+        for (const char *stage: program) {
+            ShaderSource source;
+            loadShaderSource(stage, source, ShaderPermutation().defines());
+            const std::string path = spirvPath(directory, stage, source);
+            std::vector<uint32_t> optimized;
+            std::vector<uint32_t> unoptimized;
+            const bool found = readSpirv(path, optimized) &&
+                               readSpirv(path.substr(0, path.size() - 4) + ".unoptimized.spv", unoptimized);
+            modules += found;
+            out << (first ? "" : ", ") << "{\"shader\": \"" << stage << "\", \"module\": "
+                    << (found ? "true" : "false");
+            if (found) {
+                out << ", \"instructions\": " << countSpirvInstructions(unoptimized) << ", \"optimized\": "
+                        << countSpirvInstructions(optimized);
+            }
+            out << "}";
+            first = false;
+        }
+    }
+    out << "],\n";
+
+    ShaderManager probe;
+    probe.begin(nullptr);
+    const bool supported = probe.useSpirv(directory);
+    out << "  \"supported\": " << (supported ? "true" : "false") << ",\n";
+
+    const auto startup = [&](bool spirv, size_t &fromSpirv) {
+        double ms = 0.0;
+        for (int i = 0; i < RUNS; i++) {
+            ShaderManager shaders;
+            shaders.begin(nullptr);
+            if (spirv) {
+                shaders.useSpirv(directory);
+            }
+            const uint64_t start = SDL_GetTicksNS();
+            for (const auto &program: programs) {
+                shaders.load(program[0], program[1]);
+            }
+            if (!shaders.finish()) {
+                return -1.0;
+            }
+            ms += elapsedMs(start) / RUNS;
+            fromSpirv = shaders.getSpirvCount();
+            shaders.destroy();
+        }
+        return ms;
+    };
+    size_t fromSpirv = 0;
+    const double glslMs = startup(false, fromSpirv);
+    out << "  \"glslMs\": " << glslMs;
+    if (!supported || modules == 0) {
+        // Sin GL 4.6 o sin glslangValidator/spirv-opt al compilar: solo queda el GLSL
+        return glslMs >= 0.0;
+    }
+    const double spirvMs = startup(true, fromSpirv);
+    out << ",\n  \"spirvMs\": " << spirvMs << ",\n";
+    out << "  \"programsFromSpirv\": " << fromSpirv << ",\n";
+    out << "  \"speedup\": " << glslMs / spirvMs;
+    return glslMs >= 0.0 && spirvMs >= 0.0;
+}
+
+// Arranque con ficheros sueltos frente al paquete mapeado: lee todos los assets y shaders (tocando cada
+// byte, para pagar tambien los fallos de pagina del mapeo) en frio y en caliente. Cuenta ficheros abiertos
+// y lecturas sin copia, comprueba que el contenido es identico y que el .tex queda alineado a pagina
+static bool benchAssetPack(const AppConfig &, std::ostringstream &out) {
+    constexpr int WARM_RUNS = 20;
+    const char *names[] = {
+        "assets/container.jpg", "assets/awesomeface.png", "assets/container.tex", "shaders/cube.vert",
+        "shaders/cube.frag", "shaders/light.vert", "shaders/light.frag", "shaders/common.glsl",
+        "shaders/camera.glsl", "shaders/lighting.glsl"
+    };
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "asset_pack.bench";
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+    std::filesystem::create_directories(directory / "assets", error);
+    std::filesystem::create_directories(directory / "shaders", error);
+    std::vector<AssetPackInput> inputs;
+    for (const char *name: names) {
+        const std::string loose = (directory / name).string();
+        const bool written = std::filesystem::path(name).extension() == ".tex"
+                                 ? writeBenchTextureFile("assets/container.jpg", loose)
+                                 : extractAsset(name, loose);
+        if (!written) {
+            return false;
+        }
+        inputs.push_back({name, loose});
+    }
+    const std::string packPath = (directory / "bench.pak").string();
+    AssetPackSummary summary;
+    if (!writeAssetPack(packPath, inputs, &summary)) {
+        return false;
+    }
+
+    // Sin montar: todo se lee suelto
+    AssetFileSystem loose;
+    AssetFileSystem packed;
+    if (!packed.mount(packPath)) {
+        return false;
+    }
+    bool identical = true;
+    bool aligned = true;
+    for (const AssetPackInput &input: inputs) {
+        AssetData a;
+        AssetData b;
+        identical = loose.read(input.sourcePath, a) && packed.read(input.name, b) && a.size() == b.size() &&
+                    memcmp(a.data(), b.data(), a.size()) == 0 && identical;
+        if (std::filesystem::path(input.name).extension() == ".tex") {
+            aligned = b.isZeroCopy() && reinterpret_cast<uintptr_t>(b.data()) % TEXTURE_FILE_ALIGNMENT == 0;
+        }
+    }
+    packed.unmount();
+
+    const auto dropCaches = [&] {
+        bool dropped = dropFileCache(packPath);
+        for (const AssetPackInput &input: inputs) {
+            dropped = dropFileCache(input.sourcePath) && dropped;
+        }
+        return dropped;
+    };
+    // Monta (si hace falta), lee y recorre cada asset como lo haria el arranque
+    const auto load = [&](AssetFileSystem &fileSystem, bool pack) {
+        if (pack) {
+            fileSystem.mount(packPath);
+        }
+        uint32_t checksum = 0;
+        for (const AssetPackInput &input: inputs) {
+            AssetData data;
+            if (fileSystem.read(pack ? input.name : input.sourcePath, data)) {
+                for (size_t i = 0; i < data.size(); i++) {
+                    checksum += data.data()[i];
+                }
+            }
+        }
+        fileSystem.unmount();
+        return checksum;
+    };
+    uint32_t looseChecksum = 0;
+    uint32_t packChecksum = 0;
+    const auto measure = [&](bool pack, bool cold) {
+        double total = 0.0;
+        const int runs = cold ? 1 : WARM_RUNS;
+        for (int i = 0; i < runs; i++) {
+            if (cold) {
+                dropCaches();
+            }
+            AssetFileSystem fileSystem;
+            const uint64_t start = SDL_GetTicksNS();
+            (pack ? packChecksum : looseChecksum) = load(fileSystem, pack);
+            total += elapsedMs(start);
+        }
+        return total / runs;
+    };
+
+    AssetFileSystem looseCounter;
+    AssetFileSystem packCounter;
+    load(looseCounter, false);
+    load(packCounter, true);
+    out << "  \"files\": " << inputs.size() << ",\n";
+    out << "  \"coldSupported\": " << (dropCaches() ? "true" : "false") << ",\n";
+    out << "  \"loose\": {\"opens\": " << looseCounter.getFileOpenCount() << ", \"coldMs\": "
+            << measure(false, true) << ", \"warmMs\": " << measure(false, false) << "},\n";
+    out << "  \"pack\": {\"opens\": " << packCounter.getFileOpenCount() << ", \"zeroCopy\": "
+            << packCounter.getZeroCopyCount() << ", \"lz4\": " << summary.compressedCount << ", \"coldMs\": "
+            << measure(true, true) << ", \"warmMs\": " << measure(true, false) << "},\n";
+    out << "  \"bytes\": {\"original\": " << summary.originalBytes << ", \"stored\": " << summary.storedBytes
+            << ", \"pack\": " << summary.packBytes << ", \"ratio\": "
+            << static_cast<double>(summary.storedBytes) / static_cast<double>(summary.originalBytes) << "},\n";
+    out << "  \"identical\": " << (identical && looseChecksum == packChecksum ? "true" : "false") << ",\n";
+    out << "  \"texAligned\": " << (aligned ? "true" : "false");
+
+    std::filesystem::remove_all(directory, error);
+    return identical && looseChecksum == packChecksum && aligned && packCounter.getFileOpenCount() == 1 &&
+           packCounter.getPackReadCount() == inputs.size();
+}
+
+// Cocinado incremental sobre una copia de assets/ y shaders/: todo desde cero con 1 hilo y con todos, una
+// segunda pasada sin cambios (y con los ficheros reescritos iguales: cuenta el contenido, no la fecha), un
+// cambio en un include que recocina quien lo incluye y un fuente borrado cuyo resultado sale del paquete
+static bool benchAssetCooker(const AppConfig &config, std::ostringstream &out) {
+    const char *names[] = {
+        "assets/container.jpg", "assets/awesomeface.png", "shaders/cube.vert", "shaders/cube.frag",
+        "shaders/light.vert", "shaders/light.frag", "shaders/common.glsl", "shaders/camera.glsl",
+        "shaders/lighting.glsl"
+    };
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "asset_cooker.bench";
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+    std::filesystem::create_directories(directory / "source" / "assets", error);
+    std::filesystem::create_directories(directory / "source" / "shaders", error);
+    for (const char *name: names) {
+        if (!extractAsset(name, (directory / "source" / name).string())) {
+            return false;
+        }
+    }
+
+    AssetCookOptions options;
+    options.sourceDirectory = (directory / "source").string();
+    options.inputs = {"assets", "shaders"};
+    options.packPath = (directory / "cooked.pak").string();
+    bool ok = true;
+    const auto cook = [&](JobSystem &jobs, const char *label, size_t expectedCooked, size_t expectedRemoved) {
+        AssetCookStats stats;
+        const uint64_t start = SDL_GetTicksNS();
+        const bool cooked = cookAssets(options, jobs, stats);
+        const double ms = elapsedMs(start);
+        ok = ok && cooked && stats.cookedCount == expectedCooked && stats.removedCount == expectedRemoved &&
+             stats.packWritten == (expectedCooked || expectedRemoved);
+        out << "  \"" << label << "\": {\"sources\": " << stats.sourceCount << ", \"cooked\": "
+                << stats.cookedCount << ", \"removed\": " << stats.removedCount << ", \"ms\": " << ms << "},\n";
+    };
+    const auto edit = [&](const char *name, const std::string &suffix) {
+        std::ofstream file(directory / "source" / name, std::ios::binary | std::ios::app);
+        file << suffix;
+    };
+
+    {
+        JobSystem jobs(1, config.pinThreads);
+        options.cacheDirectory = (directory / "serial").string();
+        options.packPath = (directory / "serial.pak").string();
+        cook(jobs, "full1Thread", std::size(names), 0);
+    }
+    JobSystem jobs(config.threads, config.pinThreads);
+    options.cacheDirectory = (directory / "cache").string();
+    options.packPath = (directory / "cooked.pak").string();
+    cook(jobs, "full", std::size(names), 0);
+    cook(jobs, "unchanged", 0, 0);
+    // Misma fecha nueva, mismo contenido
+    for (const char *name: names) {
+        std::filesystem::last_write_time(directory / "source" / name, std::filesystem::file_time_type::clock::now(),
+                                         error);
+    }
+    cook(jobs, "touched", 0, 0);
+    // common.glsl y las 4 etapas; lighting.glsl y cube.frag
+    edit("shaders/common.glsl", "\n// edit\n");
+    cook(jobs, "commonEdit", 5, 0);
+    edit("shaders/lighting.glsl", "\n// edit\n");
+    cook(jobs, "lightingEdit", 2, 0);
+    std::filesystem::remove(directory / "source" / "assets" / "awesomeface.png", error);
+    cook(jobs, "imageRemoved", 0, 1);
+
+    // Lo que carga la aplicacion: la textura cocinada con sus mips y los shaders, ya sin el fuente borrado
+    AssetFileSystem packed;
+    bool loadable = packed.mount(options.packPath);
+    AssetData texture;
+    loadable = loadable && packed.read(cookedAssetPath("assets/container.jpg"), texture) &&
+               texture.isZeroCopy() && packed.exists("shaders/cube.frag") &&
+               !packed.exists(cookedAssetPath("assets/awesomeface.png")) && packed.getEntryCount() == 8;
+    out << "  \"packEntries\": " << packed.getEntryCount() << ",\n";
+    out << "  \"loadable\": " << (loadable ? "true" : "false");
+    packed.unmount();
+
+    std::filesystem::remove_all(directory, error);
+    return ok && loadable;
+}
+
+typedef bool (*BenchmarkFunction)(const AppConfig &config, std::ostringstream &out);
+
+struct BenchmarkEntry {
+    const char *name;
+    BenchmarkFunction function;
+};
+
+static const BenchmarkEntry BENCHMARKS[] = {
+    {"transforms", benchTransforms},
+    {"ecs", benchEcs},
+    {"jobs", benchJobs},
+    {"commands", benchRenderCommands},
+    {"textures", benchTextures},
+    {"loader", benchLoader},
+    {"bc", benchBlockCompression},
+    {"texfile", benchTextureFile},
+    {"mips", benchMips},
+    {"texcache", benchTextureCache},
+    {"mipstream", benchMipStreaming},
+    {"upload", benchSurfaceUpload},
+    {"programs", benchProgramCache},
+    {"shaders", benchShaderManager},
+    {"spirv", benchSpirv},
+    {"pack", benchAssetPack},
+    {"cook", benchAssetCooker},
+};
+
+bool runBenchmark(const AppConfig &config) {
+    for (const BenchmarkEntry &entry: BENCHMARKS) {
+        if (config.benchmark != entry.name) {
+            continue;
+        }
+
+        std::ostringstream out;
+        out << "{\n  \"benchmark\": \"" << entry.name << "\",\n";
+        out << "  \"threads\": " << config.threads << ",\n";
+        if (!entry.function(config, out)) {
+            SDL_Log("Benchmark '%s' failed", entry.name);
+            return false;
+        }
+        out << "\n}\n";
+
+        if (config.reportPath.empty() || config.reportPath == "-") {
+            std::cout << out.str();
+            return true;
+        }
+        std::ofstream file(config.reportPath);
+        if (!file) {
+            printf("Unable to write benchmark report %s\n", config.reportPath.c_str());
+            return false;
+        }
+        file << out.str();
+        return true;
+    }
+
+    SDL_Log("Unknown benchmark '%s'. Available:", config.benchmark.c_str());
+    for (const BenchmarkEntry &entry: BENCHMARKS) {
+        SDL_Log("  %s", entry.name);
+    }
+    return false;
+}
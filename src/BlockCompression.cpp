@@ -0,0 +1,696 @@
+#include "BlockCompression.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BLOCK_SSE2 1
+#endif
+
+// Pixeles de un bloque en SoA: channel[c][i], c = R, G, B, A
+struct BlockPixels {
+    float channel[4][16];
+};
+
+// Pesos de interpolacion de BC7 para indices de 4 bits
+static constexpr int BC7_WEIGHTS[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+const char *blockFormatName(BlockFormat format) {
+    switch (format) {
+        case BLOCK_FORMAT_BC1: return "bc1";
+        case BLOCK_FORMAT_BC3: return "bc3";
+        case BLOCK_FORMAT_BC4: return "bc4";
+        case BLOCK_FORMAT_BC5: return "bc5";
+        case BLOCK_FORMAT_BC7: return "bc7";
+        default: return "unknown";
+    }
+}
+
+bool parseBlockFormat(const std::string &name, BlockFormat &format) {
+    for (int f = 0; f < BLOCK_FORMAT_COUNT; f++) {
+        if (name == blockFormatName(static_cast<BlockFormat>(f))) {
+            format = static_cast<BlockFormat>(f);
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t blockFormatBlockBytes(BlockFormat format) {
+    return format == BLOCK_FORMAT_BC1 || format == BLOCK_FORMAT_BC4 ? 8 : 16;
+}
+
+size_t blockFormatLevelBytes(BlockFormat format, int width, int height) {
+    const size_t blocksX = (width + 3) / 4;
+    const size_t blocksY = (height + 3) / 4;
+    return blocksX * blocksY * blockFormatBlockBytes(format);
+}
+
+int blockFormatChannels(BlockFormat format) {
+    switch (format) {
+        case BLOCK_FORMAT_BC1: return 3;
+        case BLOCK_FORMAT_BC4: return 1;
+        case BLOCK_FORMAT_BC5: return 2;
+        default: return 4;
+    }
+}
+
+// Para cada pixel, la entrada de la paleta mas cercana (distancia euclidea en RGBA).
+// Los canales que no cuentan deben ser 0 tanto en pixels como en palette. Devuelve el error total
+static float selectIndices(const BlockPixels &pixels, const float (*palette)[4], int paletteSize,
+                           uint8_t indices[16]) {
+#ifdef BLOCK_SSE2
+    // 4 pixeles por iteracion; el argmin se lleva con mascaras
+    float total = 0.0f;
+    for (int group = 0; group < 16; group += 4) {
+        const __m128 r = _mm_loadu_ps(&pixels.channel[0][group]);
+        const __m128 g = _mm_loadu_ps(&pixels.channel[1][group]);
+        const __m128 b = _mm_loadu_ps(&pixels.channel[2][group]);
+        const __m128 a = _mm_loadu_ps(&pixels.channel[3][group]);
+        __m128 best = _mm_set1_ps(FLT_MAX);
+        __m128i bestIndex = _mm_setzero_si128();
+        for (int i = 0; i < paletteSize; i++) {
+            const __m128 dr = _mm_sub_ps(r, _mm_set1_ps(palette[i][0]));
+            const __m128 dg = _mm_sub_ps(g, _mm_set1_ps(palette[i][1]));
+            const __m128 db = _mm_sub_ps(b, _mm_set1_ps(palette[i][2]));
+            const __m128 da = _mm_sub_ps(a, _mm_set1_ps(palette[i][3]));
+            __m128 distance = _mm_mul_ps(dr, dr);
+            distance = _mm_add_ps(distance, _mm_mul_ps(dg, dg));
+            distance = _mm_add_ps(distance, _mm_mul_ps(db, db));
+            distance = _mm_add_ps(distance, _mm_mul_ps(da, da));
+            const __m128i closer = _mm_castps_si128(_mm_cmplt_ps(distance, best));
+            best = _mm_min_ps(distance, best);
+            bestIndex = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(i)), _mm_andnot_si128(closer, bestIndex));
+        }
+        alignas(16) int32_t lane[4];
+        alignas(16) float error[4];
+        _mm_store_si128(reinterpret_cast<__m128i *>(lane), bestIndex);
+        _mm_store_ps(error, best);
+        for (int k = 0; k < 4; k++) {
+            indices[group + k] = static_cast<uint8_t>(lane[k]);
+            total += error[k];
+        }
+    }
+    return total;
+#else
+    float total = 0.0f;
+    for (int p = 0; p < 16; p++) {
+        float best = FLT_MAX;
+        for (int i = 0; i < paletteSize; i++) {
+            float distance = 0.0f;
+            for (int c = 0; c < 4; c++) {
+                const float d = pixels.channel[c][p] - palette[i][c];
+                distance += d * d;
+            }
+            if (distance < best) {
+                best = distance;
+                indices[p] = static_cast<uint8_t>(i);
+            }
+        }
+        total += best;
+    }
+    return total;
+#endif
+}
+
+// Eje principal (iteracion de potencia sobre la covarianza) de los canales [0, channels)
+static void principalAxis(const BlockPixels &pixels, int channels, float mean[4], float axis[4]) {
+    float minimum[4] = {}, maximum[4] = {};
+    for (int c = 0; c < 4; c++) {
+        mean[c] = 0.0f;
+        axis[c] = 0.0f;
+        if (c >= channels) {
+            continue;
+        }
+        minimum[c] = maximum[c] = pixels.channel[c][0];
+        for (int p = 0; p < 16; p++) {
+            mean[c] += pixels.channel[c][p];
+            minimum[c] = std::min(minimum[c], pixels.channel[c][p]);
+            maximum[c] = std::max(maximum[c], pixels.channel[c][p]);
+        }
+        mean[c] /= 16.0f;
+    }
+
+    float covariance[4][4] = {};
+    for (int p = 0; p < 16; p++) {
+        for (int i = 0; i < channels; i++) {
+            const float di = pixels.channel[i][p] - mean[i];
+            for (int j = i; j < channels; j++) {
+                covariance[i][j] += di * (pixels.channel[j][p] - mean[j]);
+            }
+        }
+    }
+    for (int i = 0; i < channels; i++) {
+        for (int j = 0; j < i; j++) {
+            covariance[i][j] = covariance[j][i];
+        }
+    }
+
+    // Arrancar desde la diagonal de la caja envolvente converge en pocas iteraciones
+    for (int c = 0; c < channels; c++) {
+        axis[c] = maximum[c] - minimum[c];
+    }
+    for (int iteration = 0; iteration < 8; iteration++) {
+        float next[4] = {};
+        float length = 0.0f;
+        for (int i = 0; i < channels; i++) {
+            for (int j = 0; j < channels; j++) {
+                next[i] += covariance[i][j] * axis[j];
+            }
+            length = std::max(length, std::fabs(next[i]));
+        }
+        if (length < 1e-6f) {
+            break;
+        }
+        for (int c = 0; c < channels; c++) {
+            axis[c] = next[c] / length;
+        }
+    }
+
+    float length = 0.0f;
+    for (int c = 0; c < channels; c++) {
+        length += axis[c] * axis[c];
+    }
+    if (length < 1e-12f) {
+        for (int c = 0; c < channels; c++) {
+            axis[c] = 1.0f;
+        }
+        length = static_cast<float>(channels);
+    }
+    length = std::sqrt(length);
+    for (int c = 0; c < channels; c++) {
+        axis[c] /= length;
+    }
+}
+
+// Extremos del bloque proyectado sobre el eje principal
+static void axisEndpoints(const BlockPixels &pixels, int channels, float e0[4], float e1[4]) {
+    float mean[4], axis[4];
+    principalAxis(pixels, channels, mean, axis);
+    float minT = FLT_MAX, maxT = -FLT_MAX;
+    for (int p = 0; p < 16; p++) {
+        float t = 0.0f;
+        for (int c = 0; c < channels; c++) {
+            t += (pixels.channel[c][p] - mean[c]) * axis[c];
+        }
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+    for (int c = 0; c < 4; c++) {
+        e0[c] = c < channels ? std::clamp(mean[c] + axis[c] * maxT, 0.0f, 255.0f) : 0.0f;
+        e1[c] = c < channels ? std::clamp(mean[c] + axis[c] * minT, 0.0f, 255.0f) : 0.0f;
+    }
+}
+
+// Minimos cuadrados: extremos que mejor reproducen los pixeles con los pesos t (0 = e0, 1 = e1)
+static bool refitEndpoints(const BlockPixels &pixels, int channels, const float t[16], float e0[4], float e1[4]) {
+    float a = 0.0f, b = 0.0f, c = 0.0f;
+    float x0[4] = {}, x1[4] = {};
+    for (int p = 0; p < 16; p++) {
+        const float w0 = 1.0f - t[p];
+        const float w1 = t[p];
+        a += w0 * w0;
+        b += w0 * w1;
+        c += w1 * w1;
+        for (int ch = 0; ch < channels; ch++) {
+            x0[ch] += w0 * pixels.channel[ch][p];
+            x1[ch] += w1 * pixels.channel[ch][p];
+        }
+    }
+    const float determinant = a * c - b * b;
+    if (std::fabs(determinant) < 1e-6f) {
+        return false;
+    }
+    for (int ch = 0; ch < channels; ch++) {
+        e0[ch] = std::clamp((c * x0[ch] - b * x1[ch]) / determinant, 0.0f, 255.0f);
+        e1[ch] = std::clamp((a * x1[ch] - b * x0[ch]) / determinant, 0.0f, 255.0f);
+    }
+    return true;
+}
+
+static void loadBlock(const uint8_t *rgba, int width, int height, int blockX, int blockY, BlockPixels &pixels) {
+    for (int y = 0; y < 4; y++) {
+        // Bloques de borde: se repite el ultimo pixel valido
+        const int sy = std::min(blockY * 4 + y, height - 1);
+        for (int x = 0; x < 4; x++) {
+            const int sx = std::min(blockX * 4 + x, width - 1);
+            const uint8_t *pixel = rgba + (static_cast<size_t>(sy) * width + sx) * 4;
+            for (int c = 0; c < 4; c++) {
+                pixels.channel[c][y * 4 + x] = pixel[c];
+            }
+        }
+    }
+}
+
+// Copia el canal source en el 0 y anula el resto
+static void singleChannel(const BlockPixels &pixels, int source, BlockPixels &out) {
+    memset(&out, 0, sizeof(out));
+    memcpy(out.channel[0], pixels.channel[source], sizeof(out.channel[0]));
+}
+
+// --- BC1 ---
+
+static uint16_t packColor565(const float color[4]) {
+    const int r = static_cast<int>(color[0] * 31.0f / 255.0f + 0.5f);
+    const int g = static_cast<int>(color[1] * 63.0f / 255.0f + 0.5f);
+    const int b = static_cast<int>(color[2] * 31.0f / 255.0f + 0.5f);
+    return static_cast<uint16_t>(r << 11 | g << 5 | b);
+}
+
+static void unpackColor565(uint16_t packed, float color[4]) {
+    const int r = packed >> 11 & 31;
+    const int g = packed >> 5 & 63;
+    const int b = packed & 31;
+    color[0] = static_cast<float>(r << 3 | r >> 2);
+    color[1] = static_cast<float>(g << 2 | g >> 4);
+    color[2] = static_cast<float>(b << 3 | b >> 2);
+    color[3] = 0.0f;
+}
+
+// Paleta de 4 colores (c0 > c1): c0, c1, 2/3 c0 + 1/3 c1, 1/3 c0 + 2/3 c1
+static void bc1Palette(uint16_t c0, uint16_t c1, float palette[4][4]) {
+    unpackColor565(c0, palette[0]);
+    unpackColor565(c1, palette[1]);
+    for (int c = 0; c < 4; c++) {
+        palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+        palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+    }
+}
+
+static float evaluateBC1(const BlockPixels &rgb, const float e0[4], const float e1[4], uint16_t &c0, uint16_t &c1,
+                         uint8_t indices[16]) {
+    c0 = packColor565(e0);
+    c1 = packColor565(e1);
+    float palette[4][4];
+    bc1Palette(c0, c1, palette);
+    return selectIndices(rgb, palette, 4, indices);
+}
+
+static void encodeBC1Block(const BlockPixels &pixels, uint8_t *out) {
+    BlockPixels rgb = pixels;
+    memset(rgb.channel[3], 0, sizeof(rgb.channel[3]));
+
+    float e0[4], e1[4];
+    axisEndpoints(rgb, 3, e0, e1);
+    uint16_t c0, c1;
+    uint8_t indices[16];
+    float error = evaluateBC1(rgb, e0, e1, c0, c1, indices);
+
+    static constexpr float T[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+    for (int iteration = 0; iteration < 2; iteration++) {
+        float t[16];
+        for (int p = 0; p < 16; p++) {
+            t[p] = T[indices[p]];
+        }
+        float r0[4] = {}, r1[4] = {};
+        if (!refitEndpoints(rgb, 3, t, r0, r1)) {
+            break;
+        }
+        uint16_t n0, n1;
+        uint8_t refined[16];
+        const float refinedError = evaluateBC1(rgb, r0, r1, n0, n1, refined);
+        if (refinedError >= error) {
+            break;
+        }
+        error = refinedError;
+        c0 = n0;
+        c1 = n1;
+        memcpy(indices, refined, sizeof(indices));
+    }
+
+    // c0 <= c1 activaria el modo de 3 colores: intercambiar o, si son iguales, usar solo c0
+    if (c0 < c1) {
+        std::swap(c0, c1);
+        static constexpr uint8_t SWAPPED[4] = {1, 0, 3, 2};
+        for (uint8_t &index: indices) {
+            index = SWAPPED[index];
+        }
+    } else if (c0 == c1) {
+        memset(indices, 0, sizeof(indices));
+    }
+
+    uint32_t bits = 0;
+    for (int p = 0; p < 16; p++) {
+        bits |= static_cast<uint32_t>(indices[p]) << (p * 2);
+    }
+    out[0] = static_cast<uint8_t>(c0);
+    out[1] = static_cast<uint8_t>(c0 >> 8);
+    out[2] = static_cast<uint8_t>(c1);
+    out[3] = static_cast<uint8_t>(c1 >> 8);
+    memcpy(out + 4, &bits, 4);
+}
+
+static void decodeBC1Block(const uint8_t *block, uint8_t pixels[16][4], int channelOffset) {
+    const uint16_t c0 = static_cast<uint16_t>(block[0] | block[1] << 8);
+    const uint16_t c1 = static_cast<uint16_t>(block[2] | block[3] << 8);
+    float palette[4][4];
+    bc1Palette(c0, c1, palette);
+    if (c0 <= c1) {
+        for (int c = 0; c < 4; c++) {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2.0f;
+            palette[3][c] = 0.0f;
+        }
+    }
+    uint32_t bits;
+    memcpy(&bits, block + 4, 4);
+    for (int p = 0; p < 16; p++) {
+        const int index = bits >> (p * 2) & 3;
+        for (int c = 0; c < 3; c++) {
+            pixels[p][channelOffset + c] = static_cast<uint8_t>(palette[index][c] + 0.5f);
+        }
+    }
+}
+
+// --- BC4 (un canal, tambien alfa de BC3 y cada canal de BC5) ---
+
+// Modo de 8 valores (e0 > e1): e0, e1 y 6 interpolados
+static void bc4Palette(int e0, int e1, float palette[8][4]) {
+    memset(palette, 0, sizeof(float) * 8 * 4);
+    palette[0][0] = static_cast<float>(e0);
+    palette[1][0] = static_cast<float>(e1);
+    if (e0 > e1) {
+        for (int i = 1; i < 7; i++) {
+            palette[i + 1][0] = static_cast<float>(((7 - i) * e0 + i * e1 + 3) / 7);
+        }
+    } else {
+        for (int i = 1; i < 5; i++) {
+            palette[i + 1][0] = static_cast<float>(((5 - i) * e0 + i * e1 + 2) / 5);
+        }
+        palette[6][0] = 0.0f;
+        palette[7][0] = 255.0f;
+    }
+}
+
+static float evaluateBC4(const BlockPixels &channel, float e0, float e1, int &q0, int &q1, uint8_t indices[16]) {
+    q0 = static_cast<int>(e0 + 0.5f);
+    q1 = static_cast<int>(e1 + 0.5f);
+    if (q0 < q1) {
+        std::swap(q0, q1);
+    }
+    float palette[8][4];
+    bc4Palette(q0, q1, palette);
+    return selectIndices(channel, palette, 8, indices);
+}
+
+// channel: el valor en channel[0], resto a 0
+static void encodeBC4Block(const BlockPixels &channel, uint8_t *out) {
+    float minimum = 255.0f, maximum = 0.0f;
+    for (int p = 0; p < 16; p++) {
+        minimum = std::min(minimum, channel.channel[0][p]);
+        maximum = std::max(maximum, channel.channel[0][p]);
+    }
+    int q0, q1;
+    uint8_t indices[16];
+    float error = evaluateBC4(channel, maximum, minimum, q0, q1, indices);
+
+    if (q0 > q1) {
+        float t[16];
+        for (int p = 0; p < 16; p++) {
+            t[p] = indices[p] == 0 ? 0.0f : indices[p] == 1 ? 1.0f : static_cast<float>(indices[p] - 1) / 7.0f;
+        }
+        float r0[4] = {}, r1[4] = {};
+        if (refitEndpoints(channel, 1, t, r0, r1)) {
+            int n0, n1;
+            uint8_t refined[16];
+            const float refinedError = evaluateBC4(channel, r0[0], r1[0], n0, n1, refined);
+            if (refinedError < error && n0 > n1) {
+                error = refinedError;
+                q0 = n0;
+                q1 = n1;
+                memcpy(indices, refined, sizeof(indices));
+            }
+        }
+    }
+
+    uint64_t bits = 0;
+    for (int p = 0; p < 16; p++) {
+        bits |= static_cast<uint64_t>(indices[p]) << (p * 3);
+    }
+    out[0] = static_cast<uint8_t>(q0);
+    out[1] = static_cast<uint8_t>(q1);
+    for (int i = 0; i < 6; i++) {
+        out[2 + i] = static_cast<uint8_t>(bits >> (i * 8));
+    }
+}
+
+static void decodeBC4Block(const uint8_t *block, uint8_t pixels[16][4], int channel) {
+    float palette[8][4];
+    bc4Palette(block[0], block[1], palette);
+    uint64_t bits = 0;
+    for (int i = 0; i < 6; i++) {
+        bits |= static_cast<uint64_t>(block[2 + i]) << (i * 8);
+    }
+    for (int p = 0; p < 16; p++) {
+        pixels[p][channel] = static_cast<uint8_t>(palette[bits >> (p * 3) & 7][0]);
+    }
+}
+
+// --- BC7 modo 6: un subconjunto RGBA 7777 + p-bit por extremo, indices de 4 bits ---
+
+struct BC7Mode6 {
+    int endpoint[2][4]; // 7 bits por canal
+    int pbit[2];
+    uint8_t indices[16];
+};
+
+static float evaluateBC7(const BlockPixels &pixels, const float e0[4], const float e1[4], int p0, int p1,
+                         BC7Mode6 &block) {
+    const float *source[2] = {e0, e1};
+    const int pbits[2] = {p0, p1};
+    int value[2][4];
+    for (int e = 0; e < 2; e++) {
+        block.pbit[e] = pbits[e];
+        for (int c = 0; c < 4; c++) {
+            const int quantized = static_cast<int>((source[e][c] - static_cast<float>(pbits[e])) / 2.0f + 0.5f);
+            block.endpoint[e][c] = std::clamp(quantized, 0, 127);
+            value[e][c] = block.endpoint[e][c] << 1 | pbits[e];
+        }
+    }
+    float palette[16][4];
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 4; c++) {
+            palette[i][c] = static_cast<float>(((64 - BC7_WEIGHTS[i]) * value[0][c] + BC7_WEIGHTS[i] * value[1][c] +
+                                                32) >> 6);
+        }
+    }
+    return selectIndices(pixels, palette, 16, block.indices);
+}
+
+// Prueba las 4 combinaciones de p-bits y se queda con la mejor
+static float bestBC7(const BlockPixels &pixels, const float e0[4], const float e1[4], BC7Mode6 &best) {
+    float bestError = FLT_MAX;
+    for (int p = 0; p < 4; p++) {
+        BC7Mode6 candidate;
+        const float error = evaluateBC7(pixels, e0, e1, p & 1, p >> 1, candidate);
+        if (error < bestError) {
+            bestError = error;
+            best = candidate;
+        }
+    }
+    return bestError;
+}
+
+static void putBits(uint64_t bits[2], int &position, uint32_t value, int count) {
+    for (int i = 0; i < count; i++, position++) {
+        bits[position / 64] |= static_cast<uint64_t>(value >> i & 1) << (position % 64);
+    }
+}
+
+static uint32_t getBits(const uint64_t bits[2], int &position, int count) {
+    uint32_t value = 0;
+    for (int i = 0; i < count; i++, position++) {
+        value |= static_cast<uint32_t>(bits[position / 64] >> (position % 64) & 1) << i;
+    }
+    return value;
+}
+
+static void encodeBC7Block(const BlockPixels &pixels, uint8_t *out) {
+    float e0[4], e1[4];
+    axisEndpoints(pixels, 4, e0, e1);
+    BC7Mode6 block;
+    float error = bestBC7(pixels, e0, e1, block);
+
+    for (int iteration = 0; iteration < 2; iteration++) {
+        float t[16];
+        for (int p = 0; p < 16; p++) {
+            t[p] = static_cast<float>(BC7_WEIGHTS[block.indices[p]]) / 64.0f;
+        }
+        float r0[4], r1[4];
+        if (!refitEndpoints(pixels, 4, t, r0, r1)) {
+            break;
+        }
+        BC7Mode6 refined;
+        const float refinedError = bestBC7(pixels, r0, r1, refined);
+        if (refinedError >= error) {
+            break;
+        }
+        error = refinedError;
+        block = refined;
+    }
+
+    // El indice del pixel 0 se guarda con 3 bits: su bit alto debe ser 0
+    if (block.indices[0] >= 8) {
+        std::swap(block.endpoint[0], block.endpoint[1]);
+        std::swap(block.pbit[0], block.pbit[1]);
+        for (uint8_t &index: block.indices) {
+            index = static_cast<uint8_t>(15 - index);
+        }
+    }
+
+    uint64_t bits[2] = {};
+    int position = 0;
+    putBits(bits, position, 1u << 6, 7);
+    for (int c = 0; c < 4; c++) {
+        putBits(bits, position, block.endpoint[0][c], 7);
+        putBits(bits, position, block.endpoint[1][c], 7);
+    }
+    putBits(bits, position, block.pbit[0], 1);
+    putBits(bits, position, block.pbit[1], 1);
+    putBits(bits, position, block.indices[0], 3);
+    for (int p = 1; p < 16; p++) {
+        putBits(bits, position, block.indices[p], 4);
+    }
+    memcpy(out, bits, 16);
+}
+
+static void decodeBC7Block(const uint8_t *block, uint8_t pixels[16][4]) {
+    uint64_t bits[2];
+    memcpy(bits, block, 16);
+    int position = 0;
+    if (getBits(bits, position, 7) != 1u << 6) {
+        // Otros modos no los emite el codificador
+        memset(pixels, 0, 16 * 4);
+        return;
+    }
+    int endpoint[2][4];
+    for (int c = 0; c < 4; c++) {
+        endpoint[0][c] = static_cast<int>(getBits(bits, position, 7)) << 1;
+        endpoint[1][c] = static_cast<int>(getBits(bits, position, 7)) << 1;
+    }
+    const int p0 = static_cast<int>(getBits(bits, position, 1));
+    const int p1 = static_cast<int>(getBits(bits, position, 1));
+    for (int c = 0; c < 4; c++) {
+        endpoint[0][c] |= p0;
+        endpoint[1][c] |= p1;
+    }
+    for (int p = 0; p < 16; p++) {
+        const int weight = BC7_WEIGHTS[getBits(bits, position, p == 0 ? 3 : 4)];
+        for (int c = 0; c < 4; c++) {
+            pixels[p][c] = static_cast<uint8_t>(((64 - weight) * endpoint[0][c] + weight * endpoint[1][c] + 32) >> 6);
+        }
+    }
+}
+
+static void encodeBlock(BlockFormat format, const BlockPixels &pixels, uint8_t *out) {
+    BlockPixels channel;
+    switch (format) {
+        case BLOCK_FORMAT_BC1:
+            encodeBC1Block(pixels, out);
+            break;
+        case BLOCK_FORMAT_BC3:
+            singleChannel(pixels, 3, channel);
+            encodeBC4Block(channel, out);
+            encodeBC1Block(pixels, out + 8);
+            break;
+        case BLOCK_FORMAT_BC4:
+            singleChannel(pixels, 0, channel);
+            encodeBC4Block(channel, out);
+            break;
+        case BLOCK_FORMAT_BC5:
+            singleChannel(pixels, 0, channel);
+            encodeBC4Block(channel, out);
+            singleChannel(pixels, 1, channel);
+            encodeBC4Block(channel, out + 8);
+            break;
+        case BLOCK_FORMAT_BC7:
+            encodeBC7Block(pixels, out);
+            break;
+        default:
+            break;
+    }
+}
+
+static void decodeBlock(BlockFormat format, const uint8_t *block, uint8_t pixels[16][4]) {
+    memset(pixels, 0, 16 * 4);
+    switch (format) {
+        case BLOCK_FORMAT_BC1:
+            decodeBC1Block(block, pixels, 0);
+            break;
+        case BLOCK_FORMAT_BC3:
+            decodeBC4Block(block, pixels, 3);
+            decodeBC1Block(block + 8, pixels, 0);
+            return;
+        case BLOCK_FORMAT_BC4:
+            decodeBC4Block(block, pixels, 0);
+            break;
+        case BLOCK_FORMAT_BC5:
+            decodeBC4Block(block, pixels, 0);
+            decodeBC4Block(block + 8, pixels, 1);
+            break;
+        case BLOCK_FORMAT_BC7:
+            decodeBC7Block(block, pixels);
+            return;
+        default:
+            break;
+    }
+    for (int p = 0; p < 16; p++) {
+        pixels[p][3] = 255;
+    }
+}
+
+void compressImage(BlockFormat format, const uint8_t *rgba, int width, int height, uint8_t *out, JobSystem *jobs) {
+    const int blocksX = (width + 3) / 4;
+    const int blocksY = (height + 3) / 4;
+    const size_t blockBytes = blockFormatBlockBytes(format);
+
+    auto encodeRows = [&](uint32_t begin, uint32_t end) {
+        BlockPixels pixels;
+        for (uint32_t by = begin; by < end; by++) {
+            uint8_t *row = out + static_cast<size_t>(by) * blocksX * blockBytes;
+            for (int bx = 0; bx < blocksX; bx++) {
+                loadBlock(rgba, width, height, bx, static_cast<int>(by), pixels);
+                encodeBlock(format, pixels, row + bx * blockBytes);
+            }
+        }
+    };
+    if (jobs) {
+        jobs->parallelFor(0, static_cast<uint32_t>(blocksY), 1, encodeRows);
+    } else {
+        encodeRows(0, static_cast<uint32_t>(blocksY));
+    }
+}
+
+void decompressImage(BlockFormat format, const uint8_t *blocks, int width, int height, uint8_t *rgba) {
+    const int blocksX = (width + 3) / 4;
+    const int blocksY = (height + 3) / 4;
+    const size_t blockBytes = blockFormatBlockBytes(format);
+    uint8_t pixels[16][4];
+    for (int by = 0; by < blocksY; by++) {
+        for (int bx = 0; bx < blocksX; bx++) {
+            decodeBlock(format, blocks + (static_cast<size_t>(by) * blocksX + bx) * blockBytes, pixels);
+            for (int y = 0; y < 4 && by * 4 + y < height; y++) {
+                for (int x = 0; x < 4 && bx * 4 + x < width; x++) {
+                    memcpy(rgba + (static_cast<size_t>(by * 4 + y) * width + bx * 4 + x) * 4, pixels[y * 4 + x], 4);
+                }
+            }
+        }
+    }
+}
+
+double computePsnr(const uint8_t *reference, const uint8_t *test, size_t pixels, int channels) {
+    double squared = 0.0;
+    for (size_t p = 0; p < pixels; p++) {
+        for (int c = 0; c < channels; c++) {
+            const double d = static_cast<double>(reference[p * 4 + c]) - static_cast<double>(test[p * 4 + c]);
+            squared += d * d;
+        }
+    }
+    const double mse = squared / static_cast<double>(pixels * channels);
+    if (mse <= 0.0) {
+        return 99.0;
+    }
+    return 10.0 * std::log10(255.0 * 255.0 / mse);
+}
@@ -1,27 +1,77 @@
 #include "Camera.h"
 
 #include "ext/matrix_transform.hpp"
+#include "ext/matrix_clip_space.hpp"
 
-Camera::Camera(glm::vec3 position, glm::vec3 up, float yaw, float pitch) : position(position),
-                                                                           front(glm::vec3(.0f, .0f, -1.0f)), up(up),
-                                                                           // right(glm::normalize(glm::cross(front, up))),
-                                                                           worldUp(up),
+Camera::Camera(glm::vec3 position, glm::vec3 up, float yaw, float pitch) : movementSpeed(2.5f),
+                                                                           mouseSensitivity(0.2f),
+                                                                           position(position),
+                                                                           worldUp(glm::normalize(up)),
                                                                            yaw(yaw),
                                                                            pitch(pitch),
-                                                                           movementSpeed(2.5f),
-                                                                           mouseSensitivity(0.2f),
-                                                                           fov(45.0f) {
-    updateCameraVectors();
+                                                                           fov(45.0f),
+                                                                           aspectRatio(800.0f / 600.0f),
+                                                                           nearPlane(0.1f),
+                                                                           farPlane(100.0f),
+                                                                           version(0),
+                                                                           dirty(ORIENTATION_DIRTY | VIEW_DIRTY |
+                                                                                 PROJECTION_DIRTY |
+                                                                                 VIEW_PROJECTION_DIRTY) {
 }
 
 Camera::~Camera() {
 }
 
-glm::mat4 Camera::getViewMatrix() const {
-    return glm::lookAt(position, position + front, up);
+void Camera::markDirty(uint32_t flags) {
+    dirty |= flags | VIEW_PROJECTION_DIRTY;
+    version++;
+}
+
+const glm::mat4 &Camera::getViewMatrix() const {
+    updateView();
+    return view;
+}
+
+glm::mat4 Camera::getViewMatrix(const glm::vec3 &eyePosition) const {
+    updateOrientation();
+    // view = R^T * T(-eye): la rotacion ya esta cacheada, solo cambia la traslacion
+    glm::mat4 result = rotation;
+    result[3] = glm::vec4(-(glm::mat3(rotation) * eyePosition), 1.0f);
+    return result;
+}
+
+const glm::mat4 &Camera::getProjectionMatrix() const {
+    updateProjection();
+    return projection;
+}
+
+const glm::mat4 &Camera::getViewProjectionMatrix() const {
+    updateViewProjection();
+    return viewProjection;
+}
+
+const glm::mat4 &Camera::getInverseViewMatrix() const {
+    updateView();
+    return inverseView;
+}
+
+const glm::mat4 &Camera::getInverseProjectionMatrix() const {
+    updateProjection();
+    return inverseProjection;
+}
+
+const glm::mat4 &Camera::getInverseViewProjectionMatrix() const {
+    updateViewProjection();
+    return inverseViewProjection;
+}
+
+uint32_t Camera::getVersion() const {
+    return version;
 }
 
 void Camera::processKeyboard(Camera_Movement direction, float deltaTime) {
+    updateOrientation();
+
     const float velocity = movementSpeed * deltaTime;
     switch (direction) {
         case FORWARD:
@@ -37,6 +87,7 @@ void Camera::processKeyboard(Camera_Movement direction, float deltaTime) {
             position -= right * velocity;
             break;
     }
+    markDirty(VIEW_DIRTY);
 }
 
 void Camera::processMouse(float xOffset, float yOffset) {
@@ -53,17 +104,129 @@ void Camera::processMouse(float xOffset, float yOffset) {
         pitch = -89.0f;
     }
 
-    updateCameraVectors();
+    // No se recalcula nada aqui: varios eventos de raton por frame cuestan una sola actualizacion
+    markDirty(ORIENTATION_DIRTY | VIEW_DIRTY);
+}
+
+void Camera::lookAt(const glm::vec3 &target) {
+    const glm::vec3 direction = glm::normalize(target - position);
+    yaw = glm::degrees(atan2(direction.z, direction.x));
+    pitch = glm::degrees(asin(direction.y));
+
+    markDirty(ORIENTATION_DIRTY | VIEW_DIRTY);
+}
+
+const glm::vec3 &Camera::getPosition() const {
+    return position;
+}
+
+void Camera::setPosition(const glm::vec3 &position) {
+    this->position = position;
+    markDirty(VIEW_DIRTY);
+}
+
+const glm::quat &Camera::getOrientation() const {
+    updateOrientation();
+    return orientation;
+}
+
+const glm::vec3 &Camera::getFront() const {
+    updateOrientation();
+    return front;
+}
+
+const glm::vec3 &Camera::getRight() const {
+    updateOrientation();
+    return right;
+}
+
+const glm::vec3 &Camera::getUp() const {
+    updateOrientation();
+    return up;
+}
+
+float Camera::getYaw() const {
+    return yaw;
+}
+
+float Camera::getPitch() const {
+    return pitch;
+}
+
+float Camera::getFov() const {
+    return fov;
+}
+
+void Camera::setFov(float fov) {
+    if (fov != this->fov) {
+        this->fov = fov;
+        markDirty(PROJECTION_DIRTY);
+    }
+}
+
+void Camera::setAspectRatio(float aspectRatio) {
+    if (aspectRatio != this->aspectRatio) {
+        this->aspectRatio = aspectRatio;
+        markDirty(PROJECTION_DIRTY);
+    }
+}
+
+void Camera::setClipPlanes(float nearPlane, float farPlane) {
+    this->nearPlane = nearPlane;
+    this->farPlane = farPlane;
+    markDirty(PROJECTION_DIRTY);
+}
+
+// yaw gira alrededor de worldUp y pitch alrededor del eje X local. Con yaw = -90 y pitch = 0
+// la camara mira a -Z, igual que front = (cos(yaw)cos(pitch), sin(pitch), sin(yaw)cos(pitch)).
+void Camera::updateOrientation() const {
+    if (!(dirty & ORIENTATION_DIRTY)) {
+        return;
+    }
+    orientation = glm::angleAxis(glm::radians(-(yaw + 90.0f)), worldUp) *
+                  glm::angleAxis(glm::radians(pitch), glm::vec3(1.0f, 0.0f, 0.0f));
+
+    const glm::mat3 basis = glm::mat3_cast(orientation);
+    right = basis[0];
+    up = basis[1];
+    front = -basis[2];
+    // La inversa de una rotacion es su traspuesta
+    rotation = glm::mat4(glm::transpose(basis));
+
+    dirty &= ~ORIENTATION_DIRTY;
+}
+
+void Camera::updateView() const {
+    if (!(dirty & VIEW_DIRTY)) {
+        return;
+    }
+    updateOrientation();
+    view = getViewMatrix(position);
+
+    inverseView = glm::mat4(glm::transpose(glm::mat3(rotation)));
+    inverseView[3] = glm::vec4(position, 1.0f);
+
+    dirty &= ~VIEW_DIRTY;
+}
+
+void Camera::updateProjection() const {
+    if (!(dirty & PROJECTION_DIRTY)) {
+        return;
+    }
+    projection = glm::perspective(glm::radians(fov), aspectRatio, nearPlane, farPlane);
+    inverseProjection = glm::inverse(projection);
+
+    dirty &= ~PROJECTION_DIRTY;
 }
 
-// TODO explicar bien estos calculos, realizarlos a mano
-void Camera::updateCameraVectors() {
-    glm::vec3 newFront;
-    newFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
-    newFront.y = sin(glm::radians(pitch));
-    newFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
-    front = glm::normalize(newFront);
+void Camera::updateViewProjection() const {
+    if (!(dirty & VIEW_PROJECTION_DIRTY)) {
+        return;
+    }
+    updateView();
+    updateProjection();
+    viewProjection = projection * view;
+    inverseViewProjection = inverseView * inverseProjection;
 
-    right = glm::normalize(glm::cross(front, worldUp));
-    up = glm::normalize(glm::cross(right, front));
-}
\ No newline at end of file
+    dirty &= ~VIEW_PROJECTION_DIRTY;
+}
@@ -0,0 +1,15 @@
+#include "CameraPath.h"
+
+#include "Camera.h"
+
+#include <gtc/constants.hpp>
+
+CameraPath::CameraPath(glm::vec3 target, float radius, float height, float revolutions) : target(target),
+    radius(radius), height(height), revolutions(revolutions) {
+}
+
+void CameraPath::apply(Camera &camera, float t) const {
+    const float angle = t * revolutions * glm::two_pi<float>();
+    camera.setPosition(target + glm::vec3(radius * cos(angle), height * sin(angle * 2.0f), radius * sin(angle)));
+    camera.lookAt(target);
+}
@@ -0,0 +1,254 @@
+#include "CompressedTexture.h"
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "AssetFileSystem.h"
+
+// El loader de glad es 4.1 core sin extensiones: constantes de EXT_texture_compression_s3tc
+// y ARB_texture_compression_bptc
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+
+static constexpr uint32_t DDS_MAGIC = 0x20534444; // "DDS "
+static constexpr uint32_t DDSD_REQUIRED = 0x1 | 0x2 | 0x4 | 0x1000; // CAPS | HEIGHT | WIDTH | PIXELFORMAT
+static constexpr uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+static constexpr uint32_t DDSD_LINEARSIZE = 0x80000;
+static constexpr uint32_t DDPF_FOURCC = 0x4;
+static constexpr uint32_t DDSCAPS_COMPLEX = 0x8;
+static constexpr uint32_t DDSCAPS_TEXTURE = 0x1000;
+static constexpr uint32_t DDSCAPS_MIPMAP = 0x400000;
+static constexpr uint32_t DXGI_FORMAT_BC7_UNORM = 98;
+static constexpr uint32_t D3D10_RESOURCE_DIMENSION_TEXTURE2D = 3;
+// Limites de un DDS valido (GL_MAX_TEXTURE_SIZE habitual): la cabecera dimensiona las reservas
+static constexpr uint32_t DDS_MAX_SIZE = 16384;
+static constexpr uint32_t DDS_MAX_LEVELS = 15;
+
+struct DdsPixelFormat {
+    uint32_t size;
+    uint32_t flags;
+    uint32_t fourCC;
+    uint32_t rgbBitCount;
+    uint32_t masks[4];
+};
+
+struct DdsHeader {
+    uint32_t size;
+    uint32_t flags;
+    uint32_t height;
+    uint32_t width;
+    uint32_t pitchOrLinearSize;
+    uint32_t depth;
+    uint32_t mipMapCount;
+    uint32_t reserved1[11];
+    DdsPixelFormat pixelFormat;
+    uint32_t caps[4];
+    uint32_t reserved2;
+};
+
+struct DdsHeaderDx10 {
+    uint32_t dxgiFormat;
+    uint32_t resourceDimension;
+    uint32_t miscFlag;
+    uint32_t arraySize;
+    uint32_t miscFlags2;
+};
+
+static_assert(sizeof(DdsHeader) == 124, "DDS_HEADER debe ocupar 124 bytes");
+
+static constexpr uint32_t fourCC(const char code[5]) {
+    return static_cast<uint32_t>(code[0]) | static_cast<uint32_t>(code[1]) << 8 |
+           static_cast<uint32_t>(code[2]) << 16 | static_cast<uint32_t>(code[3]) << 24;
+}
+
+static const uint32_t FORMAT_FOURCC[BLOCK_FORMAT_COUNT] = {
+    fourCC("DXT1"), fourCC("DXT5"), fourCC("ATI1"), fourCC("ATI2"), fourCC("DX10")
+};
+
+bool writeDds(const std::string &path, const CompressedImage &image) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        printf("Unable to write %s\n", path.c_str());
+        return false;
+    }
+
+    DdsHeader header = {};
+    header.size = sizeof(DdsHeader);
+    header.flags = DDSD_REQUIRED | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+    header.height = static_cast<uint32_t>(image.height);
+    header.width = static_cast<uint32_t>(image.width);
+    header.pitchOrLinearSize = static_cast<uint32_t>(image.levels.empty() ? 0 : image.levels[0].size());
+    header.mipMapCount = static_cast<uint32_t>(image.levels.size());
+    header.pixelFormat.size = sizeof(DdsPixelFormat);
+    header.pixelFormat.flags = DDPF_FOURCC;
+    header.pixelFormat.fourCC = FORMAT_FOURCC[image.format];
+    header.caps[0] = DDSCAPS_TEXTURE | (image.levels.size() > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0);
+
+    file.write(reinterpret_cast<const char *>(&DDS_MAGIC), sizeof(DDS_MAGIC));
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    if (image.format == BLOCK_FORMAT_BC7) {
+        const DdsHeaderDx10 dx10 = {DXGI_FORMAT_BC7_UNORM, D3D10_RESOURCE_DIMENSION_TEXTURE2D, 0, 1, 0};
+        file.write(reinterpret_cast<const char *>(&dx10), sizeof(dx10));
+    }
+    for (const std::vector<uint8_t> &level: image.levels) {
+        file.write(reinterpret_cast<const char *>(level.data()), static_cast<std::streamsize>(level.size()));
+    }
+    return static_cast<bool>(file);
+}
+
+bool readDds(const std::string &path, CompressedImage &image) {
+    AssetData data;
+    if (!assetFileSystem().read(path, data)) {
+        printf("Unable to open %s\n", path.c_str());
+        return false;
+    }
+    size_t offset = 0;
+    const auto read = [&](void *destination, size_t bytes) {
+        if (bytes > data.size() - offset) {
+            return false;
+        }
+        memcpy(destination, data.data() + offset, bytes);
+        offset += bytes;
+        return true;
+    };
+
+    uint32_t magic = 0;
+    DdsHeader header = {};
+    if (!read(&magic, sizeof(magic)) || !read(&header, sizeof(header)) || magic != DDS_MAGIC ||
+        header.size != sizeof(DdsHeader) || !(header.pixelFormat.flags & DDPF_FOURCC)) {
+        printf("%s is not a block-compressed DDS file\n", path.c_str());
+        return false;
+    }
+
+    int format = 0;
+    while (format < BLOCK_FORMAT_COUNT && FORMAT_FOURCC[format] != header.pixelFormat.fourCC) {
+        format++;
+    }
+    if (format == BLOCK_FORMAT_BC7) {
+        DdsHeaderDx10 dx10 = {};
+        if (!read(&dx10, sizeof(dx10)) || dx10.dxgiFormat != DXGI_FORMAT_BC7_UNORM) {
+            printf("%s: unsupported DX10 format %u\n", path.c_str(), dx10.dxgiFormat);
+            return false;
+        }
+    } else if (format == BLOCK_FORMAT_COUNT) {
+        printf("%s: unsupported DDS FourCC 0x%08x\n", path.c_str(), header.pixelFormat.fourCC);
+        return false;
+    }
+
+    // Un fichero corrupto no puede pedir gigas ni desbordar int
+    uint32_t maxLevels = 1;
+    while (maxLevels < DDS_MAX_LEVELS && std::max(header.width, header.height) >> maxLevels) {
+        maxLevels++;
+    }
+    const uint32_t levelCount = header.flags & DDSD_MIPMAPCOUNT ? std::max(header.mipMapCount, 1u) : 1;
+    if (header.width == 0 || header.height == 0 || header.width > DDS_MAX_SIZE || header.height > DDS_MAX_SIZE ||
+        levelCount > maxLevels) {
+        printf("%s: invalid DDS size %ux%u with %u levels\n", path.c_str(), header.width, header.height, levelCount);
+        return false;
+    }
+
+    image.format = static_cast<BlockFormat>(format);
+    image.width = static_cast<int>(header.width);
+    image.height = static_cast<int>(header.height);
+    image.levels.resize(levelCount);
+    for (uint32_t level = 0; level < levelCount; level++) {
+        const int width = std::max(image.width >> level, 1);
+        const int height = std::max(image.height >> level, 1);
+        const size_t bytes = blockFormatLevelBytes(image.format, width, height);
+        if (bytes > data.size() - offset) {
+            printf("%s: truncated DDS file\n", path.c_str());
+            return false;
+        }
+        image.levels[level].resize(bytes);
+        if (!read(image.levels[level].data(), image.levels[level].size())) {
+            printf("%s: truncated DDS file\n", path.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+struct BlockFormatSupport {
+    bool s3tc = false;
+    bool bptc = false;
+};
+
+// Se consulta una vez, en la primera llamada: todos los contextos de la aplicacion son del mismo driver
+static const BlockFormatSupport &blockFormatSupport() {
+    static const BlockFormatSupport support = [] {
+        BlockFormatSupport result;
+        int count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (int i = 0; i < count; i++) {
+            const char *name = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+            if (!name) {
+                continue;
+            }
+            result.s3tc = result.s3tc || strcmp(name, "GL_EXT_texture_compression_s3tc") == 0;
+            result.bptc = result.bptc || strcmp(name, "GL_ARB_texture_compression_bptc") == 0;
+        }
+        return result;
+    }();
+    return support;
+}
+
+bool isBlockFormatSupported(BlockFormat format) {
+    switch (format) {
+        case BLOCK_FORMAT_BC1:
+        case BLOCK_FORMAT_BC3:
+            return blockFormatSupport().s3tc;
+        case BLOCK_FORMAT_BC4:
+        case BLOCK_FORMAT_BC5:
+            return true;
+        case BLOCK_FORMAT_BC7:
+            return blockFormatSupport().bptc;
+        default:
+            return false;
+    }
+}
+
+unsigned int blockFormatGLFormat(BlockFormat format) {
+    switch (format) {
+        case BLOCK_FORMAT_BC1: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+        case BLOCK_FORMAT_BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case BLOCK_FORMAT_BC4: return GL_COMPRESSED_RED_RGTC1;
+        case BLOCK_FORMAT_BC5: return GL_COMPRESSED_RG_RGTC2;
+        case BLOCK_FORMAT_BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+        default: return 0;
+    }
+}
+
+unsigned int createCompressedTexture(const CompressedImage &image) {
+    unsigned int texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                    image.levels.size() > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<int>(image.levels.size()) - 1);
+
+    const bool supported = isBlockFormatSupported(image.format);
+    std::vector<uint8_t> rgba;
+    for (size_t level = 0; level < image.levels.size(); level++) {
+        const int width = std::max(image.width >> level, 1);
+        const int height = std::max(image.height >> level, 1);
+        if (supported) {
+            glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<int>(level), blockFormatGLFormat(image.format), width,
+                                   height, 0, static_cast<int>(image.levels[level].size()),
+                                   image.levels[level].data());
+            continue;
+        }
+        rgba.resize(static_cast<size_t>(width) * height * 4);
+        decompressImage(image.format, image.levels[level].data(), width, height, rgba.data());
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexImage2D(GL_TEXTURE_2D, static_cast<int>(level), GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                     rgba.data());
+    }
+    return texture;
+}
@@ -0,0 +1,272 @@
+#include "ECS.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+static std::vector<ComponentInfo> &componentInfos() {
+    static std::vector<ComponentInfo> infos;
+    return infos;
+}
+
+static std::mutex registryMutex;
+
+ComponentId ComponentRegistry::registerComponent(size_t size, size_t alignment) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::vector<ComponentInfo> &infos = componentInfos();
+    if (infos.size() >= ECS_MAX_COMPONENTS) {
+        printf("ECS: more than %u component types registered\n", ECS_MAX_COMPONENTS);
+        abort();
+    }
+    // Se reserva de antemano para que info() nunca vea el vector realojado
+    infos.reserve(ECS_MAX_COMPONENTS);
+    infos.push_back({size, alignment});
+    return static_cast<ComponentId>(infos.size() - 1);
+}
+
+const ComponentInfo &ComponentRegistry::info(ComponentId id) {
+    return componentInfos()[id];
+}
+
+static size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+Archetype::Archetype(ComponentMask mask) : mask(mask), capacity(0), offsets{}, entityCount(0) {
+    std::fill(std::begin(offsets), std::end(offsets), UINT32_MAX);
+    size_t bytesPerEntity = sizeof(Entity);
+    for (ComponentId id = 0; id < ECS_MAX_COMPONENTS; id++) {
+        if (mask & (ComponentMask(1) << id)) {
+            components.push_back(id);
+            bytesPerEntity += ComponentRegistry::info(id).size;
+        }
+    }
+
+    // Cada array empieza en su propia linea de cache; se reduce la capacidad hasta que cabe todo
+    capacity = static_cast<uint32_t>(ECS_CHUNK_SIZE / bytesPerEntity);
+    while (capacity > 1) {
+        size_t offset = alignUp(sizeof(Entity) * capacity, ECS_CACHE_LINE);
+        for (const ComponentId id: components) {
+            const ComponentInfo &info = ComponentRegistry::info(id);
+            offset = alignUp(offset, std::max(info.alignment, ECS_CACHE_LINE));
+            offsets[id] = static_cast<uint32_t>(offset);
+            offset += info.size * capacity;
+        }
+        if (offset <= ECS_CHUNK_SIZE) {
+            break;
+        }
+        capacity--;
+    }
+}
+
+Archetype::~Archetype() {
+    for (const Chunk &chunk: chunks) {
+        ::operator delete(chunk.data, std::align_val_t(ECS_CACHE_LINE));
+    }
+}
+
+World::World() : entityCount(0), structureVersion(0) {
+}
+
+World::~World() {
+}
+
+Archetype *World::getArchetype(ComponentMask mask) {
+    const auto found = archetypes.find(mask);
+    if (found != archetypes.end()) {
+        return found->second.get();
+    }
+    auto archetype = std::make_unique<Archetype>(mask);
+    Archetype *pointer = archetype.get();
+    archetypes.emplace(mask, std::move(archetype));
+    archetypeList.push_back(pointer);
+    return pointer;
+}
+
+void World::allocateRow(Archetype *archetype, Entity entity, uint32_t &chunk, uint32_t &row) {
+    if (archetype->chunks.empty() || archetype->chunks.back().count == archetype->capacity) {
+        auto *data = static_cast<uint8_t *>(::operator new(ECS_CHUNK_SIZE, std::align_val_t(ECS_CACHE_LINE)));
+        archetype->chunks.push_back({data, 0});
+    }
+    Chunk &last = archetype->chunks.back();
+    chunk = static_cast<uint32_t>(archetype->chunks.size() - 1);
+    row = last.count++;
+    archetype->entities(last)[row] = entity;
+    archetype->entityCount++;
+}
+
+void World::removeRow(Archetype *archetype, uint32_t chunk, uint32_t row) {
+    Chunk &last = archetype->chunks.back();
+    const uint32_t lastChunk = static_cast<uint32_t>(archetype->chunks.size() - 1);
+    const uint32_t lastRow = last.count - 1;
+
+    if (chunk != lastChunk || row != lastRow) {
+        Chunk &target = archetype->chunks[chunk];
+        const Entity moved = archetype->entities(last)[lastRow];
+        archetype->entities(target)[row] = moved;
+        for (const ComponentId id: archetype->components) {
+            memcpy(archetype->component(target, id, row), archetype->component(last, id, lastRow),
+                   ComponentRegistry::info(id).size);
+        }
+        records[moved.index].chunk = chunk;
+        records[moved.index].row = row;
+    }
+
+    last.count--;
+    archetype->entityCount--;
+    if (last.count == 0) {
+        ::operator delete(last.data, std::align_val_t(ECS_CACHE_LINE));
+        archetype->chunks.pop_back();
+    }
+}
+
+Entity World::createEntity(ComponentMask mask) {
+    uint32_t index;
+    if (!freeIndices.empty()) {
+        index = freeIndices.back();
+        freeIndices.pop_back();
+    } else {
+        index = static_cast<uint32_t>(records.size());
+        records.push_back({nullptr, 0, 0, 0});
+    }
+
+    EntityRecord &record = records[index];
+    const Entity entity = {index, record.generation};
+    record.archetype = getArchetype(mask);
+    allocateRow(record.archetype, entity, record.chunk, record.row);
+    entityCount++;
+    structureVersion++;
+    return entity;
+}
+
+void World::destroy(Entity entity) {
+    if (!isAlive(entity)) {
+        return;
+    }
+    EntityRecord &record = records[entity.index];
+    removeRow(record.archetype, record.chunk, record.row);
+    record.archetype = nullptr;
+    record.generation++;
+    freeIndices.push_back(entity.index);
+    entityCount--;
+    structureVersion++;
+}
+
+bool World::isAlive(Entity entity) const {
+    return entity.index < records.size() && records[entity.index].archetype &&
+           records[entity.index].generation == entity.generation;
+}
+
+void World::moveEntity(Entity entity, ComponentMask mask) {
+    EntityRecord &record = records[entity.index];
+    Archetype *from = record.archetype;
+    if (from->mask == mask) {
+        return;
+    }
+    Archetype *to = getArchetype(mask);
+
+    uint32_t chunk, row;
+    allocateRow(to, entity, chunk, row);
+    // Copiar los componentes comunes; los nuevos quedan sin inicializar hasta set()
+    for (const ComponentId id: from->components) {
+        if (to->offsets[id] != UINT32_MAX) {
+            memcpy(to->component(to->chunks[chunk], id, row), from->component(from->chunks[record.chunk], id, record.row),
+                   ComponentRegistry::info(id).size);
+        }
+    }
+    removeRow(from, record.chunk, record.row);
+
+    record.archetype = to;
+    record.chunk = chunk;
+    record.row = row;
+    structureVersion++;
+}
+
+void *World::component(Entity entity, ComponentId id) {
+    const EntityRecord &record = records[entity.index];
+    return record.archetype->component(record.archetype->chunks[record.chunk], id, record.row);
+}
+
+size_t World::getEntityCount() const {
+    return entityCount;
+}
+
+uint32_t World::getArchetypeVersion() const {
+    return static_cast<uint32_t>(archetypeList.size());
+}
+
+uint32_t World::getStructureVersion() const {
+    return structureVersion;
+}
+
+const std::vector<Archetype *> &World::getArchetypes() const {
+    return archetypeList;
+}
+
+void CommandBuffer::begin(CommandType type, Entity entity, ComponentMask mask, uint32_t componentCount) {
+    const CommandHeader header = {type, componentCount, entity, mask};
+    const size_t offset = bytes.size();
+    bytes.resize(offset + sizeof(header));
+    memcpy(bytes.data() + offset, &header, sizeof(header));
+    commandCount++;
+}
+
+void CommandBuffer::write(ComponentId id, const void *data, size_t size) {
+    const size_t offset = bytes.size();
+    bytes.resize(offset + sizeof(id) + size);
+    memcpy(bytes.data() + offset, &id, sizeof(id));
+    memcpy(bytes.data() + offset + sizeof(id), data, size);
+}
+
+void CommandBuffer::destroy(Entity entity) {
+    begin(ECS_COMMAND_DESTROY, entity, 0, 0);
+}
+
+void CommandBuffer::apply(World &world) {
+    size_t offset = 0;
+    while (offset < bytes.size()) {
+        CommandHeader header;
+        memcpy(&header, bytes.data() + offset, sizeof(header));
+        offset += sizeof(header);
+
+        // Una entidad destruida antes en el mismo buffer se salta, pero sus componentes hay que recorrerlos
+        Entity target = header.entity;
+        switch (header.type) {
+            case ECS_COMMAND_CREATE:
+                target = world.createEntity(header.mask);
+                break;
+            case ECS_COMMAND_DESTROY:
+                world.destroy(header.entity);
+                break;
+            case ECS_COMMAND_ADD:
+                if (world.isAlive(target)) {
+                    world.moveEntity(target, world.records[target.index].archetype->mask | header.mask);
+                }
+                break;
+            case ECS_COMMAND_REMOVE:
+                if (world.isAlive(target)) {
+                    world.moveEntity(target, world.records[target.index].archetype->mask & ~header.mask);
+                }
+                break;
+        }
+        const bool alive = world.isAlive(target);
+        for (uint32_t i = 0; i < header.componentCount; i++) {
+            ComponentId id;
+            memcpy(&id, bytes.data() + offset, sizeof(id));
+            offset += sizeof(id);
+            const size_t size = ComponentRegistry::info(id).size;
+            if (alive) {
+                memcpy(world.component(target, id), bytes.data() + offset, size);
+            }
+            offset += size;
+        }
+    }
+    bytes.clear();
+    commandCount = 0;
+}
+
+size_t CommandBuffer::size() const {
+    return commandCount;
+}
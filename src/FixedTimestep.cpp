@@ -0,0 +1,49 @@
+#include "FixedTimestep.h"
+
+#include <algorithm>
+
+FixedTimestep::FixedTimestep(float tickRate, int maxTicksPerFrame) : step(1.0f / tickRate), accumulator(0.0f),
+                                                                     maxTicksPerFrame(maxTicksPerFrame), frames(0),
+                                                                     totalTicks(0), droppedTicks(0), peakTicks(0) {
+}
+
+int FixedTimestep::advance(float frameDelta) {
+    accumulator += frameDelta;
+
+    int ticks = static_cast<int>(accumulator / step);
+    accumulator -= static_cast<float>(ticks) * step;
+    if (ticks > maxTicksPerFrame) {
+        droppedTicks += ticks - maxTicksPerFrame;
+        ticks = maxTicksPerFrame;
+    }
+
+    frames++;
+    totalTicks += ticks;
+    peakTicks = std::max(peakTicks, ticks);
+    return ticks;
+}
+
+float FixedTimestep::getStep() const {
+    return step;
+}
+
+float FixedTimestep::getAlpha() const {
+    return std::clamp(accumulator / step, 0.0f, 1.0f);
+}
+
+void FixedTimestep::setTickRate(float tickRate) {
+    step = 1.0f / tickRate;
+    accumulator = 0.0f;
+}
+
+float FixedTimestep::getAverageTicksPerFrame() const {
+    return frames ? static_cast<float>(totalTicks) / static_cast<float>(frames) : 0.0f;
+}
+
+int FixedTimestep::getPeakTicksPerFrame() const {
+    return peakTicks;
+}
+
+uint64_t FixedTimestep::getDroppedTicks() const {
+    return droppedTicks;
+}
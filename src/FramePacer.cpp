@@ -0,0 +1,117 @@
+#include "FramePacer.h"
+
+#include <SDL3/SDL.h>
+#include <algorithm>
+
+// Margen que se resuelve con espera activa: el sleep del SO no es mas preciso que esto
+static constexpr uint64_t SPIN_THRESHOLD_NS = 2000000;
+
+FramePacer::FramePacer() : mode(PACING_VSYNC), targetFrameNS(0), maxFramesInFlight(2), nextFrameNS(0), deltas{},
+                           smoothingFrames(1), deltaCount(0), deltaIndex(0), fenceWaitNS(0), limiterWaitNS(0) {
+}
+
+FramePacer::~FramePacer() {
+    for (const GLsync fence: fences) {
+        glDeleteSync(fence);
+    }
+}
+
+void FramePacer::begin(PacingMode mode, int targetFps, int maxFramesInFlight, int smoothingFrames,
+                       bool hasSwapChain) {
+    this->mode = mode;
+    this->maxFramesInFlight = std::clamp(maxFramesInFlight, 1, 3);
+    this->smoothingFrames = std::clamp(smoothingFrames, 1, MAX_SMOOTHING_FRAMES);
+    targetFrameNS = targetFps > 0 ? 1000000000ull / targetFps : 0;
+    nextFrameNS = SDL_GetTicksNS() + targetFrameNS;
+
+    if (!hasSwapChain) {
+        return;
+    }
+
+    int interval = 1;
+    if (mode == PACING_ADAPTIVE_VSYNC) {
+        interval = -1;
+    } else if (mode == PACING_UNCAPPED || mode == PACING_LIMITED) {
+        interval = 0;
+    }
+
+    if (!SDL_GL_SetSwapInterval(interval)) {
+        SDL_Log("Swap interval %d not supported (%s), falling back to vsync", interval, SDL_GetError());
+        this->mode = PACING_VSYNC;
+        SDL_GL_SetSwapInterval(1);
+    }
+}
+
+void FramePacer::waitForFrameSlot() {
+    while (static_cast<int>(fences.size()) >= maxFramesInFlight) {
+        const GLsync fence = fences.front();
+        fences.pop_front();
+
+        const uint64_t start = SDL_GetTicksNS();
+        // GL_SYNC_FLUSH_COMMANDS_BIT evita esperar a una fence que nunca llego a enviarse
+        GLenum result;
+        do {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000);
+        } while (result == GL_TIMEOUT_EXPIRED);
+        fenceWaitNS += SDL_GetTicksNS() - start;
+
+        glDeleteSync(fence);
+    }
+}
+
+void FramePacer::endFrame() {
+    fences.push_back(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+
+    if (mode != PACING_LIMITED || targetFrameNS == 0) {
+        return;
+    }
+
+    const uint64_t start = SDL_GetTicksNS();
+    if (start < nextFrameNS) {
+        const uint64_t remaining = nextFrameNS - start;
+        if (remaining > SPIN_THRESHOLD_NS) {
+            SDL_DelayNS(remaining - SPIN_THRESHOLD_NS);
+        }
+        while (SDL_GetTicksNS() < nextFrameNS) {
+        }
+        nextFrameNS += targetFrameNS;
+    } else {
+        // Vamos tarde: reanclar en lugar de encadenar frames sin espera para recuperar
+        nextFrameNS = start + targetFrameNS;
+    }
+    limiterWaitNS += SDL_GetTicksNS() - start;
+}
+
+float FramePacer::smoothDelta(float rawDelta) {
+    deltas[deltaIndex] = std::clamp(rawDelta, 0.0f, MAX_DELTA);
+    deltaIndex = (deltaIndex + 1) % smoothingFrames;
+    deltaCount = std::min(deltaCount + 1, smoothingFrames);
+
+    float sum = 0.0f;
+    for (int i = 0; i < deltaCount; i++) {
+        sum += deltas[i];
+    }
+    return sum / static_cast<float>(deltaCount);
+}
+
+double FramePacer::getFenceWaitMs() const {
+    return static_cast<double>(fenceWaitNS) / 1000000.0;
+}
+
+double FramePacer::getLimiterWaitMs() const {
+    return static_cast<double>(limiterWaitNS) / 1000000.0;
+}
+
+const char *FramePacer::modeName(PacingMode mode) {
+    switch (mode) {
+        case PACING_VSYNC:
+            return "vsync";
+        case PACING_ADAPTIVE_VSYNC:
+            return "adaptive";
+        case PACING_UNCAPPED:
+            return "uncapped";
+        case PACING_LIMITED:
+            return "limit";
+    }
+    return "unknown";
+}
@@ -0,0 +1,215 @@
+#include "GpuLoader.h"
+
+#include "Shader.h"
+#include "SurfaceUpload.h"
+
+GpuLoader::GpuLoader() : shared{}, running(false), stopping(false), signal(0), pendingCount(0) {
+}
+
+GpuLoader::~GpuLoader() {
+    stop();
+}
+
+void GpuLoader::start(const RenderTarget &shared) {
+    this->shared = shared;
+    stopping = false;
+    running = true;
+    thread = std::jthread(&GpuLoader::threadLoop, this);
+}
+
+GpuResourceId GpuLoader::load(GpuResourceType type, CreateFunction create) {
+    GpuResourceId id;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        id = static_cast<GpuResourceId>(resources.size());
+        resources.emplace_back().type = type;
+        tasks.push_back({id, std::move(create)});
+    }
+    pendingCount++;
+    signal.fetch_add(1, std::memory_order_release);
+    signal.notify_one();
+    return id;
+}
+
+GpuResourceId GpuLoader::loadTexture(SDL_Surface *surface) {
+    return load(GPU_RESOURCE_TEXTURE, [surface]() {
+        unsigned int texture;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        uploadSurface(surface, 0);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        SDL_DestroySurface(surface);
+        return texture;
+    });
+}
+
+GpuResourceId GpuLoader::loadBuffer(unsigned int target, std::vector<uint8_t> data) {
+    return load(GPU_RESOURCE_BUFFER, [target, data = std::move(data)]() {
+        unsigned int buffer;
+        glGenBuffers(1, &buffer);
+        glBindBuffer(target, buffer);
+        glBufferData(target, static_cast<GLsizeiptr>(data.size()), data.data(), GL_STATIC_DRAW);
+        glBindBuffer(target, 0);
+        return buffer;
+    });
+}
+
+GpuResourceId GpuLoader::loadProgram(const std::string &vertexPath, const std::string &fragmentPath) {
+    return load(GPU_RESOURCE_PROGRAM, [vertexPath, fragmentPath]() {
+        const Shader shader(vertexPath.c_str(), fragmentPath.c_str());
+        return shader.id;
+    });
+}
+
+void GpuLoader::threadLoop() {
+    if (shared.headless) {
+        shared.headless->makeCurrent();
+    } else {
+        SDL_GL_MakeCurrent(shared.window, shared.context);
+    }
+
+    for (;;) {
+        const uint32_t observed = signal.load(std::memory_order_acquire);
+        Task task;
+        bool found = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!tasks.empty()) {
+                task = std::move(tasks.front());
+                tasks.pop_front();
+                found = true;
+            } else if (stopping) {
+                break;
+            }
+        }
+        if (!found) {
+            signal.wait(observed, std::memory_order_acquire);
+            continue;
+        }
+
+        const unsigned int name = task.create();
+        // El flush es necesario para que la fence avance vista desde el otro contexto
+        const GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        Resource &created = resources[task.id];
+        created.name = name;
+        created.fence = fence;
+        fenced.push_back(task.id);
+    }
+
+    if (shared.headless) {
+        shared.headless->releaseCurrent();
+    } else {
+        SDL_GL_MakeCurrent(shared.window, nullptr);
+    }
+}
+
+size_t GpuLoader::publish() {
+    std::vector<GpuResourceId> candidates;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        candidates.swap(fenced);
+    }
+
+    size_t published = 0;
+    std::vector<GpuResourceId> waiting;
+    for (const GpuResourceId id: candidates) {
+        Resource &created = resource(id);
+        if (glClientWaitSync(created.fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+            waiting.push_back(id);
+            continue;
+        }
+        glDeleteSync(created.fence);
+        created.fence = nullptr;
+        created.ready.store(true, std::memory_order_release);
+        pendingCount--;
+        published++;
+    }
+
+    if (!waiting.empty()) {
+        std::lock_guard<std::mutex> lock(mutex);
+        fenced.insert(fenced.end(), waiting.begin(), waiting.end());
+    }
+    return published;
+}
+
+GpuLoader::Resource &GpuLoader::resource(GpuResourceId id) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return const_cast<Resource &>(resources[id]);
+}
+
+unsigned int GpuLoader::get(GpuResourceId id) const {
+    const Resource &created = resource(id);
+    return created.ready.load(std::memory_order_acquire) ? created.name : 0;
+}
+
+bool GpuLoader::isReady(GpuResourceId id) const {
+    return resource(id).ready.load(std::memory_order_acquire);
+}
+
+bool GpuLoader::isRunning() const {
+    return running;
+}
+
+size_t GpuLoader::getPendingCount() const {
+    return pendingCount;
+}
+
+void GpuLoader::stop() {
+    if (!running) {
+        return;
+    }
+    running = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    signal.fetch_add(1, std::memory_order_release);
+    signal.notify_one();
+    thread.join();
+}
+
+static void deleteResource(GpuResourceType type, unsigned int name) {
+    switch (type) {
+        case GPU_RESOURCE_TEXTURE:
+            glDeleteTextures(1, &name);
+            break;
+        case GPU_RESOURCE_BUFFER:
+            glDeleteBuffers(1, &name);
+            break;
+        case GPU_RESOURCE_PROGRAM:
+            glDeleteProgram(name);
+            break;
+    }
+}
+
+void GpuLoader::release(GpuResourceId id) {
+    Resource &created = resource(id);
+    if (!created.ready || !created.name) {
+        return;
+    }
+    deleteResource(created.type, created.name);
+    created.name = 0;
+}
+
+void GpuLoader::destroy() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (Resource &created: resources) {
+        if (created.fence) {
+            glDeleteSync(created.fence);
+            created.fence = nullptr;
+        }
+        if (created.name) {
+            deleteResource(created.type, created.name);
+            created.name = 0;
+        }
+    }
+    fenced.clear();
+}
@@ -0,0 +1,268 @@
+#include "HeadlessContext.h"
+
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <glad/glad.h>
+
+#ifdef SDL_OGL_HAS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+HeadlessContext::HeadlessContext() : display(nullptr), config(nullptr), context(nullptr), surface(nullptr),
+                                     ownsDisplay(false), minorVersion(0), width(0), height(0), fbo(0), colorRbo(0), depthRbo(0) {
+}
+
+HeadlessContext::~HeadlessContext() {
+    destroy();
+}
+
+#ifdef SDL_OGL_HAS_EGL
+
+static bool hasExtension(const char *extensions, const char *name) {
+    if (!extensions) {
+        return false;
+    }
+    const size_t length = strlen(name);
+    for (const char *p = strstr(extensions, name); p; p = strstr(p + length, name)) {
+        if ((p == extensions || p[-1] == ' ') && (p[length] == ' ' || p[length] == '\0')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Perfil core 4.minor; EGL_NO_CONTEXT si el driver no da esa version
+static EGLContext createContext(EGLDisplay display, EGLConfig config, EGLContext share, int minor) {
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 4,
+        EGL_CONTEXT_MINOR_VERSION, minor,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    return eglCreateContext(display, config, share, contextAttribs);
+}
+
+bool HeadlessContext::create(int width, int height) {
+    this->width = width;
+    this->height = height;
+
+    // Preferir la plataforma surfaceless de Mesa: no necesita X11/Wayland ni GPU
+    EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+    const char *clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+        auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+            eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (getPlatformDisplay) {
+            eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        }
+    }
+    if (eglDisplay == EGL_NO_DISPLAY) {
+        eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+
+    EGLint major, minor;
+    if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor)) {
+        printf("Unable to initialize EGL display! EGL Error: 0x%x\n", eglGetError());
+        return false;
+    }
+    display = eglDisplay;
+    ownsDisplay = true;
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        printf("EGL does not support desktop OpenGL! EGL Error: 0x%x\n", eglGetError());
+        destroy();
+        return false;
+    }
+
+    const bool surfaceless = hasExtension(eglQueryString(eglDisplay, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context");
+
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, surfaceless ? 0 : EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_DEPTH_SIZE, 24,
+        EGL_NONE
+    };
+    EGLConfig eglConfig = nullptr;
+    EGLint numConfigs = 0;
+    if (!eglChooseConfig(eglDisplay, configAttribs, &eglConfig, 1, &numConfigs) || numConfigs == 0) {
+        printf("No suitable EGL config! EGL Error: 0x%x\n", eglGetError());
+        destroy();
+        return false;
+    }
+    config = eglConfig;
+
+    // Mismo perfil/versiones que el contexto de ventana en initWindow
+    for (const int minor: {6, 1}) {
+        context = createContext(eglDisplay, eglConfig, EGL_NO_CONTEXT, minor);
+        if (context) {
+            minorVersion = minor;
+            break;
+        }
+    }
+    if (!context) {
+        printf("Couldn't create EGL context! EGL Error: 0x%x\n", eglGetError());
+        destroy();
+        return false;
+    }
+
+    if (!surfaceless) {
+        // Fallback: pbuffer minimo, el render real va igualmente al FBO
+        const EGLint pbufferAttribs[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+        surface = eglCreatePbufferSurface(eglDisplay, eglConfig, pbufferAttribs);
+        if (!surface) {
+            printf("Couldn't create EGL pbuffer! EGL Error: 0x%x\n", eglGetError());
+            destroy();
+            return false;
+        }
+    }
+
+    if (!makeCurrent()) {
+        printf("Couldn't make EGL context current! EGL Error: 0x%x\n", eglGetError());
+        destroy();
+        return false;
+    }
+
+    if (!gladLoadGLLoader((GLADloadproc) eglGetProcAddress)) {
+        printf("Couldn't load GLAD functions through EGL\n");
+        destroy();
+        return false;
+    }
+
+    return createFramebuffer();
+}
+
+bool HeadlessContext::createShared(const HeadlessContext &share) {
+    width = share.width;
+    height = share.height;
+    display = share.display;
+    config = share.config;
+    ownsDisplay = false;
+
+    // Misma version que create(); el objeto compartido es el contexto de share
+    minorVersion = share.minorVersion;
+    context = createContext(display, config, share.context, minorVersion);
+    if (!context) {
+        printf("Couldn't create shared EGL context! EGL Error: 0x%x\n", eglGetError());
+        destroy();
+        return false;
+    }
+
+    if (share.surface) {
+        const EGLint pbufferAttribs[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+        surface = eglCreatePbufferSurface(display, config, pbufferAttribs);
+        if (!surface) {
+            printf("Couldn't create EGL pbuffer! EGL Error: 0x%x\n", eglGetError());
+            destroy();
+            return false;
+        }
+    }
+    return true;
+}
+
+void HeadlessContext::destroy() {
+    if (!display) {
+        return;
+    }
+    if (context && eglGetCurrentContext() == context) {
+        if (fbo) {
+            glDeleteFramebuffers(1, &fbo);
+            glDeleteRenderbuffers(1, &colorRbo);
+            glDeleteRenderbuffers(1, &depthRbo);
+        }
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    }
+    fbo = colorRbo = depthRbo = 0;
+
+    if (surface) {
+        eglDestroySurface(display, surface);
+        surface = nullptr;
+    }
+    if (context) {
+        eglDestroyContext(display, context);
+        context = nullptr;
+    }
+    if (ownsDisplay) {
+        eglTerminate(display);
+    }
+    display = nullptr;
+    config = nullptr;
+}
+
+bool HeadlessContext::makeCurrent() const {
+    const EGLSurface eglSurface = surface ? surface : EGL_NO_SURFACE;
+    return eglMakeCurrent(display, eglSurface, eglSurface, context) == EGL_TRUE;
+}
+
+void HeadlessContext::releaseCurrent() const {
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+}
+
+#else
+
+bool HeadlessContext::create(int width, int height) {
+    this->width = width;
+    this->height = height;
+    printf("Headless mode not available: built without EGL support\n");
+    return false;
+}
+
+bool HeadlessContext::createShared(const HeadlessContext &) {
+    return false;
+}
+
+void HeadlessContext::destroy() {
+}
+
+bool HeadlessContext::makeCurrent() const {
+    return false;
+}
+
+void HeadlessContext::releaseCurrent() const {
+}
+
+#endif
+
+bool HeadlessContext::createFramebuffer() {
+    glGenRenderbuffers(1, &colorRbo);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorRbo);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+    glGenRenderbuffers(1, &depthRbo);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRbo);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRbo);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        printf("Offscreen framebuffer incomplete (%dx%d)\n", width, height);
+        return false;
+    }
+
+    glViewport(0, 0, width, height);
+    return true;
+}
+
+void HeadlessContext::bindFramebuffer() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, width, height);
+}
+
+unsigned int HeadlessContext::getFramebuffer() const {
+    return fbo;
+}
+
+int HeadlessContext::getWidth() const {
+    return width;
+}
+
+int HeadlessContext::getHeight() const {
+    return height;
+}
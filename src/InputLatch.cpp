@@ -0,0 +1,107 @@
+#include "InputLatch.h"
+
+#include <algorithm>
+
+void InputLatch::addEvent(const InputEvent &event) {
+    frameEvents.push_back(event);
+    if (event.type == INPUT_RECORD_MOUSE_MOTION) {
+        mouseX += event.xrel;
+        mouseY += event.yrel;
+        mousePending = true;
+    }
+}
+
+void InputLatch::addMouseMotion(const SDL_MouseMotionEvent &motion) {
+    InputEvent event = {};
+    event.type = INPUT_RECORD_MOUSE_MOTION;
+    event.timestamp = motion.timestamp;
+    event.xrel = motion.xrel;
+    event.yrel = motion.yrel;
+    addEvent(event);
+}
+
+void InputLatch::addKey(const SDL_KeyboardEvent &key) {
+    if (key.repeat) {
+        return;
+    }
+    InputEvent event = {};
+    event.type = INPUT_RECORD_KEY;
+    event.timestamp = key.timestamp;
+    event.scancode = static_cast<uint16_t>(key.scancode);
+    event.down = key.down;
+    addEvent(event);
+}
+
+float InputLatch::heldFraction(SDL_Scancode scancode, uint64_t beginNS, uint64_t endNS) const {
+    bool down = keys[scancode];
+    if (endNS <= beginNS) {
+        // Intervalo vacio: vale el estado al final del frame
+        for (const InputEvent &event: frameEvents) {
+            if (event.type == INPUT_RECORD_KEY && event.scancode == scancode) {
+                down = event.down;
+            }
+        }
+        return down ? 1.0f : 0.0f;
+    }
+
+    // Integrar los tramos pulsados dentro de [beginNS, endNS]
+    uint64_t held = 0;
+    uint64_t cursor = beginNS;
+    for (const InputEvent &event: frameEvents) {
+        if (event.type != INPUT_RECORD_KEY || event.scancode != scancode) {
+            continue;
+        }
+        const uint64_t at = std::clamp(event.timestamp, beginNS, endNS);
+        if (down && at > cursor) {
+            held += at - cursor;
+        }
+        cursor = std::max(cursor, at);
+        down = event.down;
+    }
+    if (down) {
+        held += endNS - cursor;
+    }
+    return static_cast<float>(static_cast<double>(held) / static_cast<double>(endNS - beginNS));
+}
+
+bool InputLatch::takeMouseDelta(float &xOffset, float &yOffset) {
+    if (!mousePending) {
+        return false;
+    }
+    xOffset = mouseX;
+    yOffset = mouseY;
+    mouseX = mouseY = 0.0f;
+    mousePending = false;
+    return true;
+}
+
+const std::vector<InputEvent> &InputLatch::getFrameEvents() const {
+    return frameEvents;
+}
+
+uint64_t InputLatch::getOldestEventNS() const {
+    uint64_t oldest = 0;
+    for (const InputEvent &event: frameEvents) {
+        if (oldest == 0 || event.timestamp < oldest) {
+            oldest = event.timestamp;
+        }
+    }
+    return oldest;
+}
+
+uint64_t InputLatch::getNewestEventNS() const {
+    uint64_t newest = 0;
+    for (const InputEvent &event: frameEvents) {
+        newest = std::max(newest, event.timestamp);
+    }
+    return newest;
+}
+
+void InputLatch::endFrame() {
+    for (const InputEvent &event: frameEvents) {
+        if (event.type == INPUT_RECORD_KEY && event.scancode < SDL_SCANCODE_COUNT) {
+            keys[event.scancode] = event.down;
+        }
+    }
+    frameEvents.clear();
+}
@@ -0,0 +1,125 @@
+#include "InputRecording.h"
+
+#include <cstdio>
+#include <cstring>
+
+static constexpr char MAGIC[4] = {'S', 'O', 'I', 'R'};
+static constexpr uint32_t VERSION = 2;
+
+template<typename T>
+static void writeValue(std::ofstream &file, const T &value) {
+    file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template<typename T>
+static bool readValue(std::ifstream &file, T &value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+bool InputRecorder::open(const std::string &path) {
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        printf("Unable to open input recording %s for writing\n", path.c_str());
+        return false;
+    }
+    file.write(MAGIC, sizeof(MAGIC));
+    writeValue(file, VERSION);
+    frameCount = 0;
+    return true;
+}
+
+void InputRecorder::close() {
+    if (file.is_open()) {
+        file.close();
+    }
+}
+
+void InputRecorder::recordEvent(const InputEvent &event) {
+    writeValue(file, event.type);
+    writeValue(file, event.timestamp);
+    if (event.type == INPUT_RECORD_MOUSE_MOTION) {
+        writeValue(file, event.xrel);
+        writeValue(file, event.yrel);
+    } else {
+        writeValue(file, event.scancode);
+        writeValue(file, static_cast<uint8_t>(event.down));
+    }
+}
+
+void InputRecorder::recordFrame(float deltaTime, uint64_t frameStartNS, uint64_t frameEndNS) {
+    writeValue(file, INPUT_RECORD_FRAME);
+    writeValue(file, deltaTime);
+    writeValue(file, frameStartNS);
+    writeValue(file, frameEndNS);
+    frameCount++;
+}
+
+uint32_t InputRecorder::getFrameCount() const {
+    return frameCount;
+}
+
+bool InputReplay::open(const std::string &path) {
+    file.open(path, std::ios::binary);
+    if (!file) {
+        printf("Unable to open input recording %s\n", path.c_str());
+        return false;
+    }
+
+    char magic[4];
+    uint32_t version = 0;
+    if (!file.read(magic, sizeof(magic)) || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        !readValue(file, version) || version != VERSION) {
+        printf("Invalid input recording %s\n", path.c_str());
+        file.close();
+        return false;
+    }
+    frameCount = 0;
+    return true;
+}
+
+bool InputReplay::nextFrame(float &deltaTime, uint64_t &frameStartNS, uint64_t &frameEndNS) {
+    events.clear();
+
+    uint8_t type;
+    while (readValue(file, type)) {
+        InputEvent event = {};
+        event.type = static_cast<InputRecordType>(type);
+
+        switch (event.type) {
+            case INPUT_RECORD_MOUSE_MOTION:
+                if (!readValue(file, event.timestamp) || !readValue(file, event.xrel) ||
+                    !readValue(file, event.yrel)) {
+                    return false;
+                }
+                events.push_back(event);
+                break;
+            case INPUT_RECORD_KEY: {
+                uint8_t down = 0;
+                if (!readValue(file, event.timestamp) || !readValue(file, event.scancode) || !readValue(file, down)) {
+                    return false;
+                }
+                event.down = down != 0;
+                events.push_back(event);
+                break;
+            }
+            case INPUT_RECORD_FRAME:
+                if (!readValue(file, deltaTime) || !readValue(file, frameStartNS) || !readValue(file, frameEndNS)) {
+                    return false;
+                }
+                frameCount++;
+                return true;
+            default:
+                printf("Corrupt input recording: unknown record type %d\n", type);
+                return false;
+        }
+    }
+    return false;
+}
+
+const std::vector<InputEvent> &InputReplay::getEvents() const {
+    return events;
+}
+
+uint32_t InputReplay::getFrameCount() const {
+    return frameCount;
+}
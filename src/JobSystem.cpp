@@ -0,0 +1,310 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define JOB_PAUSE() _mm_pause()
+#else
+#define JOB_PAUSE() std::this_thread::yield()
+#endif
+
+// Intentos de robo antes de dormir un worker
+static constexpr int SPIN_ATTEMPTS = 64;
+
+// Solo en los hilos que crea un JobSystem; el worker 0 se reconoce por JobSystem::owner
+static thread_local const JobSystem *currentSystem = nullptr;
+static thread_local int currentIndex = -1;
+
+void JobDeque::Slot::store(const Job &job) {
+    function.store(job.function, std::memory_order_relaxed);
+    data.store(job.data, std::memory_order_relaxed);
+    begin.store(job.begin, std::memory_order_relaxed);
+    end.store(job.end, std::memory_order_relaxed);
+    grain.store(job.grain, std::memory_order_relaxed);
+    counter.store(job.counter, std::memory_order_relaxed);
+}
+
+Job JobDeque::Slot::load() const {
+    return {
+        function.load(std::memory_order_relaxed), data.load(std::memory_order_relaxed),
+        begin.load(std::memory_order_relaxed), end.load(std::memory_order_relaxed),
+        grain.load(std::memory_order_relaxed), counter.load(std::memory_order_relaxed)
+    };
+}
+
+bool JobDeque::push(const Job &job) {
+    const int64_t b = bottom.load(std::memory_order_relaxed);
+    const int64_t t = top.load(std::memory_order_acquire);
+    if (b - t >= CAPACITY) {
+        return false;
+    }
+    slots[b & (CAPACITY - 1)].store(job);
+    // Release: el ladron que lee bottom con acquire ve el slot (y lo que apunta la tarea)
+    bottom.store(b + 1, std::memory_order_release);
+    return true;
+}
+
+bool JobDeque::pop(Job &job) {
+    const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+    if (t > b) {
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    job = slots[b & (CAPACITY - 1)].load();
+    if (t == b) {
+        // Ultimo elemento: compite con los ladrones
+        const bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+bool JobDeque::steal(Job &job) {
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = bottom.load(std::memory_order_acquire);
+    if (t >= b) {
+        return false;
+    }
+    job = slots[t & (CAPACITY - 1)].load();
+    return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+}
+
+int64_t JobDeque::size() const {
+    return std::max<int64_t>(0, bottom.load(std::memory_order_relaxed) - top.load(std::memory_order_relaxed));
+}
+
+JobSystem::JobSystem(int threadCount, bool pinThreads, SDL_ThreadPriority priority) {
+    threadCount = std::max(threadCount, 1);
+    for (int i = 0; i < threadCount; i++) {
+        workers.push_back(std::make_unique<Worker>());
+        workers.back()->random = 0x9E3779B9u * (i + 1);
+    }
+
+    owner = std::this_thread::get_id();
+    threads.reserve(threadCount - 1);
+    for (int i = 1; i < threadCount; i++) {
+        threads.emplace_back(&JobSystem::workerLoop, this, i, pinThreads, priority);
+    }
+}
+
+JobSystem::~JobSystem() {
+    running.store(false);
+    wakeEpoch.fetch_add(1);
+    wakeEpoch.notify_all();
+    threads.clear();
+}
+
+void JobSystem::workerLoop(int index, bool pin, SDL_ThreadPriority priority) {
+    currentSystem = this;
+    currentIndex = index;
+    SDL_SetCurrentThreadPriority(priority);
+#ifdef __linux__
+    if (pin) {
+        const unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(index % cores, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+#else
+    (void) pin;
+#endif
+
+    Job job;
+    while (running.load(std::memory_order_relaxed)) {
+        // Mientras haya un worker buscando, push() no despierta a ningun otro
+        searching.fetch_add(1);
+        bool found = false;
+        for (int attempt = 0; attempt < SPIN_ATTEMPTS && !found; attempt++) {
+            found = findJob(index, job);
+            if (!found) {
+                if (attempt < SPIN_ATTEMPTS / 2) {
+                    JOB_PAUSE();
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        searching.fetch_sub(1);
+        if (found) {
+            execute(index, job);
+            continue;
+        }
+
+        // Dormir hasta que alguien encole; se vuelve a mirar tras anunciarse para no perder el aviso
+        sleeping.fetch_add(1);
+        const uint32_t epoch = wakeEpoch.load();
+        found = findJob(index, job);
+        if (!found && running.load()) {
+            wakeEpoch.wait(epoch);
+        }
+        sleeping.fetch_sub(1);
+        if (found) {
+            execute(index, job);
+        }
+    }
+}
+
+bool JobSystem::findJob(int index, Job &job) {
+    Worker &self = *workers[index];
+    if (self.deque.pop(job)) {
+        return true;
+    }
+
+    const int count = static_cast<int>(workers.size());
+    if (count == 1) {
+        return false;
+    }
+    // Victima aleatoria (xorshift), recorriendo el resto en orden a partir de ella
+    self.random ^= self.random << 13;
+    self.random ^= self.random >> 17;
+    self.random ^= self.random << 5;
+    const int start = static_cast<int>(self.random % count);
+    for (int i = 0; i < count; i++) {
+        const int victim = (start + i) % count;
+        if (victim != index && workers[victim]->deque.steal(job)) {
+            self.steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::execute(int index, Job job) {
+    // Partir el rango: la mitad superior queda disponible para robar
+    if (job.grain > 0) {
+        while (job.end - job.begin > job.grain) {
+            const uint32_t middle = job.begin + (job.end - job.begin) / 2;
+            Job upper = job;
+            upper.begin = middle;
+            job.end = middle;
+            if (upper.counter) {
+                upper.counter->value.fetch_add(1, std::memory_order_relaxed);
+            }
+            push(upper);
+        }
+    }
+    job.function(job.data, job.begin, job.end);
+    workers[index]->executed.fetch_add(1, std::memory_order_relaxed);
+    finish(job.counter);
+}
+
+void JobSystem::finish(JobCounter *counter) {
+    if (!counter) {
+        return;
+    }
+    // La ultima tarea pasa el contador a -1 mientras encola las dependientes y solo entonces
+    // lo deja a 0: quien espera en wait() no puede destruirlo mientras se usa su lista
+    int value = counter->value.load(std::memory_order_relaxed);
+    while (!counter->value.compare_exchange_weak(value, value == 1 ? -1 : value - 1, std::memory_order_acq_rel)) {
+    }
+    if (value != 1) {
+        return;
+    }
+    std::vector<Job> ready;
+    {
+        std::lock_guard<std::mutex> lock(counter->mutex);
+        ready.swap(counter->waiting);
+    }
+    counter->value.store(0, std::memory_order_release);
+    for (const Job &job: ready) {
+        push(job);
+    }
+}
+
+void JobSystem::push(const Job &job) {
+    const int index = currentWorker();
+    if (!workers[index]->deque.push(job)) {
+        // Deque lleno: ejecutar en linea
+        execute(index, job);
+        return;
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping.load(std::memory_order_relaxed) > 0 && searching.load(std::memory_order_relaxed) == 0) {
+        wakeEpoch.fetch_add(1);
+        wakeEpoch.notify_one();
+    }
+}
+
+int JobSystem::currentWorker() const {
+    if (currentSystem == this) {
+        return currentIndex;
+    }
+    if (std::this_thread::get_id() != owner) {
+        printf("JobSystem used from a thread that is not one of its workers\n");
+        abort();
+    }
+    return 0;
+}
+
+void JobSystem::schedule(const Job &job, JobCounter *signal, JobCounter *dependency) {
+    Job queued = job;
+    queued.counter = signal;
+    if (signal) {
+        signal->value.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (dependency && dependency->get() > 0) {
+        std::lock_guard<std::mutex> lock(dependency->mutex);
+        // Revisar bajo el lock: si ya llego a cero, quien lo hizo ya vacio la lista
+        if (dependency->get() > 0) {
+            dependency->waiting.push_back(queued);
+            return;
+        }
+    }
+    push(queued);
+}
+
+void JobSystem::wait(JobCounter &counter) {
+    const int index = currentWorker();
+    int idle = 0;
+    Job job;
+    while (counter.get() != 0) {
+        if (findJob(index, job)) {
+            execute(index, job);
+            idle = 0;
+        } else {
+            idle++;
+            // La tarea que falta la tiene otro hilo; si hay mas hilos que cores hay que cederle la CPU
+            if (idle < SPIN_ATTEMPTS) {
+                JOB_PAUSE();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+}
+
+int JobSystem::getThreadCount() const {
+    return static_cast<int>(workers.size());
+}
+
+uint64_t JobSystem::getExecutedCount() const {
+    uint64_t total = 0;
+    for (const auto &worker: workers) {
+        total += worker->executed.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+uint64_t JobSystem::getStealCount() const {
+    uint64_t total = 0;
+    for (const auto &worker: workers) {
+        total += worker->steals.load(std::memory_order_relaxed);
+    }
+    return total;
+}
@@ -0,0 +1,156 @@
+#include "Lz4.h"
+
+#include <cstring>
+#include <vector>
+
+static constexpr size_t MIN_MATCH = 4;
+static constexpr size_t MAX_OFFSET = 65535;
+// El formato exige que los ultimos 5 bytes sean literales y que la ultima copia empiece 12 antes del final
+static constexpr size_t LAST_LITERALS = 5;
+static constexpr size_t MATCH_START_LIMIT = 12;
+static constexpr int HASH_BITS = 16;
+static constexpr uint32_t NO_POSITION = UINT32_MAX;
+
+static uint32_t read32(const uint8_t *data) {
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+// 15 en el nibble del token y el resto en bytes de 255 terminados por uno menor
+static bool writeLength(size_t length, uint8_t *dst, size_t capacity, size_t &out) {
+    for (; length >= 255; length -= 255) {
+        if (out >= capacity) {
+            return false;
+        }
+        dst[out++] = 255;
+    }
+    if (out >= capacity) {
+        return false;
+    }
+    dst[out++] = static_cast<uint8_t>(length);
+    return true;
+}
+
+static bool readLength(const uint8_t *src, size_t size, size_t &in, size_t &length) {
+    uint8_t byte;
+    do {
+        if (in >= size) {
+            return false;
+        }
+        byte = src[in++];
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+// Literales [literals, literals + literalCount) seguidos de una copia (matchLength 0: ultima secuencia)
+static bool writeSequence(const uint8_t *literals, size_t literalCount, size_t offset, size_t matchLength,
+                          uint8_t *dst, size_t capacity, size_t &out) {
+    if (out >= capacity) {
+        return false;
+    }
+    const size_t token = out++;
+    const size_t matchCode = matchLength ? matchLength - MIN_MATCH : 0;
+    dst[token] = static_cast<uint8_t>((literalCount < 15 ? literalCount : 15) << 4 | (matchCode < 15 ? matchCode : 15));
+    if (literalCount >= 15 && !writeLength(literalCount - 15, dst, capacity, out)) {
+        return false;
+    }
+    if (literalCount > capacity - out) {
+        return false;
+    }
+    if (literalCount) {
+        memcpy(dst + out, literals, literalCount);
+    }
+    out += literalCount;
+    if (!matchLength) {
+        return true;
+    }
+    if (capacity - out < 2) {
+        return false;
+    }
+    dst[out++] = static_cast<uint8_t>(offset);
+    dst[out++] = static_cast<uint8_t>(offset >> 8);
+    return matchCode < 15 || writeLength(matchCode - 15, dst, capacity, out);
+}
+
+size_t lz4CompressBound(size_t size) {
+    return size + size / 255 + 16;
+}
+
+size_t lz4Compress(const uint8_t *src, size_t size, uint8_t *dst, size_t capacity) {
+    std::vector<uint32_t> table(static_cast<size_t>(1) << HASH_BITS, NO_POSITION);
+    size_t out = 0;
+    size_t anchor = 0;
+    size_t position = 0;
+    const size_t matchStartLimit = size > MATCH_START_LIMIT ? size - MATCH_START_LIMIT : 0;
+    const size_t matchEndLimit = size - LAST_LITERALS;
+    while (position < matchStartLimit) {
+        const uint32_t sequence = read32(src + position);
+        const uint32_t hash = (sequence * 2654435761u) >> (32 - HASH_BITS);
+        const uint32_t candidate = table[hash];
+        table[hash] = static_cast<uint32_t>(position);
+        if (candidate == NO_POSITION || position - candidate > MAX_OFFSET || read32(src + candidate) != sequence) {
+            position++;
+            continue;
+        }
+        size_t length = MIN_MATCH;
+        while (position + length < matchEndLimit && src[candidate + length] == src[position + length]) {
+            length++;
+        }
+        if (!writeSequence(src + anchor, position - anchor, position - candidate, length, dst, capacity, out)) {
+            return 0;
+        }
+        position += length;
+        anchor = position;
+    }
+    return writeSequence(src + anchor, size - anchor, 0, 0, dst, capacity, out) ? out : 0;
+}
+
+bool lz4Decompress(const uint8_t *src, size_t size, uint8_t *dst, size_t originalSize) {
+    size_t in = 0;
+    size_t out = 0;
+    while (in < size) {
+        const uint8_t token = src[in++];
+        size_t literalCount = token >> 4;
+        if (literalCount == 15 && !readLength(src, size, in, literalCount)) {
+            return false;
+        }
+        if (literalCount > size - in || literalCount > originalSize - out) {
+            return false;
+        }
+        if (literalCount) {
+            memcpy(dst + out, src + in, literalCount);
+        }
+        in += literalCount;
+        out += literalCount;
+        if (in == size) {
+            // Ultima secuencia: solo literales
+            break;
+        }
+
+        if (size - in < 2) {
+            return false;
+        }
+        const size_t offset = src[in] | static_cast<size_t>(src[in + 1]) << 8;
+        in += 2;
+        size_t length = token & 15;
+        if (length == 15 && !readLength(src, size, in, length)) {
+            return false;
+        }
+        length += MIN_MATCH;
+        if (offset == 0 || offset > out || length > originalSize - out) {
+            return false;
+        }
+        if (offset >= length) {
+            memcpy(dst + out, dst + out - offset, length);
+            out += length;
+        } else {
+            // Solapada: repite los ultimos offset bytes
+            for (size_t i = 0; i < length; i++, out++) {
+                dst[out] = dst[out - offset];
+            }
+        }
+    }
+    return out == originalSize;
+}
@@ -0,0 +1,336 @@
+#include "MipGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <glm.hpp>
+#include <gtc/color_space.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MIP_SSE2 1
+#endif
+// AVX se compila solo para accumulateRowAvx (atributo target, sin -mavx en todo el fichero) y se elige en
+// tiempo de ejecucion segun CPUID: el binario sigue funcionando en CPUs sin AVX
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define MIP_AVX 1
+#define MIP_AVX_TARGET __attribute__((target("avx")))
+#elif defined(_M_X64)
+#include <immintrin.h>
+#include <intrin.h>
+#define MIP_AVX 1
+#define MIP_AVX_TARGET
+#endif
+
+static constexpr float PI = 3.14159265358979f;
+static constexpr float KAISER_ALPHA = 4.0f;
+// Entradas de la tabla lineal -> sRGB: con 16K el error queda por debajo de medio nivel de 8 bits
+static constexpr int LINEAR_TO_SRGB_SIZE = 16384;
+// Pixeles por trozo de trabajo: los niveles pequenos se hacen enteros en el hilo que llama
+static constexpr uint32_t PIXELS_PER_JOB = 8192;
+
+struct SrgbTables {
+    float toLinear[256];
+    uint8_t toSrgb[LINEAR_TO_SRGB_SIZE];
+};
+
+static const SrgbTables &srgbTables() {
+    static const SrgbTables tables = [] {
+        SrgbTables result;
+        for (int i = 0; i < 256; i++) {
+            result.toLinear[i] = glm::convertSRGBToLinear(glm::vec3(static_cast<float>(i) / 255.0f)).x;
+        }
+        for (int i = 0; i < LINEAR_TO_SRGB_SIZE; i++) {
+            const float linear = static_cast<float>(i) / static_cast<float>(LINEAR_TO_SRGB_SIZE - 1);
+            result.toSrgb[i] = static_cast<uint8_t>(std::lround(glm::convertLinearToSRGB(glm::vec3(linear)).x * 255.0f));
+        }
+        return result;
+    }();
+    return tables;
+}
+
+const char *mipFilterName(MipFilter filter) {
+    switch (filter) {
+        case MIP_FILTER_BOX: return "box";
+        case MIP_FILTER_KAISER: return "kaiser";
+        case MIP_FILTER_LANCZOS: return "lanczos";
+        default: return "unknown";
+    }
+}
+
+bool parseMipFilter(const std::string &name, MipFilter &filter) {
+    for (int f = 0; f < MIP_FILTER_COUNT; f++) {
+        if (name == mipFilterName(static_cast<MipFilter>(f))) {
+            filter = static_cast<MipFilter>(f);
+            return true;
+        }
+    }
+    return false;
+}
+
+static float sinc(float x) {
+    return x == 0.0f ? 1.0f : std::sin(PI * x) / (PI * x);
+}
+
+// Bessel modificada de orden 0 (serie), para la ventana de Kaiser
+static float besselI0(float x) {
+    float sum = 1.0f;
+    float term = 1.0f;
+    for (int k = 1; k < 20; k++) {
+        term *= (x / (2.0f * static_cast<float>(k))) * (x / (2.0f * static_cast<float>(k)));
+        sum += term;
+    }
+    return sum;
+}
+
+static float filterRadius(MipFilter filter) {
+    return filter == MIP_FILTER_BOX ? 0.5f : 3.0f;
+}
+
+// x en pixeles del nivel destino
+static float filterWeight(MipFilter filter, float x) {
+    const float radius = filterRadius(filter);
+    if (std::fabs(x) >= radius) {
+        return 0.0f;
+    }
+    switch (filter) {
+        case MIP_FILTER_KAISER: {
+            const float t = x / radius;
+            return sinc(x) * besselI0(KAISER_ALPHA * std::sqrt(1.0f - t * t)) / besselI0(KAISER_ALPHA);
+        }
+        case MIP_FILTER_LANCZOS: return sinc(x) * sinc(x / radius);
+        default: return 1.0f;
+    }
+}
+
+// Muestras de origen de cada pixel destino en un eje: tapCount indices (con clamp al borde) y pesos normalizados
+struct FilterTaps {
+    int tapCount;
+    std::vector<int> indices;
+    std::vector<float> weights;
+};
+
+static void buildTaps(MipFilter filter, int source, int destination, FilterTaps &taps) {
+    const float scale = static_cast<float>(source) / static_cast<float>(destination);
+    const float support = filterRadius(filter) * scale;
+    taps.tapCount = static_cast<int>(std::ceil(support * 2.0f)) + 1;
+    taps.indices.assign(static_cast<size_t>(destination) * taps.tapCount, 0);
+    taps.weights.assign(static_cast<size_t>(destination) * taps.tapCount, 0.0f);
+    for (int x = 0; x < destination; x++) {
+        const float center = (static_cast<float>(x) + 0.5f) * scale;
+        const int first = static_cast<int>(std::floor(center - support));
+        int *indices = &taps.indices[static_cast<size_t>(x) * taps.tapCount];
+        float *weights = &taps.weights[static_cast<size_t>(x) * taps.tapCount];
+        float sum = 0.0f;
+        for (int t = 0; t < taps.tapCount; t++) {
+            const int i = first + t;
+            indices[t] = std::clamp(i, 0, source - 1);
+            weights[t] = filterWeight(filter, (static_cast<float>(i) + 0.5f - center) / scale);
+            sum += weights[t];
+        }
+        for (int t = 0; t < taps.tapCount; t++) {
+            weights[t] /= sum;
+        }
+    }
+}
+
+#if defined(MIP_AVX)
+static bool cpuHasAvx() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    // AVX y OSXSAVE, y el sistema guarda los registros YMM
+    return (info[2] & (1 << 28)) && (info[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6;
+#else
+    return __builtin_cpu_supports("avx");
+#endif
+}
+
+// dst[i] += src[i] * weight, 8 floats por instruccion
+MIP_AVX_TARGET static void accumulateRowAvx(float *dst, const float *src, float weight, size_t count) {
+    size_t i = 0;
+    const __m256 w8 = _mm256_set1_ps(weight);
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), w8)));
+    }
+    for (; i < count; i++) {
+        dst[i] += src[i] * weight;
+    }
+}
+#endif
+
+// dst[i] += src[i] * weight
+static void accumulateRow(float *dst, const float *src, float weight, size_t count) {
+#if defined(MIP_AVX)
+    static const bool avx = cpuHasAvx();
+    if (avx) {
+        accumulateRowAvx(dst, src, weight, count);
+        return;
+    }
+#endif
+    size_t i = 0;
+#if defined(MIP_SSE2)
+    const __m128 w4 = _mm_set1_ps(weight);
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), w4)));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] += src[i] * weight;
+    }
+}
+
+// Una fila en horizontal: cada pixel RGBA en float es un registro SSE
+static void filterRow(const float *src, float *dst, int width, const FilterTaps &taps) {
+    for (int x = 0; x < width; x++) {
+        const int *indices = &taps.indices[static_cast<size_t>(x) * taps.tapCount];
+        const float *weights = &taps.weights[static_cast<size_t>(x) * taps.tapCount];
+#if defined(MIP_SSE2)
+        __m128 sum = _mm_setzero_ps();
+        for (int t = 0; t < taps.tapCount; t++) {
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src + indices[t] * 4), _mm_set1_ps(weights[t])));
+        }
+        _mm_storeu_ps(dst + x * 4, sum);
+#else
+        float sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        for (int t = 0; t < taps.tapCount; t++) {
+            for (int c = 0; c < 4; c++) {
+                sum[c] += src[indices[t] * 4 + c] * weights[t];
+            }
+        }
+        for (int c = 0; c < 4; c++) {
+            dst[x * 4 + c] = sum[c];
+        }
+#endif
+    }
+}
+
+template<typename F>
+static void forEachRow(JobSystem *jobs, int rows, int width, F &&function) {
+    if (jobs) {
+        const uint32_t grain = std::max(PIXELS_PER_JOB / static_cast<uint32_t>(width), 1u);
+        jobs->parallelFor(0, static_cast<uint32_t>(rows), grain, function);
+    } else {
+        function(0u, static_cast<uint32_t>(rows));
+    }
+}
+
+static float linearCoverage(const std::vector<float> &image, float cutoff, float scale) {
+    const size_t pixels = image.size() / 4;
+    size_t covered = 0;
+    for (size_t i = 0; i < pixels; i++) {
+        covered += image[i * 4 + 3] * scale >= cutoff;
+    }
+    return static_cast<float>(covered) / static_cast<float>(pixels);
+}
+
+// Escala de alfa con la que el nivel recupera la cobertura del nivel 0 (la cobertura crece con la escala)
+static float coverageScale(const std::vector<float> &image, float cutoff, float target) {
+    float low = 0.0f;
+    float high = 4.0f;
+    for (int i = 0; i < 16; i++) {
+        const float middle = (low + high) * 0.5f;
+        if (linearCoverage(image, cutoff, middle) < target) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    return high;
+}
+
+float computeAlphaCoverage(const uint8_t *rgba, size_t pixels, float cutoff) {
+    if (pixels == 0) {
+        return 0.0f;
+    }
+    size_t covered = 0;
+    for (size_t i = 0; i < pixels; i++) {
+        covered += static_cast<float>(rgba[i * 4 + 3]) / 255.0f >= cutoff;
+    }
+    return static_cast<float>(covered) / static_cast<float>(pixels);
+}
+
+void generateMips(const uint8_t *rgba, int width, int height, const MipOptions &options,
+                  std::vector<std::vector<uint8_t> > &levels, JobSystem *jobs) {
+    const SrgbTables &tables = srgbTables();
+    levels.clear();
+    levels.emplace_back(rgba, rgba + static_cast<size_t>(width) * height * 4);
+
+    // Todo en float, sin volver a cuantizar a 8 bits. Con box cada nivel sale del anterior (en potencias de
+    // dos es lo mismo que desde el nivel 0); los lobulos de Kaiser y Lanczos se acumularian nivel a nivel, asi
+    // que con ellos todos los niveles salen del 0 (mas taps en los niveles pequeños)
+    const bool fromLevel0 = options.filter != MIP_FILTER_BOX;
+    int sourceWidth = width;
+    int sourceHeight = height;
+    std::vector<float> source(static_cast<size_t>(width) * height * 4);
+    forEachRow(jobs, height, width, [&](uint32_t begin, uint32_t end) {
+        for (size_t i = static_cast<size_t>(begin) * width * 4; i < static_cast<size_t>(end) * width * 4; i += 4) {
+            for (size_t c = 0; c < 3; c++) {
+                source[i + c] = options.srgb ? tables.toLinear[rgba[i + c]] : static_cast<float>(rgba[i + c]) / 255.0f;
+            }
+            source[i + 3] = static_cast<float>(rgba[i + 3]) / 255.0f;
+        }
+    });
+    const bool preserveCoverage = options.alphaCutoff > 0.0f;
+    const float targetCoverage = preserveCoverage
+                                     ? computeAlphaCoverage(rgba, static_cast<size_t>(width) * height,
+                                                            options.alphaCutoff)
+                                     : 0.0f;
+
+    FilterTaps horizontal;
+    FilterTaps vertical;
+    std::vector<float> filtered;
+    std::vector<float> next;
+    while (width > 1 || height > 1) {
+        const int nextWidth = std::max(width / 2, 1);
+        const int nextHeight = std::max(height / 2, 1);
+        buildTaps(options.filter, sourceWidth, nextWidth, horizontal);
+        buildTaps(options.filter, sourceHeight, nextHeight, vertical);
+
+        // Primero en horizontal (sourceWidth -> nextWidth), despues en vertical sobre filas completas
+        filtered.resize(static_cast<size_t>(nextWidth) * sourceHeight * 4);
+        forEachRow(jobs, sourceHeight, nextWidth, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t y = begin; y < end; y++) {
+                filterRow(&source[static_cast<size_t>(y) * sourceWidth * 4],
+                          &filtered[static_cast<size_t>(y) * nextWidth * 4], nextWidth, horizontal);
+            }
+        });
+        const size_t rowFloats = static_cast<size_t>(nextWidth) * 4;
+        next.assign(rowFloats * nextHeight, 0.0f);
+        forEachRow(jobs, nextHeight, nextWidth, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t y = begin; y < end; y++) {
+                const int *indices = &vertical.indices[static_cast<size_t>(y) * vertical.tapCount];
+                const float *weights = &vertical.weights[static_cast<size_t>(y) * vertical.tapCount];
+                for (int t = 0; t < vertical.tapCount; t++) {
+                    if (weights[t] != 0.0f) {
+                        accumulateRow(&next[y * rowFloats], &filtered[indices[t] * rowFloats], weights[t], rowFloats);
+                    }
+                }
+            }
+        });
+
+        // El alfa escalado solo va al nivel de salida; el siguiente se filtra sin escalar
+        const float alphaScale = preserveCoverage ? coverageScale(next, options.alphaCutoff, targetCoverage) : 1.0f;
+        std::vector<uint8_t> &level = levels.emplace_back(rowFloats * nextHeight);
+        forEachRow(jobs, nextHeight, nextWidth, [&](uint32_t begin, uint32_t end) {
+            for (size_t i = begin * rowFloats; i < end * rowFloats; i += 4) {
+                // Lanczos y Kaiser tienen lobulos negativos: se recorta a [0, 1]
+                for (size_t c = 0; c < 3; c++) {
+                    const float value = std::clamp(next[i + c], 0.0f, 1.0f);
+                    level[i + c] = options.srgb
+                                       ? tables.toSrgb[static_cast<int>(value * (LINEAR_TO_SRGB_SIZE - 1) + 0.5f)]
+                                       : static_cast<uint8_t>(value * 255.0f + 0.5f);
+                }
+                level[i + 3] = static_cast<uint8_t>(std::clamp(next[i + 3] * alphaScale, 0.0f, 1.0f) * 255.0f + 0.5f);
+            }
+        });
+
+        if (!fromLevel0) {
+            source.swap(next);
+            sourceWidth = nextWidth;
+            sourceHeight = nextHeight;
+        }
+        width = nextWidth;
+        height = nextHeight;
+    }
+}
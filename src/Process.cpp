@@ -0,0 +1,144 @@
+#include "Process.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+// CreateProcess recibe una sola linea que el hijo vuelve a partir (reglas de CommandLineToArgvW): se cita
+// cada argumento y se escapan las barras que preceden a una comilla. No interviene cmd.exe
+static std::string quoteArgument(const std::string &argument) {
+    if (!argument.empty() && argument.find_first_of(" \t\"") == std::string::npos) {
+        return argument;
+    }
+    std::string quoted = "\"";
+    size_t backslashes = 0;
+    for (const char c: argument) {
+        if (c == '\\') {
+            backslashes++;
+            continue;
+        }
+        quoted.append(c == '"' ? backslashes * 2 + 1 : backslashes, '\\');
+        quoted += c;
+        backslashes = 0;
+    }
+    quoted.append(backslashes * 2, '\\');
+    return quoted + "\"";
+}
+
+bool runProcess(const std::vector<std::string> &arguments, std::string &output) {
+    if (arguments.empty()) {
+        return false;
+    }
+    std::string commandLine;
+    for (const std::string &argument: arguments) {
+        commandLine += (commandLine.empty() ? "" : " ") + quoteArgument(argument);
+    }
+
+    SECURITY_ATTRIBUTES security = {sizeof(security), nullptr, TRUE};
+    HANDLE readPipe = nullptr;
+    HANDLE writePipe = nullptr;
+    if (!CreatePipe(&readPipe, &writePipe, &security, 0)) {
+        return false;
+    }
+    // Solo el extremo de escritura se hereda
+    SetHandleInformation(readPipe, HANDLE_FLAG_INHERIT, 0);
+    STARTUPINFOA startup = {};
+    startup.cb = sizeof(startup);
+    startup.dwFlags = STARTF_USESTDHANDLES;
+    startup.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+    startup.hStdOutput = writePipe;
+    startup.hStdError = writePipe;
+    PROCESS_INFORMATION process = {};
+    const BOOL created = CreateProcessA(nullptr, commandLine.data(), nullptr, nullptr, TRUE, 0, nullptr, nullptr,
+                                        &startup, &process);
+    CloseHandle(writePipe);
+    if (!created) {
+        CloseHandle(readPipe);
+        return false;
+    }
+    char buffer[512];
+    DWORD read;
+    while (ReadFile(readPipe, buffer, sizeof(buffer), &read, nullptr) && read > 0) {
+        output.append(buffer, read);
+    }
+    CloseHandle(readPipe);
+    WaitForSingleObject(process.hProcess, INFINITE);
+    DWORD exitCode = 1;
+    GetExitCodeProcess(process.hProcess, &exitCode);
+    CloseHandle(process.hProcess);
+    CloseHandle(process.hThread);
+    return exitCode == 0;
+}
+
+#else
+
+bool runProcess(const std::vector<std::string> &arguments, std::string &output) {
+    if (arguments.empty()) {
+        return false;
+    }
+    // argv se prepara antes del fork: en el hijo solo dup2/exec
+    std::vector<char *> argv;
+    for (const std::string &argument: arguments) {
+        argv.push_back(const_cast<char *>(argument.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    // Close-on-exec: el cooker lanza procesos desde varios workers y un hijo ajeno que heredara el extremo de
+    // escritura retrasaria el fin de fichero de este
+    int pipeFds[2];
+#ifdef __linux__
+    if (pipe2(pipeFds, O_CLOEXEC) != 0) {
+        return false;
+    }
+#else
+    if (pipe(pipeFds) != 0) {
+        return false;
+    }
+    fcntl(pipeFds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(pipeFds[1], F_SETFD, FD_CLOEXEC);
+#endif
+    const pid_t pid = fork();
+    if (pid < 0) {
+        close(pipeFds[0]);
+        close(pipeFds[1]);
+        return false;
+    }
+    if (pid == 0) {
+        // dup2 no copia el close-on-exec
+        dup2(pipeFds[1], STDOUT_FILENO);
+        dup2(pipeFds[1], STDERR_FILENO);
+        execvp(argv[0], argv.data());
+        // Sin exec no hay proceso que ejecutar; _exit no pasa por los destructores del padre
+        _exit(127);
+    }
+    close(pipeFds[1]);
+    char buffer[512];
+    ssize_t read;
+    while ((read = ::read(pipeFds[0], buffer, sizeof(buffer))) != 0) {
+        if (read < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        output.append(buffer, static_cast<size_t>(read));
+    }
+    close(pipeFds[0]);
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR) {
+            return false;
+        }
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+#endif
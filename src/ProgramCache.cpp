@@ -0,0 +1,196 @@
+#include "ProgramCache.h"
+
+#include <SDL3/SDL.h>
+#include <glad/glad.h>
+#include <cinttypes>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+static constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+static constexpr uint64_t FNV_PRIME = 1099511628211ull;
+static constexpr uint32_t PROGRAM_FILE_MAGIC = 0x42504C53; // "SLPB"
+static constexpr uint32_t PROGRAM_FILE_VERSION = 1;
+
+// Cabecera de cada fichero; el binario va detras
+struct ProgramFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint64_t driverHash;
+    uint32_t binaryFormat;
+    uint32_t binaryLength;
+    uint64_t compileNS;
+};
+
+static uint64_t hashBytes(uint64_t hash, const void *data, size_t size) {
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+static uint64_t hashString(uint64_t hash, const std::string &value) {
+    // Con el terminador: "ab" + "c" no da lo mismo que "a" + "bc"
+    return hashBytes(hash, value.c_str(), value.size() + 1);
+}
+
+static std::string glString(GLenum name) {
+    const GLubyte *value = glGetString(name);
+    return value ? reinterpret_cast<const char *>(value) : "";
+}
+
+ProgramCache::ProgramCache() : enabled(false), driverHash(0), hits(0), misses(0), rejected(0), savedNS(0),
+                               compileNS(0) {
+}
+
+bool ProgramCache::begin(const std::string &directory) {
+    this->directory = directory;
+    int formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if (formats <= 0) {
+        SDL_Log("Program cache disabled: the driver exposes no program binary formats");
+        enabled = false;
+        return false;
+    }
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        SDL_Log("Program cache disabled: unable to create %s: %s", directory.c_str(), error.message().c_str());
+        enabled = false;
+        return false;
+    }
+
+    driverHash = hashString(hashString(hashString(FNV_OFFSET, glString(GL_VENDOR)), glString(GL_RENDERER)),
+                            glString(GL_VERSION));
+    enabled = true;
+    return true;
+}
+
+bool ProgramCache::isEnabled() const {
+    return enabled;
+}
+
+uint64_t ProgramCache::makeKey(const std::string &vertexSource, const std::string &fragmentSource) const {
+    return hashString(hashString(hashBytes(FNV_OFFSET, &driverHash, sizeof(driverHash)), vertexSource),
+                      fragmentSource);
+}
+
+std::string ProgramCache::pathFor(uint64_t key) const {
+    char name[32];
+    snprintf(name, sizeof(name), "%016" PRIx64 ".bin", key);
+    return (std::filesystem::path(directory) / name).string();
+}
+
+unsigned int ProgramCache::load(uint64_t key) {
+    if (!enabled) {
+        return 0;
+    }
+    const std::string path = pathFor(key);
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return 0;
+    }
+
+    const uint64_t start = SDL_GetTicksNS();
+    ProgramFileHeader header = {};
+    std::vector<char> binary;
+    bool valid = file.read(reinterpret_cast<char *>(&header), sizeof(header)) &&
+                 header.magic == PROGRAM_FILE_MAGIC && header.version == PROGRAM_FILE_VERSION &&
+                 header.key == key && header.driverHash == driverHash && header.binaryLength > 0;
+    if (valid) {
+        binary.resize(header.binaryLength);
+        valid = static_cast<bool>(file.read(binary.data(), static_cast<std::streamsize>(binary.size())));
+    }
+    file.close();
+
+    unsigned int program = 0;
+    if (valid) {
+        program = glCreateProgram();
+        glProgramBinary(program, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+        int linked = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (!linked) {
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+    if (!program) {
+        // Otro driver u otra version del mismo: se recompila y se sobrescribe
+        std::error_code error;
+        std::filesystem::remove(path, error);
+        std::lock_guard<std::mutex> lock(mutex);
+        rejected++;
+        return 0;
+    }
+
+    const uint64_t loadNS = SDL_GetTicksNS() - start;
+    std::lock_guard<std::mutex> lock(mutex);
+    hits++;
+    savedNS += header.compileNS > loadNS ? header.compileNS - loadNS : 0;
+    return program;
+}
+
+void ProgramCache::store(uint64_t key, unsigned int program, uint64_t compileNS) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        misses++;
+        this->compileNS += compileNS;
+    }
+    if (!enabled) {
+        return;
+    }
+    int length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+    std::vector<char> binary(static_cast<size_t>(length));
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+
+    const ProgramFileHeader header = {
+        PROGRAM_FILE_MAGIC, PROGRAM_FILE_VERSION, key, driverHash, format, static_cast<uint32_t>(length), compileNS
+    };
+    // Se escribe aparte y se renombra: otro proceso nunca lee un binario a medias
+    const std::string path = pathFor(key);
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(binary.data(), length);
+        if (!file) {
+            SDL_Log("Unable to write program binary %s", temporary.c_str());
+            return;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+}
+
+size_t ProgramCache::getHits() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+}
+
+size_t ProgramCache::getMisses() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+}
+
+size_t ProgramCache::getRejected() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return rejected;
+}
+
+double ProgramCache::getSavedMs() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<double>(savedNS) / 1000000.0;
+}
+
+double ProgramCache::getCompileMs() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<double>(compileNS) / 1000000.0;
+}
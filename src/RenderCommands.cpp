@@ -0,0 +1,174 @@
+#include "RenderCommands.h"
+
+#include <algorithm>
+#include <cstring>
+#include <glad/glad.h>
+
+// Todos los comandos estan alineados a 4: los floats/ints del payload se leen directamente
+static constexpr size_t COMMAND_ALIGNMENT = 4;
+static constexpr size_t INITIAL_CAPACITY = 16 * 1024;
+
+Material createMaterial(const Shader &shader) {
+    return createMaterial(shader.id);
+}
+
+Material createMaterial(unsigned int program) {
+    return {
+        program,
+        glGetUniformLocation(program, "model"),
+        glGetUniformLocation(program, "objectColor"),
+        glGetUniformLocation(program, "lightPos"),
+        glGetUniformLocation(program, "lightColor"),
+        glGetUniformLocation(program, "lightSpace")
+    };
+}
+
+Material createMaterialFromLocations(unsigned int program) {
+    Material material = {program, -1, -1, -1, -1, -1};
+    int uniforms = 0;
+    glGetProgramInterfaceiv(program, GL_UNIFORM, GL_ACTIVE_RESOURCES, &uniforms);
+    for (int i = 0; i < uniforms; i++) {
+        const GLenum property = GL_LOCATION;
+        int location = -1;
+        glGetProgramResourceiv(program, GL_UNIFORM, static_cast<GLuint>(i), 1, &property, 1, nullptr, &location);
+        switch (location) {
+            case UNIFORM_MODEL:
+                material.model = location;
+                break;
+            case UNIFORM_OBJECT_COLOR:
+                material.objectColor = location;
+                break;
+            case UNIFORM_LIGHT_POS:
+                material.lightPos = location;
+                break;
+            case UNIFORM_LIGHT_COLOR:
+                material.lightColor = location;
+                break;
+            case UNIFORM_LIGHT_SPACE:
+                material.lightSpace = location;
+                break;
+            default:
+                break;
+        }
+    }
+    return material;
+}
+
+RenderCommandList::RenderCommandList() : capacity(0), used(0), commandCount(0) {
+}
+
+RenderCommandList::RenderCommandList(RenderCommandList &&other) noexcept
+    : buffer(std::move(other.buffer)), capacity(other.capacity), used(other.used), commandCount(other.commandCount) {
+    other.capacity = other.used = other.commandCount = 0;
+}
+
+RenderCommandList &RenderCommandList::operator=(RenderCommandList &&other) noexcept {
+    buffer = std::move(other.buffer);
+    capacity = other.capacity;
+    used = other.used;
+    commandCount = other.commandCount;
+    other.capacity = other.used = other.commandCount = 0;
+    return *this;
+}
+
+void RenderCommandList::reset() {
+    used = 0;
+    commandCount = 0;
+}
+
+void *RenderCommandList::allocate(size_t bytes) {
+    bytes = (bytes + COMMAND_ALIGNMENT - 1) & ~(COMMAND_ALIGNMENT - 1);
+    if (used + bytes > capacity) {
+        const size_t newCapacity = std::max({INITIAL_CAPACITY, capacity * 2, used + bytes});
+        std::unique_ptr<uint8_t[]> grown(new uint8_t[newCapacity]);
+        if (used) {
+            memcpy(grown.get(), buffer.get(), used);
+        }
+        buffer = std::move(grown);
+        capacity = newCapacity;
+    }
+    void *pointer = buffer.get() + used;
+    used += bytes;
+    return pointer;
+}
+
+const uint8_t *RenderCommandList::data() const {
+    return buffer.get();
+}
+
+size_t RenderCommandList::size() const {
+    return used;
+}
+
+size_t RenderCommandList::getCommandCount() const {
+    return commandCount;
+}
+
+static void recordVec3(RenderCommandList &list, int32_t location, const glm::vec3 &value) {
+    if (location < 0) {
+        return;
+    }
+    SetUniformVec3Command &command = list.add<SetUniformVec3Command>();
+    command.location = location;
+    memcpy(command.value, &value[0], sizeof(command.value));
+}
+
+void recordDraws(const DrawItem *begin, const DrawItem *end, const SceneLight &light, RenderCommandList &list) {
+    const Material *boundMaterial = nullptr;
+    unsigned int boundVAO = 0;
+    for (const DrawItem *draw = begin; draw != end; draw++) {
+        const Material *material = draw->material;
+        if (material != boundMaterial) {
+            list.add<SetProgramCommand>().program = material->program;
+            recordVec3(list, material->lightColor, light.color);
+            recordVec3(list, material->lightPos, light.position);
+            boundMaterial = material;
+        }
+        recordVec3(list, material->objectColor, draw->color);
+        if (material->model >= 0) {
+            SetUniformMat4Command &command = list.add<SetUniformMat4Command>();
+            command.location = material->model;
+            memcpy(command.value, &draw->model[0][0], sizeof(command.value));
+        }
+
+        if (draw->vao != boundVAO) {
+            list.add<SetVertexArrayCommand>().vertexArray = draw->vao;
+            boundVAO = draw->vao;
+        }
+        DrawCommand &command = list.add<DrawCommand>();
+        command.first = 0;
+        command.count = draw->vertexCount;
+    }
+}
+
+void replayRenderCommands(const RenderCommandList &list) {
+    const uint8_t *cursor = list.data();
+    const uint8_t *end = cursor + list.size();
+    while (cursor < end) {
+        const auto *header = reinterpret_cast<const RenderCommand *>(cursor);
+        switch (header->type) {
+            case RENDER_COMMAND_SET_PROGRAM:
+                glUseProgram(reinterpret_cast<const SetProgramCommand *>(cursor)->program);
+                break;
+            case RENDER_COMMAND_SET_VERTEX_ARRAY:
+                glBindVertexArray(reinterpret_cast<const SetVertexArrayCommand *>(cursor)->vertexArray);
+                break;
+            case RENDER_COMMAND_SET_UNIFORM_VEC3: {
+                const auto *command = reinterpret_cast<const SetUniformVec3Command *>(cursor);
+                glUniform3fv(command->location, 1, command->value);
+                break;
+            }
+            case RENDER_COMMAND_SET_UNIFORM_MAT4: {
+                const auto *command = reinterpret_cast<const SetUniformMat4Command *>(cursor);
+                glUniformMatrix4fv(command->location, 1, GL_FALSE, command->value);
+                break;
+            }
+            case RENDER_COMMAND_DRAW: {
+                const auto *command = reinterpret_cast<const DrawCommand *>(cursor);
+                glDrawArrays(GL_TRIANGLES, command->first, command->count);
+                break;
+            }
+        }
+        cursor += (header->size + COMMAND_ALIGNMENT - 1) & ~(COMMAND_ALIGNMENT - 1);
+    }
+}
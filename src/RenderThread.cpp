@@ -0,0 +1,184 @@
+#include "RenderThread.h"
+
+#include <glad/glad.h>
+#include <cmath>
+
+// Saca un elemento de queue, durmiendo mientras este vacia; devuelve los ns esperados
+template<typename Queue, typename T>
+static uint64_t popBlocking(Queue &queue, T &value) {
+    uint64_t start = 0;
+    for (;;) {
+        const uint32_t signal = queue.getSignal().load(std::memory_order_acquire);
+        if (queue.pop(value)) {
+            return start ? SDL_GetTicksNS() - start : 0;
+        }
+        if (!start) {
+            start = SDL_GetTicksNS();
+        }
+        queue.getSignal().wait(signal, std::memory_order_acquire);
+    }
+}
+
+RenderThread::RenderThread() : target{}, pacer(nullptr), report(nullptr), cameraUBO(0), textures(nullptr),
+                               shaders(nullptr), threaded(false),
+                               latencyLog(false), running(false), uploadedCameraVersion(0),
+                               uploadedEyePosition(0.0f), packets{}, mainWaitNS(0), renderWaitNS(0) {
+}
+
+RenderThread::~RenderThread() {
+    stop();
+}
+
+void RenderThread::start(const RenderTarget &target, FramePacer *pacer, BenchmarkReport *report,
+                         unsigned int cameraUBO, TextureCache *textures, ShaderManager *shaders, bool threaded,
+                         bool latencyLog) {
+    this->target = target;
+    this->pacer = pacer;
+    this->report = report;
+    this->cameraUBO = cameraUBO;
+    this->textures = textures;
+    this->shaders = shaders;
+    this->threaded = threaded;
+    this->latencyLog = latencyLog;
+    // Forzar la primera subida del UBO
+    uploadedCameraVersion = UINT32_MAX;
+    uploadedEyePosition = glm::vec3(NAN);
+
+    for (FramePacket &packet: packets) {
+        freePackets.push(&packet);
+    }
+    running = true;
+    if (threaded) {
+        releaseCurrent();
+        thread = std::jthread(&RenderThread::threadLoop, this);
+    }
+}
+
+FramePacket *RenderThread::acquirePacket() {
+    FramePacket *packet = nullptr;
+    mainWaitNS += popBlocking(freePackets, packet);
+    return packet;
+}
+
+void RenderThread::submit(FramePacket *packet) {
+    if (!threaded) {
+        render(*packet);
+        freePackets.push(packet);
+        return;
+    }
+    submitted.push(packet);
+}
+
+void RenderThread::stop() {
+    if (!running) {
+        return;
+    }
+    running = false;
+    if (threaded) {
+        submitted.push(nullptr);
+        thread.join();
+        makeCurrent();
+    }
+}
+
+bool RenderThread::isRunning() const {
+    return running;
+}
+
+void RenderThread::threadLoop() {
+    makeCurrent();
+    for (;;) {
+        FramePacket *packet = nullptr;
+        renderWaitNS.fetch_add(popBlocking(submitted, packet), std::memory_order_relaxed);
+        if (!packet) {
+            break;
+        }
+        render(*packet);
+        freePackets.push(packet);
+    }
+    // Terminar todo antes de devolver el contexto
+    glFinish();
+    releaseCurrent();
+}
+
+void RenderThread::render(FramePacket &packet) {
+    if (target.headless) {
+        report->beginFrame();
+        target.headless->bindFramebuffer();
+    }
+
+    // Limitar cuanto se adelanta la CPU antes de emitir comandos GL
+    pacer->waitForFrameSlot();
+
+    glClearColor(packet.clearColor.r, packet.clearColor.g, packet.clearColor.b, packet.clearColor.a);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // Limpiar buffers
+
+    if (packet.cameraVersion != uploadedCameraVersion || packet.eyePosition != uploadedEyePosition) {
+        glBindBuffer(GL_UNIFORM_BUFFER, cameraUBO);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(CameraUniforms), &packet.camera);
+        uploadedCameraVersion = packet.cameraVersion;
+        uploadedEyePosition = packet.eyePosition;
+    }
+
+    if (textures) {
+        // Antes de dibujar: lo que termino de subirse ya se usa en este frame
+        for (int unit = 0; unit < packet.textureCount; unit++) {
+            textures->requestResolution(packet.textures[unit], packet.textureDemand[unit]);
+        }
+        textures->update();
+        for (int unit = 0; unit < packet.textureCount; unit++) {
+            glActiveTexture(GL_TEXTURE0 + unit);
+            glBindTexture(GL_TEXTURE_2D, textures->getTexture(packet.textures[unit]));
+        }
+    }
+
+    for (const RenderCommandList &list: packet.commandLists) {
+        replayRenderCommands(list);
+    }
+    glBindVertexArray(0);
+
+    if (shaders) {
+        // Despues de dibujar: las compilaciones que se lancen no retrasan este frame
+        shaders->update();
+    }
+
+    if (target.headless) {
+        report->recordSimTicks(packet.simTicks);
+        report->endFrame();
+    } else {
+        SDL_GL_SwapWindow(target.window); // Intercambiar buffers (mostrar frame renderizado)
+    }
+
+    const uint64_t presentNS = SDL_GetTicksNS();
+    if (latencyLog && packet.oldestEventNS != 0) {
+        SDL_Log("latency: %.3f ms oldest event to swap, %.3f ms newest event to swap (%zu events)",
+                static_cast<double>(presentNS - packet.oldestEventNS) / 1000000.0,
+                static_cast<double>(presentNS - packet.newestEventNS) / 1000000.0, packet.eventCount);
+    }
+
+    pacer->endFrame();
+}
+
+void RenderThread::makeCurrent() const {
+    if (target.headless) {
+        target.headless->makeCurrent();
+    } else {
+        SDL_GL_MakeCurrent(target.window, target.context);
+    }
+}
+
+void RenderThread::releaseCurrent() const {
+    if (target.headless) {
+        target.headless->releaseCurrent();
+    } else {
+        SDL_GL_MakeCurrent(target.window, nullptr);
+    }
+}
+
+double RenderThread::getMainWaitMs() const {
+    return static_cast<double>(mainWaitNS) / 1000000.0;
+}
+
+double RenderThread::getRenderWaitMs() const {
+    return static_cast<double>(renderWaitNS.load(std::memory_order_relaxed)) / 1000000.0;
+}
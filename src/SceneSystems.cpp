@@ -0,0 +1,144 @@
+#include "SceneSystems.h"
+
+#include <algorithm>
+#include <atomic>
+#include <gtc/quaternion.hpp>
+
+void AnimationSystem::run(World &world, TransformSystem &transforms, float rotation) {
+    query.each(world, [&](const TransformComponent &transform, const Spin &spin) {
+        transforms.setRotation(transform.id, glm::angleAxis(glm::radians(rotation * spin.speed), spin.axis));
+    });
+}
+
+SceneLight LightSystem::run(World &world, const TransformSystem &transforms) {
+    SceneLight light = {glm::vec3(0.0f), glm::vec3(1.0f)};
+    bool found = false;
+    query.each(world, [&](const TransformComponent &transform, const LightSource &source) {
+        if (!found) {
+            light.position = glm::vec3(transforms.getWorld(transform.id)[3]);
+            light.color = source.color;
+            found = true;
+        }
+    });
+    return light;
+}
+
+float TextureDemandSystem::run(World &world, const TransformSystem &transforms, const Material *material,
+                               const glm::mat4 &projection, const glm::vec3 &eye, int viewportHeight) {
+    float demand = 0.0f;
+    query.each(world, [&](const TransformComponent &transform, const BoundingSphere &bounds, const MeshRenderer &mesh,
+                          const Visible &visible) {
+        if (!visible.value || mesh.material != material) {
+            return;
+        }
+        const glm::mat4 &model = transforms.getWorld(transform.id);
+        const float scale = std::max({
+            glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))
+        });
+        const float radius = bounds.radius * scale;
+        // projection[1][1] = 1 / tan(fovy / 2): diametro / (2 d tan(fovy / 2)) * alto; dentro de la esfera, todo
+        const float distance = glm::length(glm::vec3(model[3]) - eye) - radius;
+        const float pixels = distance > 0.0f
+                                 ? radius * projection[1][1] * static_cast<float>(viewportHeight) / distance
+                                 : static_cast<float>(viewportHeight);
+        demand = std::max(demand, pixels);
+    });
+    return demand;
+}
+
+void CullingSystem::run(World &world, const TransformSystem &transforms, const glm::mat4 &viewProjection,
+                        JobSystem *jobs) {
+    if (viewProjection == lastViewProjection && transforms.getLastUpdatedCount() == 0 &&
+        world.getStructureVersion() == lastStructureVersion) {
+        return;
+    }
+    lastViewProjection = viewProjection;
+    lastStructureVersion = world.getStructureVersion();
+
+    // Planos de Gribb-Hartmann: filas de la matriz (glm es column-major)
+    glm::vec4 planes[6];
+    const glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+    const glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+    const glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+    const glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+    planes[0] = row3 + row0;
+    planes[1] = row3 - row0;
+    planes[2] = row3 + row1;
+    planes[3] = row3 - row1;
+    planes[4] = row3 + row2;
+    planes[5] = row3 - row2;
+    for (glm::vec4 &plane: planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+
+    std::atomic<size_t> visible(0);
+    auto cull = [&](const TransformComponent &transform, const BoundingSphere &bounds, Visible &result) {
+        const glm::mat4 &model = transforms.getWorld(transform.id);
+        const glm::vec3 center(model[3]);
+        const float scale = std::max({
+            glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))
+        });
+        const float radius = bounds.radius * scale;
+
+        result.value = true;
+        for (const glm::vec4 &plane: planes) {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) {
+                result.value = false;
+                return;
+            }
+        }
+        visible.fetch_add(1, std::memory_order_relaxed);
+    };
+    if (jobs) {
+        query.parallelEach(world, *jobs, cull);
+    } else {
+        query.each(world, cull);
+    }
+    visibleCount = visible.load();
+}
+
+size_t CullingSystem::getVisibleCount() const {
+    return visibleCount;
+}
+
+// Por debajo de este numero de draws por tramo no compensa grabar en paralelo
+static constexpr size_t MIN_DRAWS_PER_LIST = 256;
+
+void RenderSystem::run(World &world, const TransformSystem &transforms, const SceneLight &light, JobSystem *jobs,
+                       std::vector<RenderCommandList> &commandLists) {
+    draws.clear();
+    query.each(world, [&](const TransformComponent &transform, const MeshRenderer &mesh, const Visible &visible) {
+        if (visible.value) {
+            draws.push_back({mesh.vao, mesh.vertexCount, mesh.material, transforms.getWorld(transform.id), mesh.color});
+        }
+    });
+    std::stable_sort(draws.begin(), draws.end(), [](const DrawItem &a, const DrawItem &b) {
+        return a.material != b.material ? a.material < b.material : a.vao < b.vao;
+    });
+
+    const size_t maxLists = jobs ? static_cast<size_t>(jobs->getThreadCount()) : 1;
+    const size_t listCount = std::clamp(draws.size() / MIN_DRAWS_PER_LIST, size_t(1), maxLists);
+    if (commandLists.size() < listCount) {
+        commandLists.resize(listCount);
+    }
+    for (RenderCommandList &list: commandLists) {
+        list.reset();
+    }
+
+    auto record = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            const size_t first = draws.size() * i / listCount;
+            const size_t last = draws.size() * (i + 1) / listCount;
+            recordDraws(draws.data() + first, draws.data() + last, light, commandLists[i]);
+        }
+    };
+    if (jobs && listCount > 1) {
+        jobs->parallelFor(0, static_cast<uint32_t>(listCount), 1, record);
+    } else {
+        record(0, static_cast<uint32_t>(listCount));
+    }
+}
+
+size_t RenderSystem::getDrawCount() const {
+    return draws.size();
+}
@@ -0,0 +1,99 @@
+#include "Shader.h"
+
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <cstring>
+
+Shader::Shader(const char *vertexPath, const char *fragmentPath, ProgramCache *cache) : id(0), vertex(0),
+    fragment(0) {
+    // Con los #include ya expandidos
+    ShaderSource vertexSource;
+    ShaderSource fragmentSource;
+    if (!loadShaderSource(vertexPath, vertexSource) || !loadShaderSource(fragmentPath, fragmentSource)) {
+        std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << vertexPath << " / " << fragmentPath << std::endl;
+    }
+
+    uint64_t key = 0;
+    if (cache) {
+        key = cache->makeKey(vertexSource.text, fragmentSource.text);
+        id = cache->load(key);
+        if (id) {
+            return;
+        }
+    }
+
+    // por que usar c_str?
+    const char *vertexCode = vertexSource.text.c_str();
+    const char *fragmentCode = fragmentSource.text.c_str();
+
+    const uint64_t start = SDL_GetTicksNS();
+    compileVertexShader(vertexCode);
+    compileFragmentShader(fragmentCode);
+    createShaderProgram(cache != nullptr);
+    // Consultar el estado obliga a terminar un enlace diferido: asi se mide el coste real
+    int linked = GL_FALSE;
+    glGetProgramiv(id, GL_LINK_STATUS, &linked);
+    if (linked != GL_TRUE) {
+        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED: " << vertexPath << " / " << fragmentPath << "\n"
+                << infoLog(id, false) << std::endl;
+        glDeleteProgram(id);
+        id = 0;
+        return;
+    }
+    if (cache) {
+        cache->store(key, id, SDL_GetTicksNS() - start);
+    }
+}
+
+std::string Shader::infoLog(unsigned int object, bool shader) {
+    int length = 0;
+    if (shader) {
+        glGetShaderiv(object, GL_INFO_LOG_LENGTH, &length);
+    } else {
+        glGetProgramiv(object, GL_INFO_LOG_LENGTH, &length);
+    }
+    std::string log(static_cast<size_t>(std::max(length, 1)), '\0');
+    if (shader) {
+        glGetShaderInfoLog(object, length, nullptr, log.data());
+    } else {
+        glGetProgramInfoLog(object, length, nullptr, log.data());
+    }
+    log.resize(strlen(log.c_str()));
+    return log;
+}
+
+void Shader::checkCompile(unsigned int shader, const char *stage) {
+    int compiled = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    if (compiled != GL_TRUE) {
+        std::cout << "ERROR::SHADER::" << stage << "::COMPILATION_FAILED\n" << infoLog(shader, true) << std::endl;
+    }
+}
+
+void Shader::compileVertexShader(const char *vertexCode) {
+    vertex = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertex, 1, &vertexCode, nullptr);
+    glCompileShader(vertex);
+    checkCompile(vertex, "VERTEX");
+}
+
+void Shader::compileFragmentShader(const char *fragmentCode) {
+    fragment = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragment, 1, &fragmentCode, nullptr);
+    glCompileShader(fragment);
+    checkCompile(fragment, "FRAGMENT");
+}
+
+void Shader::createShaderProgram(bool retrievable) {
+    id = glCreateProgram();
+    glAttachShader(id, vertex);
+    glAttachShader(id, fragment);
+    if (retrievable) {
+        glProgramParameteri(id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    glLinkProgram(id);
+
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+}
@@ -0,0 +1,521 @@
+#include "ShaderManager.h"
+
+#include <SDL3/SDL.h>
+#include <glad/glad.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+
+#include "AssetFileSystem.h"
+#include "Spirv.h"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+// GL_COMPLETION_STATUS_KHR / _ARB: glad se genero sin extensiones
+static constexpr GLenum COMPLETION_STATUS = 0x91B1;
+// Sin la extension: frames que se deja trabajar al driver antes de preguntar (y quiza bloquear)
+static constexpr int DEFERRED_STATUS_FRAMES = 2;
+// Frames tras aplicar un programa nuevo en los que el viejo aun puede estar en un paquete en vuelo
+// (RenderThread::PACKET_COUNT + 1)
+static constexpr int RETIRE_FRAMES = 3;
+
+static std::string shaderLog(unsigned int shader) {
+    int length = 0;
+    glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+    if (length <= 1) {
+        return "";
+    }
+    std::string log(static_cast<size_t>(length), '\0');
+    glGetShaderInfoLog(shader, length, nullptr, log.data());
+    log.resize(strlen(log.c_str()));
+    return log;
+}
+
+static std::string programLog(unsigned int program) {
+    int length = 0;
+    glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+    if (length <= 1) {
+        return "";
+    }
+    std::string log(static_cast<size_t>(length), '\0');
+    glGetProgramInfoLog(program, length, nullptr, log.data());
+    log.resize(strlen(log.c_str()));
+    return log;
+}
+
+static unsigned int compileShader(GLenum type, const std::string &source) {
+    const unsigned int shader = glCreateShader(type);
+    const char *code = source.c_str();
+    glShaderSource(shader, 1, &code, nullptr);
+    glCompileShader(shader);
+    return shader;
+}
+
+static unsigned int specializeShader(GLenum type, const std::vector<uint32_t> &module,
+                                     const std::vector<std::pair<uint32_t, float> > &specialization) {
+    // glSpecializeShader rechaza ids que el modulo no declara
+    const std::vector<uint32_t> declared = spirvSpecializationIds(module);
+    std::vector<uint32_t> ids;
+    std::vector<uint32_t> values;
+    for (const auto &constant: specialization) {
+        if (std::find(declared.begin(), declared.end(), constant.first) != declared.end()) {
+            uint32_t bits;
+            memcpy(&bits, &constant.second, sizeof(bits));
+            ids.push_back(constant.first);
+            values.push_back(bits);
+        }
+    }
+    const unsigned int shader = glCreateShader(type);
+    glShaderBinary(1, &shader, GL_SHADER_BINARY_FORMAT_SPIR_V, module.data(),
+                   static_cast<GLsizei>(module.size() * sizeof(uint32_t)));
+    glSpecializeShader(shader, "main", static_cast<GLuint>(ids.size()), ids.data(), values.data());
+    return shader;
+}
+
+// Del fichero suelto, que es el que se edita y observa (ver AssetFileSystem::loosePath)
+static std::string canonicalPath(const std::string &path) {
+    std::error_code error;
+    const std::filesystem::path canonical = std::filesystem::weakly_canonical(assetFileSystem().loosePath(path),
+                                                                              error);
+    return error ? path : canonical.string();
+}
+
+ShaderManager::ShaderManager() : cache(nullptr), parallelCompile(false), watchDescriptor(-1),
+                                 inotifyDescriptor(-1), compileCount(0), failedCount(0), reloadCount(0) {
+}
+
+ShaderManager::~ShaderManager() {
+#ifdef __linux__
+    if (inotifyDescriptor >= 0) {
+        close(inotifyDescriptor);
+    }
+#endif
+}
+
+void ShaderManager::begin(ProgramCache *cache) {
+    this->cache = cache;
+    int extensions = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensions);
+    for (int i = 0; i < extensions; i++) {
+        const char *name = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+        if (name && (strcmp(name, "GL_KHR_parallel_shader_compile") == 0 ||
+                     strcmp(name, "GL_ARB_parallel_shader_compile") == 0)) {
+            parallelCompile = true;
+        }
+    }
+}
+
+void ShaderManager::setUniformBlockBinding(const std::string &name, unsigned int binding) {
+    blockBindings.emplace_back(name, binding);
+}
+
+void ShaderManager::setSamplerBinding(const std::string &name, int unit) {
+    samplerBindings.emplace_back(name, unit);
+}
+
+bool ShaderManager::useSpirv(const std::string &directory) {
+    // Las funciones de GL_ARB_gl_spirv solo estan cargadas con un contexto 4.6 (glad sin extensiones)
+    if (!GLAD_GL_VERSION_4_6 || !glSpecializeShader) {
+        spirvDirectory.clear();
+        return false;
+    }
+    spirvDirectory = directory;
+    return true;
+}
+
+void ShaderManager::setSpecializationConstant(uint32_t id, float value) {
+    for (auto &constant: specialization) {
+        if (constant.first == id) {
+            constant.second = value;
+            return;
+        }
+    }
+    specialization.emplace_back(id, value);
+}
+
+ProgramHandle ShaderManager::load(const std::string &vertexPath, const std::string &fragmentPath,
+                                  const ShaderPermutation &permutation) {
+    const std::string variant = vertexPath + "\n" + fragmentPath + "\n" + std::to_string(permutation.key());
+    const auto found = variants.find(variant);
+    if (found != variants.end()) {
+        return found->second;
+    }
+    const ProgramHandle handle = static_cast<ProgramHandle>(programs.size());
+    variants.emplace(variant, handle);
+    programs.emplace_back();
+    Program &program = programs.back();
+    program.vertexPath = vertexPath;
+    program.fragmentPath = fragmentPath;
+    program.defines = permutation.defines();
+    if (!loadShaderSource(vertexPath, program.vertex, program.defines) ||
+        !loadShaderSource(fragmentPath, program.fragment, program.defines)) {
+        SDL_Log("Unable to read shader %s / %s", vertexPath.c_str(), fragmentPath.c_str());
+        std::lock_guard<std::mutex> lock(mutex);
+        lastError = "unable to read " + vertexPath + " / " + fragmentPath;
+        failedCount++;
+        return handle;
+    }
+    submit(handle);
+    return handle;
+}
+
+void ShaderManager::submit(ProgramHandle handle) {
+    Program &program = programs[handle];
+    if (program.pending) {
+        // Se descarta la compilacion anterior: sus fuentes ya no son las del disco
+        glDeleteShader(program.vertexShader);
+        glDeleteShader(program.fragmentShader);
+        glDeleteProgram(program.pending);
+        program.pending = 0;
+    }
+
+    std::vector<uint32_t> vertexModule;
+    std::vector<uint32_t> fragmentModule;
+    program.pendingSpirv =
+            !spirvDirectory.empty() && !program.glslOnly &&
+            readSpirv(spirvPath(spirvDirectory, program.vertexPath, program.vertex), vertexModule) &&
+            readSpirv(spirvPath(spirvDirectory, program.fragmentPath, program.fragment), fragmentModule);
+    if (!spirvDirectory.empty() && !program.glslOnly && !program.pendingSpirv) {
+        SDL_Log("Warning: no SPIR-V modules for %s / %s in %s, compiling GLSL", program.vertexPath.c_str(),
+                program.fragmentPath.c_str(), spirvDirectory.c_str());
+    }
+    // El binario de un programa SPIR-V no tiene nombres de uniforms y depende de sus constantes: no se
+    // mezcla con el del GLSL
+    std::string vertexKey = program.vertex.text;
+    if (program.pendingSpirv) {
+        vertexKey += "\nspirv";
+        for (const auto &constant: specialization) {
+            vertexKey += " " + std::to_string(constant.first) + "=" + std::to_string(constant.second);
+        }
+    }
+    program.key = cache ? cache->makeKey(vertexKey, program.fragment.text) : 0;
+    const unsigned int cached = cache ? cache->load(program.key) : 0;
+    if (cached) {
+        // Ya enlazado: no hace falta esperar a nadie
+        program.pending = cached;
+        program.vertexShader = program.fragmentShader = 0;
+        complete(handle);
+        return;
+    }
+
+    program.submitNS = SDL_GetTicksNS();
+    if (program.pendingSpirv) {
+        program.vertexShader = specializeShader(GL_VERTEX_SHADER, vertexModule, specialization);
+        program.fragmentShader = specializeShader(GL_FRAGMENT_SHADER, fragmentModule, specialization);
+    } else {
+        program.vertexShader = compileShader(GL_VERTEX_SHADER, program.vertex.text);
+        program.fragmentShader = compileShader(GL_FRAGMENT_SHADER, program.fragment.text);
+    }
+    program.pending = glCreateProgram();
+    glAttachShader(program.pending, program.vertexShader);
+    glAttachShader(program.pending, program.fragmentShader);
+    if (cache) {
+        glProgramParameteri(program.pending, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    // Sin consultar nada: el driver puede compilar y enlazar en sus hilos
+    glLinkProgram(program.pending);
+    program.pendingFrames = 0;
+    compileCount++;
+}
+
+bool ShaderManager::isComplete(const Program &program) const {
+    if (parallelCompile) {
+        int done = 0;
+        glGetProgramiv(program.pending, COMPLETION_STATUS, &done);
+        return done != 0;
+    }
+    return program.pendingFrames >= DEFERRED_STATUS_FRAMES;
+}
+
+bool ShaderManager::complete(ProgramHandle handle) {
+    Program &program = programs[handle];
+    const unsigned int candidate = program.pending;
+    program.pending = 0;
+
+    int linked = 0;
+    glGetProgramiv(candidate, GL_LINK_STATUS, &linked);
+    if (!linked && program.pendingSpirv) {
+        // Modulo viejo o driver que no lo acepta: se compila el GLSL
+        SDL_Log("SPIR-V program %s / %s rejected, compiling GLSL:\n%s%s%s", program.vertexPath.c_str(),
+                program.fragmentPath.c_str(), shaderLog(program.vertexShader).c_str(),
+                shaderLog(program.fragmentShader).c_str(), programLog(candidate).c_str());
+        glDeleteShader(program.vertexShader);
+        glDeleteShader(program.fragmentShader);
+        glDeleteProgram(candidate);
+        program.vertexShader = program.fragmentShader = 0;
+        program.glslOnly = true;
+        submit(handle);
+        return false;
+    }
+    if (!linked) {
+        // Se mantiene el programa anterior
+        std::string log;
+        if (program.vertexShader) {
+            log += mapShaderLog(shaderLog(program.vertexShader), program.vertex);
+        }
+        if (program.fragmentShader) {
+            log += mapShaderLog(shaderLog(program.fragmentShader), program.fragment);
+        }
+        log += programLog(candidate);
+        SDL_Log("Shader program %s / %s failed:\n%s", program.vertexPath.c_str(), program.fragmentPath.c_str(),
+                log.c_str());
+        glDeleteShader(program.vertexShader);
+        glDeleteShader(program.fragmentShader);
+        glDeleteProgram(candidate);
+        program.vertexShader = program.fragmentShader = 0;
+        std::lock_guard<std::mutex> lock(mutex);
+        lastError = log;
+        failedCount++;
+        return false;
+    }
+
+    // SPIR-V: sin nombres, el binding ya viene en el modulo
+    for (const auto &block: blockBindings) {
+        const unsigned int index = program.pendingSpirv ? GL_INVALID_INDEX
+                                                 : glGetUniformBlockIndex(candidate, block.first.c_str());
+        if (index != GL_INVALID_INDEX) {
+            glUniformBlockBinding(candidate, index, block.second);
+        }
+    }
+    for (const auto &sampler: samplerBindings) {
+        const int location = program.pendingSpirv ? -1 : glGetUniformLocation(candidate, sampler.first.c_str());
+        if (location != -1) {
+            glProgramUniform1i(candidate, location, sampler.second);
+        }
+    }
+    if (program.vertexShader) {
+        glDeleteShader(program.vertexShader);
+        glDeleteShader(program.fragmentShader);
+        program.vertexShader = program.fragmentShader = 0;
+        if (cache) {
+            cache->store(program.key, candidate, SDL_GetTicksNS() - program.submitNS);
+        }
+    }
+
+    const unsigned int previous = program.active;
+    program.active = candidate;
+    program.spirv = program.pendingSpirv;
+    std::lock_guard<std::mutex> lock(mutex);
+    published.emplace_back(handle, program.spirv ? createMaterialFromLocations(candidate)
+                                                 : createMaterial(candidate));
+    if (previous) {
+        // Sin material no hay comandos grabados con el: se puede borrar sin esperar a applyUpdates
+        const bool bound = handle < materials.size() && materials[handle];
+        retired.push_back({previous, !bound, 0});
+        reloadCount++;
+    }
+    return true;
+}
+
+bool ShaderManager::finish() {
+    const size_t failed = getFailedCount();
+    bool ok = true;
+    for (ProgramHandle handle = 0; handle < programs.size(); handle++) {
+        // Un SPIR-V rechazado vuelve a quedar pendiente con el GLSL
+        while (programs[handle].pending) {
+            complete(handle);
+        }
+        ok = ok && programs[handle].active;
+    }
+    return ok && getFailedCount() == failed;
+}
+
+void ShaderManager::update() {
+    readChanges();
+    for (ProgramHandle handle = 0; handle < programs.size(); handle++) {
+        Program &program = programs[handle];
+        if (!program.pending) {
+            continue;
+        }
+        program.pendingFrames++;
+        if (isComplete(program)) {
+            complete(handle);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (size_t i = 0; i < retired.size();) {
+        Retired &entry = retired[i];
+        if (entry.applied && ++entry.frames > RETIRE_FRAMES) {
+            glDeleteProgram(entry.program);
+            entry = retired.back();
+            retired.pop_back();
+            continue;
+        }
+        i++;
+    }
+}
+
+unsigned int ShaderManager::getProgram(ProgramHandle handle) const {
+    return handle < programs.size() ? programs[handle].active : 0;
+}
+
+Material ShaderManager::getMaterial(ProgramHandle handle) const {
+    const unsigned int program = getProgram(handle);
+    return programs[handle].spirv ? createMaterialFromLocations(program) : createMaterial(program);
+}
+
+void ShaderManager::bindMaterial(ProgramHandle handle, Material *material) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (materials.size() <= handle) {
+        materials.resize(handle + 1, nullptr);
+    }
+    materials[handle] = material;
+}
+
+void ShaderManager::applyUpdates() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (published.empty()) {
+        return;
+    }
+    for (const auto &update: published) {
+        if (update.first < materials.size() && materials[update.first]) {
+            *materials[update.first] = update.second;
+        }
+    }
+    published.clear();
+    // Los paquetes que se graben desde ahora ya no usan los programas viejos
+    for (Retired &entry: retired) {
+        entry.applied = true;
+    }
+}
+
+bool ShaderManager::watch(const std::string &directory) {
+#ifdef __linux__
+    if (inotifyDescriptor < 0) {
+        inotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotifyDescriptor < 0) {
+            SDL_Log("inotify_init1 failed: %s", strerror(errno));
+            return false;
+        }
+    }
+    // Los editores suelen guardar en un temporal y renombrar: IN_MOVED_TO ademas de IN_CLOSE_WRITE
+    watchDescriptor = inotify_add_watch(inotifyDescriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (watchDescriptor < 0) {
+        SDL_Log("Unable to watch %s: %s", directory.c_str(), strerror(errno));
+        return false;
+    }
+    watchedDirectory = directory;
+    return true;
+#else
+    SDL_Log("Shader hot reload is only available on Linux");
+    return false;
+#endif
+}
+
+void ShaderManager::readChanges() {
+#ifdef __linux__
+    if (inotifyDescriptor < 0) {
+        return;
+    }
+    std::vector<std::string> changed;
+    alignas(inotify_event) char buffer[4096];
+    for (;;) {
+        const ssize_t length = read(inotifyDescriptor, buffer, sizeof(buffer));
+        if (length <= 0) {
+            break;
+        }
+        for (ssize_t offset = 0; offset < length;) {
+            const inotify_event *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+            if (event->wd == watchDescriptor && event->len > 0) {
+                changed.push_back(canonicalPath((std::filesystem::path(watchedDirectory) / event->name).string()));
+            }
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+        }
+    }
+    if (changed.empty()) {
+        return;
+    }
+
+    for (ProgramHandle handle = 0; handle < programs.size(); handle++) {
+        Program &program = programs[handle];
+        bool affected = false;
+        for (const std::string &path: changed) {
+            for (const std::string &file: program.vertex.files) {
+                affected = affected || canonicalPath(file) == path;
+            }
+            for (const std::string &file: program.fragment.files) {
+                affected = affected || canonicalPath(file) == path;
+            }
+        }
+        if (!affected) {
+            continue;
+        }
+        ShaderSource vertex;
+        ShaderSource fragment;
+        if (!loadShaderSource(program.vertexPath, vertex, program.defines) ||
+            !loadShaderSource(program.fragmentPath, fragment, program.defines)) {
+            continue;
+        }
+        if (vertex.text == program.vertex.text && fragment.text == program.fragment.text && !program.pending) {
+            continue;
+        }
+        program.vertex = std::move(vertex);
+        program.fragment = std::move(fragment);
+        program.glslOnly = false;
+        SDL_Log("Reloading %s / %s", program.vertexPath.c_str(), program.fragmentPath.c_str());
+        submit(handle);
+    }
+#endif
+}
+
+bool ShaderManager::isParallelCompileSupported() const {
+    return parallelCompile;
+}
+
+size_t ShaderManager::getSpirvCount() const {
+    size_t count = 0;
+    for (const Program &program: programs) {
+        count += program.active && program.spirv;
+    }
+    return count;
+}
+
+size_t ShaderManager::getProgramCount() const {
+    return programs.size();
+}
+
+size_t ShaderManager::getCompileCount() const {
+    return compileCount;
+}
+
+size_t ShaderManager::getFailedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return failedCount;
+}
+
+size_t ShaderManager::getReloadCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return reloadCount;
+}
+
+std::string ShaderManager::getLastError() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return lastError;
+}
+
+void ShaderManager::destroy() {
+    for (Program &program: programs) {
+        if (program.pending) {
+            glDeleteShader(program.vertexShader);
+            glDeleteShader(program.fragmentShader);
+            glDeleteProgram(program.pending);
+        }
+        if (program.active) {
+            glDeleteProgram(program.active);
+        }
+    }
+    programs.clear();
+    variants.clear();
+    std::lock_guard<std::mutex> lock(mutex);
+    materials.clear();
+    for (const Retired &entry: retired) {
+        glDeleteProgram(entry.program);
+    }
+    retired.clear();
+    published.clear();
+}
@@ -0,0 +1,184 @@
+#include "ShaderSource.h"
+
+#include <SDL3/SDL.h>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+
+#include "AssetFileSystem.h"
+
+uint32_t ShaderPermutation::key() const {
+    return lightCount << 3 | (textured ? 1u : 0u) | (instanced ? 2u : 0u) | (shadows ? 4u : 0u);
+}
+
+ShaderDefines ShaderPermutation::defines() const {
+    ShaderDefines defines = {{"LIGHT_COUNT", std::to_string(lightCount)}};
+    if (textured) {
+        defines.emplace_back("TEXTURED", "1");
+    }
+    if (instanced) {
+        defines.emplace_back("INSTANCED", "1");
+    }
+    if (shadows) {
+        defines.emplace_back("SHADOWS", "1");
+    }
+    return defines;
+}
+
+std::vector<ShaderPermutation> spirvPermutations() {
+    ShaderPermutation textured;
+    textured.textured = true;
+    return {ShaderPermutation(), textured};
+}
+
+static bool readFile(const std::string &path, std::string &text) {
+    AssetData data;
+    if (!assetFileSystem().read(path, data)) {
+        return false;
+    }
+    text.assign(reinterpret_cast<const char *>(data.data()), data.size());
+    return true;
+}
+
+static void appendLine(ShaderSource &source, const std::string &line, uint32_t file, uint32_t number) {
+    source.text += line;
+    source.text += '\n';
+    source.lines.push_back({file, number});
+}
+
+static bool startsWith(const std::string &line, size_t start, const char *directive) {
+    return start != std::string::npos && line.compare(start, strlen(directive), directive) == 0;
+}
+
+// Copia files[file] al final de source expandiendo sus #include
+static bool appendFile(uint32_t file, const ShaderDefines &defines, ShaderSource &source) {
+    const std::string path = source.files[file];
+    std::string text;
+    if (!readFile(path, text)) {
+        if (file > 0) {
+            SDL_Log("Unable to read shader include %s", path.c_str());
+        }
+        return false;
+    }
+
+    std::istringstream in(text);
+    std::string line;
+    uint32_t number = 0;
+    while (std::getline(in, line)) {
+        number++;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        const size_t start = line.find_first_not_of(" \t");
+        if (startsWith(line, start, "#include")) {
+            const size_t open = line.find('"', start);
+            const size_t close = open == std::string::npos ? open : line.find('"', open + 1);
+            if (close == std::string::npos) {
+                SDL_Log("%s:%u: expected #include \"file\"", path.c_str(), number);
+                return false;
+            }
+            const std::filesystem::path included = (std::filesystem::path(path).parent_path() /
+                                                    line.substr(open + 1, close - open - 1)).lexically_normal();
+            bool seen = false;
+            for (const std::string &other: source.files) {
+                seen = seen || std::filesystem::path(other).lexically_normal() == included;
+            }
+            // Ya incluido (o es el propio fichero): se omite
+            if (!seen) {
+                source.files.push_back(included.string());
+                if (!appendFile(static_cast<uint32_t>(source.files.size() - 1), defines, source)) {
+                    return false;
+                }
+            }
+            continue;
+        }
+
+        appendLine(source, line, file, number);
+        if (file == 0 && startsWith(line, start, "#version")) {
+            for (const auto &define: defines) {
+                appendLine(source, "#define " + define.first + " " + define.second, file, number);
+            }
+        }
+    }
+    return true;
+}
+
+bool loadShaderSource(const std::string &path, ShaderSource &source, const ShaderDefines &defines) {
+    source.text.clear();
+    source.files = {path};
+    source.lines.clear();
+    return appendFile(0, defines, source);
+}
+
+// Linea de la fuente que cita una linea del log y donde empieza el mensaje; 0 si no cita ninguna
+static int parseLogLine(const std::string &entry, size_t &message) {
+    const char *text = entry.c_str();
+    int string = 0;
+    int line = 0;
+    int column = 0;
+    int consumed = 0;
+    // Mesa: "0:12(5): error: ..."
+    if (sscanf(text, "%d:%d(%d):%n", &string, &line, &column, &consumed) == 3 && consumed > 0) {
+        message = static_cast<size_t>(consumed);
+        return line;
+    }
+    // NVIDIA: "0(12) : error C0000: ..."
+    consumed = 0;
+    if (sscanf(text, "%d(%d) :%n", &string, &line, &consumed) == 2 && consumed > 0) {
+        message = static_cast<size_t>(consumed);
+        return line;
+    }
+    // AMD, Intel en Windows, ANGLE: "ERROR: 0:12: ..."
+    for (const char *prefix: {"ERROR: ", "WARNING: "}) {
+        const size_t length = strlen(prefix);
+        consumed = 0;
+        if (entry.compare(0, length, prefix) == 0 &&
+            sscanf(text + length, "%d:%d:%n", &string, &line, &consumed) == 2 && consumed > 0) {
+            message = length + static_cast<size_t>(consumed);
+            return line;
+        }
+    }
+    return 0;
+}
+
+static std::string sourceLine(const std::string &text, int line) {
+    size_t start = 0;
+    for (int i = 1; i < line && start != std::string::npos; i++) {
+        start = text.find('\n', start);
+        start = start == std::string::npos ? start : start + 1;
+    }
+    if (start == std::string::npos) {
+        return "";
+    }
+    const size_t end = text.find('\n', start);
+    return text.substr(start, end == std::string::npos ? std::string::npos : end - start);
+}
+
+std::string mapShaderLog(const std::string &log, const ShaderSource &source) {
+    std::ostringstream out;
+    std::istringstream in(log);
+    std::string entry;
+    while (std::getline(in, entry)) {
+        size_t message = 0;
+        const int line = parseLogLine(entry, message);
+        if (line <= 0 || static_cast<size_t>(line) > source.lines.size()) {
+            out << entry << "\n";
+            continue;
+        }
+        const ShaderSource::Line &origin = source.lines[static_cast<size_t>(line) - 1];
+        const size_t skip = entry.find_first_not_of(' ', message);
+        out << source.files[origin.file] << ":" << origin.line << ": "
+                << (skip == std::string::npos ? "" : entry.substr(skip)) << "\n";
+        out << "    | " << sourceLine(source.text, line) << "\n";
+    }
+    return out.str();
+}
+
+uint64_t hashShaderSource(const ShaderSource &source) {
+    uint64_t hash = 14695981039346656037ull;
+    for (const char c: source.text) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+    }
+    return hash;
+}
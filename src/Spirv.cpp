@@ -0,0 +1,60 @@
+#include "Spirv.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#include "AssetFileSystem.h"
+
+static constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+static constexpr size_t SPIRV_HEADER_WORDS = 5;
+static constexpr uint32_t SPIRV_OP_DECORATE = 71;
+static constexpr uint32_t SPIRV_DECORATION_SPEC_ID = 1;
+
+std::string spirvPath(const std::string &directory, const std::string &stagePath, const ShaderSource &source) {
+    char hash[24];
+    snprintf(hash, sizeof(hash), ".%016" PRIx64 ".spv", hashShaderSource(source));
+    return (std::filesystem::path(directory) / (std::filesystem::path(stagePath).filename().string() + hash)).
+            string();
+}
+
+bool readSpirv(const std::string &path, std::vector<uint32_t> &words) {
+    AssetData data;
+    if (!assetFileSystem().read(path, data) || data.size() < SPIRV_HEADER_WORDS * 4 || data.size() % 4 != 0) {
+        return false;
+    }
+    words.resize(data.size() / 4);
+    memcpy(words.data(), data.data(), data.size());
+    return words[0] == SPIRV_MAGIC;
+}
+
+size_t countSpirvInstructions(const std::vector<uint32_t> &words) {
+    size_t count = 0;
+    // Cada instruccion empieza con (numero de palabras << 16) | opcode
+    for (size_t i = SPIRV_HEADER_WORDS; i < words.size();) {
+        const uint32_t length = words[i] >> 16;
+        if (length == 0) {
+            break;
+        }
+        i += length;
+        count++;
+    }
+    return count;
+}
+
+std::vector<uint32_t> spirvSpecializationIds(const std::vector<uint32_t> &words) {
+    std::vector<uint32_t> ids;
+    // OpDecorate %constante SpecId <id>
+    for (size_t i = SPIRV_HEADER_WORDS; i < words.size();) {
+        const uint32_t length = words[i] >> 16;
+        if (length == 0 || i + length > words.size()) {
+            break;
+        }
+        if ((words[i] & 0xFFFF) == SPIRV_OP_DECORATE && length == 4 && words[i + 2] == SPIRV_DECORATION_SPEC_ID) {
+            ids.push_back(words[i + 3]);
+        }
+        i += length;
+    }
+    return ids;
+}
@@ -0,0 +1,164 @@
+#include "SurfaceUpload.h"
+
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SURFACE_SSE2 1
+#endif
+
+bool describeSurface(const SDL_Surface *surface, SurfaceLayout &layout) {
+    // Formatos empaquetados: la correspondencia con los tipos empaquetados de GL no depende del endianness
+    layout.opaque = false;
+    switch (surface->format) {
+        case SDL_PIXELFORMAT_RGBX8888:
+            layout.opaque = true;
+            [[fallthrough]];
+        case SDL_PIXELFORMAT_RGBA8888:
+            layout.format = GL_RGBA;
+            layout.type = GL_UNSIGNED_INT_8_8_8_8;
+            break;
+        case SDL_PIXELFORMAT_XBGR8888:
+            layout.opaque = true;
+            [[fallthrough]];
+        case SDL_PIXELFORMAT_ABGR8888:
+            layout.format = GL_RGBA;
+            layout.type = GL_UNSIGNED_INT_8_8_8_8_REV;
+            break;
+        case SDL_PIXELFORMAT_XRGB8888:
+            layout.opaque = true;
+            [[fallthrough]];
+        case SDL_PIXELFORMAT_ARGB8888:
+            layout.format = GL_BGRA;
+            layout.type = GL_UNSIGNED_INT_8_8_8_8_REV;
+            break;
+        case SDL_PIXELFORMAT_BGRX8888:
+            layout.opaque = true;
+            [[fallthrough]];
+        case SDL_PIXELFORMAT_BGRA8888:
+            layout.format = GL_BGRA;
+            layout.type = GL_UNSIGNED_INT_8_8_8_8;
+            break;
+        default:
+            return false;
+    }
+    if (surface->pitch % 4 != 0 || surface->pitch < surface->w * 4) {
+        return false;
+    }
+    layout.rowLength = surface->pitch / 4;
+    layout.alignment = surface->pitch % 8 == 0 ? 8 : 4;
+    return true;
+}
+
+bool canExpandSurface(const SDL_Surface *surface) {
+    return surface->format == SDL_PIXELFORMAT_RGB24 || surface->format == SDL_PIXELFORMAT_BGR24;
+}
+
+bool isSurfaceUploadable(const SDL_Surface *surface) {
+    SurfaceLayout layout;
+    return describeSurface(surface, layout) || canExpandSurface(surface);
+}
+
+static void expandRow(const uint8_t *source, uint8_t *rgba, int width, bool bgr) {
+    int x = 0;
+#ifdef SURFACE_SSE2
+    // 4 pixeles por vuelta: el pixel k se desplaza k bytes y se queda con los 3 bytes bajos de su lane
+    const __m128i lane0 = _mm_setr_epi32(0x00FFFFFF, 0, 0, 0);
+    const __m128i lane1 = _mm_setr_epi32(0, 0x00FFFFFF, 0, 0);
+    const __m128i lane2 = _mm_setr_epi32(0, 0, 0x00FFFFFF, 0);
+    const __m128i lane3 = _mm_setr_epi32(0, 0, 0, 0x00FFFFFF);
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+    const __m128i green = _mm_set1_epi32(0x0000FF00);
+    const __m128i blue = _mm_set1_epi32(0x00FF0000);
+    // Cada carga lee 16 bytes y usa 12: el final de la fila va por la version escalar
+    for (; x + 6 <= width; x += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + x * 3));
+        __m128i pixels = _mm_or_si128(
+            _mm_or_si128(_mm_and_si128(v, lane0), _mm_and_si128(_mm_slli_si128(v, 1), lane1)),
+            _mm_or_si128(_mm_and_si128(_mm_slli_si128(v, 2), lane2), _mm_and_si128(_mm_slli_si128(v, 3), lane3)));
+        if (bgr) {
+            pixels = _mm_or_si128(_mm_and_si128(pixels, green),
+                                  _mm_or_si128(_mm_srli_epi32(pixels, 16),
+                                               _mm_and_si128(_mm_slli_epi32(pixels, 16), blue)));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(rgba + x * 4), _mm_or_si128(pixels, alpha));
+    }
+#endif
+    const int red = bgr ? 2 : 0;
+    for (; x < width; x++) {
+        const uint8_t *pixel = source + x * 3;
+        uint8_t *out = rgba + x * 4;
+        out[0] = pixel[red];
+        out[1] = pixel[1];
+        out[2] = pixel[2 - red];
+        out[3] = 255;
+    }
+}
+
+void expandSurfaceRGBA8(const SDL_Surface *surface, uint8_t *rgba) {
+    const bool bgr = surface->format == SDL_PIXELFORMAT_BGR24;
+    for (int y = 0; y < surface->h; y++) {
+        expandRow(static_cast<const uint8_t *>(surface->pixels) + static_cast<size_t>(y) * surface->pitch,
+                  rgba + static_cast<size_t>(y) * surface->w * 4, surface->w, bgr);
+    }
+}
+
+bool uploadSurface(const SDL_Surface *surface, unsigned int pbo) {
+    SurfaceLayout layout;
+    const bool direct = describeSurface(surface, layout);
+    if (!direct && !canExpandSurface(surface)) {
+        return false;
+    }
+    const size_t bytes = direct
+                             ? static_cast<size_t>(surface->pitch) * surface->h
+                             : static_cast<size_t>(surface->w) * surface->h * 4;
+
+    // Las expandidas siempre pasan por un PBO: la conversion escribe directamente en la memoria del driver
+    unsigned int staging = pbo;
+    if (!direct && !staging) {
+        glGenBuffers(1, &staging);
+    }
+    const void *pixels = surface->pixels;
+    std::vector<uint8_t> expanded;
+    if (staging) {
+        // Huerfanar el buffer para no esperar a una subida anterior que lo siga usando
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_DRAW);
+        void *mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes),
+                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        if (mapped) {
+            if (direct) {
+                memcpy(mapped, surface->pixels, bytes);
+            } else {
+                expandSurfaceRGBA8(surface, static_cast<uint8_t *>(mapped));
+            }
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            // Con un PBO enlazado el ultimo argumento de glTexImage2D es un offset dentro del buffer
+            pixels = nullptr;
+        } else {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+    }
+    if (pixels && !direct) {
+        expanded.resize(bytes);
+        expandSurfaceRGBA8(surface, expanded.data());
+        pixels = expanded.data();
+    }
+
+    if (direct) {
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, layout.rowLength);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, layout.alignment);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, surface->w, surface->h, 0, layout.format, layout.type, pixels);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    } else {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, surface->w, surface->h, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, direct && layout.opaque ? GL_ONE : GL_ALPHA);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if (staging != pbo) {
+        glDeleteBuffers(1, &staging);
+    }
+    return true;
+}
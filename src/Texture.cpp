@@ -2,6 +2,9 @@
 #include <glad/glad.h>
 #include <iostream>
 
+#include "AssetFileSystem.h"
+#include "SurfaceUpload.h"
+
 Texture::Texture(const std::string &path) : path(path), width(0), height(0) {
     // genera el id para la textura &id passed as reference so it can be written
     glGenTextures(1, &id);
@@ -10,23 +13,30 @@ Texture::Texture(const std::string &path) : path(path), width(0), height(0) {
 
 Texture::~Texture() {
     if (id) {
-        // TODO CHECK THIS
-        // glDeleteTextures(1, &id);
+        glDeleteTextures(1, &id);
     }
 }
 
 void Texture::loadData() {
-    surface = IMG_Load(path.c_str());
+    SDL_Surface *surface = loadAssetImage(path);
     if (!surface) {
         printf("Unable to load image %s! SDL_image Error: %s\n", path.c_str(), SDL_GetError());
         return;
     }
 
-    SDL_FlipSurface(surface, SDL_FLIP_VERTICAL);
+    // Sin flip: la orientacion la corrigen las UV. Solo se convierte lo que GL no puede leer tal cual
+    if (!isSurfaceUploadable(surface)) {
+        SDL_Surface *converted = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA32);
+        SDL_DestroySurface(surface);
+        surface = converted;
+        if (!surface) {
+            printf("Unable to convert image %s: %s\n", path.c_str(), SDL_GetError());
+            return;
+        }
+    }
 
     width = surface->w;
     height = surface->h;
-    pixelDetails = SDL_GetPixelFormatDetails(surface->format);
 
     glBindTexture(GL_TEXTURE_2D, id);
 
@@ -35,18 +45,8 @@ void Texture::loadData() {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,GL_LINEAR_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER,GL_LINEAR);
 
-
-    unsigned int format = GL_RGB;
-    if (pixelDetails->bytes_per_pixel == 4) {
-        format = GL_RGBA;
-    } else if (pixelDetails->bytes_per_pixel == 3) {
-        format = GL_RGB;
-    } else {
-        printf("Unsupported image format: %d bytes per pixel\n",
-               pixelDetails->bytes_per_pixel);
-    }
-
-    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, surface->pixels);
+    // Formato y pitch exactos de la superficie; RGB24/BGR24 se expanden en un PBO
+    uploadSurface(surface, 0);
     glGenerateMipmap(GL_TEXTURE_2D);
 
     SDL_DestroySurface(surface);
@@ -0,0 +1,296 @@
+#include "TextureCache.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "AssetFileSystem.h"
+
+static constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+static constexpr uint64_t FNV_PRIME = 1099511628211ull;
+// Huella de acquire(): la cabecera de un .tex (tamaño, formato y niveles) cabe de sobra
+static constexpr size_t FINGERPRINT_BYTES = 256;
+
+TextureCache::TextureCache() : streamer(nullptr), vramBudgetBytes(0), frame(0), residentBytes(0), hits(0), misses(0),
+                               evictedCount(0), droppedMipCount(0) {
+}
+
+void TextureCache::begin(TextureStreamer *streamer, size_t vramBudgetBytes) {
+    this->streamer = streamer;
+    this->vramBudgetBytes = vramBudgetBytes;
+}
+
+uint64_t TextureCache::fingerprintFile(const std::string &path) {
+    // Los .tex van sin comprimir en el paquete y mapeados sueltos: solo se tocan las primeras paginas
+    AssetData data;
+    if (!assetFileSystem().read(path, data)) {
+        return 0;
+    }
+    const uint64_t size = data.size();
+    uint64_t hash = FNV_OFFSET;
+    for (size_t i = 0; i < sizeof(size); i++) {
+        hash = (hash ^ ((size >> (i * 8)) & 0xFF)) * FNV_PRIME;
+    }
+    for (size_t i = 0; i < std::min<size_t>(data.size(), FINGERPRINT_BYTES); i++) {
+        hash = (hash ^ data.data()[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+TextureHandle TextureCache::resolve(TextureHandle handle) const {
+    auto alias = aliases.find(handle);
+    return alias != aliases.end() ? alias->second : handle;
+}
+
+TextureHandle TextureCache::acquire(const std::string &path) {
+    // "assets/./a.png", "assets/../assets/a.png" y la ruta absoluta dentro del directorio actual son la misma
+    // clave, y relativa: asi la sigue encontrando AssetFileSystem en el paquete o en su directorio suelto
+    const std::string key = normalizeAssetPath(path);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = byPath.find(key);
+        if (found != byPath.end()) {
+            Entry &cached = entries[found->second];
+            cached.references++;
+            cached.lastUsedFrame = frame;
+            hits++;
+            return found->second;
+        }
+    }
+
+    // Ruta nueva: se pide ya y, si la huella coincide con otra textura, puede ser una copia
+    const uint64_t fingerprint = fingerprintFile(key);
+    const TextureHandle handle = streamer->request(key);
+    TextureHandle original = handle;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Entry &created = entries[handle];
+        created.key = key;
+        created.fingerprint = fingerprint;
+        created.references = 1;
+        created.lastUsedFrame = frame;
+        byPath[key] = handle;
+        misses++;
+        if (fingerprint) {
+            auto found = byFingerprint.find(fingerprint);
+            if (found == byFingerprint.end()) {
+                byFingerprint[fingerprint] = handle;
+            } else {
+                original = found->second;
+                verifications.push_back({handle, original});
+            }
+        }
+    }
+    if (original != handle) {
+        streamer->hashContent(handle);
+        streamer->hashContent(original);
+    }
+    return handle;
+}
+
+void TextureCache::retain(TextureHandle handle) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = entries.find(resolve(handle));
+    if (found != entries.end()) {
+        found->second.references++;
+    }
+}
+
+void TextureCache::release(TextureHandle handle) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = entries.find(resolve(handle));
+    if (found != entries.end() && found->second.references > 0) {
+        found->second.references--;
+    }
+}
+
+void TextureCache::update() {
+    streamer->update();
+
+    std::vector<TextureHandle> evicted;
+    std::vector<TextureHandle> reduced;
+    std::vector<TextureHandle> orphaned;
+    size_t resident = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        frame++;
+        mergeVerified();
+        for (const auto &[handle, cached]: entries) {
+            resident += streamer->getTextureBytes(handle);
+        }
+        residentBytes = resident;
+        if (vramBudgetBytes && residentBytes > vramBudgetBytes) {
+            selectVictims(evicted, reduced);
+        }
+        for (const TextureHandle handle: retired) {
+            if (!aliases.contains(handle)) {
+                orphaned.push_back(handle);
+            }
+        }
+    }
+
+    // Sin el mutex: evict y dropTopMip hacen trabajo GL (dropTopMip lee niveles de vuelta de la GPU)
+    for (const TextureHandle handle: evicted) {
+        resident -= streamer->getTextureBytes(handle);
+        streamer->evict(handle);
+        // Si aun se esta hasheando se recicla en un update posterior
+        if (!streamer->recycle(handle)) {
+            retired.push_back(handle);
+        }
+    }
+    size_t dropped = 0;
+    bool progress = true;
+    while (progress && vramBudgetBytes && resident > vramBudgetBytes) {
+        progress = false;
+        for (const TextureHandle handle: reduced) {
+            if (resident <= vramBudgetBytes) {
+                break;
+            }
+            const size_t freed = streamer->dropTopMip(handle);
+            if (freed) {
+                resident -= freed;
+                dropped++;
+                progress = true;
+            }
+        }
+    }
+    // La carga de una copia unida se descarta en cuanto termina; su id, cuando ya nadie usa el alias
+    for (const TextureHandle handle: retired) {
+        streamer->evict(handle);
+    }
+    std::erase_if(retired, [this, &orphaned](TextureHandle handle) {
+        return std::find(orphaned.begin(), orphaned.end(), handle) != orphaned.end() && streamer->recycle(handle);
+    });
+
+    std::lock_guard<std::mutex> lock(mutex);
+    residentBytes = resident;
+    evictedCount += evicted.size();
+    droppedMipCount += dropped;
+}
+
+void TextureCache::mergeVerified() {
+    for (size_t i = 0; i < verifications.size();) {
+        const Verification pending = verifications[i];
+        uint64_t copyHash = 0;
+        uint64_t originalHash = 0;
+        const bool originalAlive = entries.contains(pending.original);
+        if (originalAlive && (!streamer->getContentHash(pending.copy, copyHash) ||
+                              !streamer->getContentHash(pending.original, originalHash))) {
+            i++;
+            continue;
+        }
+        verifications[i] = verifications.back();
+        verifications.pop_back();
+        if (!originalAlive || !copyHash || copyHash != originalHash) {
+            continue;
+        }
+
+        // Mismo contenido: las referencias y las rutas de la copia pasan a la original
+        Entry &copy = entries[pending.copy];
+        Entry &original = entries[pending.original];
+        original.references += copy.references;
+        original.lastUsedFrame = std::max(original.lastUsedFrame, copy.lastUsedFrame);
+        for (auto &[key, handle]: byPath) {
+            if (handle == pending.copy) {
+                handle = pending.original;
+            }
+        }
+        for (auto &[alias, target]: aliases) {
+            if (target == pending.copy) {
+                target = pending.original;
+            }
+        }
+        aliases[pending.copy] = pending.original;
+        entries.erase(pending.copy);
+        retired.push_back(pending.copy);
+        // La peticion de la copia resulto ser un acierto por contenido
+        misses--;
+        hits++;
+    }
+}
+
+void TextureCache::selectVictims(std::vector<TextureHandle> &evicted, std::vector<TextureHandle> &reduced) {
+    std::vector<std::pair<uint64_t, TextureHandle> > order;
+    for (const auto &[handle, cached]: entries) {
+        if (streamer->getTextureBytes(handle)) {
+            order.emplace_back(cached.lastUsedFrame, handle);
+        }
+    }
+    std::sort(order.begin(), order.end());
+
+    // Primero las que nadie referencia: se borran enteras y salen de la cache
+    size_t resident = residentBytes;
+    for (const auto &[lastUsed, handle]: order) {
+        auto found = entries.find(handle);
+        if (found->second.references > 0) {
+            reduced.push_back(handle);
+            continue;
+        }
+        if (resident <= vramBudgetBytes) {
+            continue;
+        }
+        resident -= streamer->getTextureBytes(handle);
+        evicted.push_back(handle);
+        std::erase_if(byPath, [handle](const auto &path) { return path.second == handle; });
+        std::erase_if(aliases, [handle](const auto &alias) { return alias.second == handle; });
+        std::erase_if(verifications, [handle](const Verification &pending) { return pending.copy == handle; });
+        auto fingerprint = byFingerprint.find(found->second.fingerprint);
+        if (fingerprint != byFingerprint.end() && fingerprint->second == handle) {
+            byFingerprint.erase(fingerprint);
+        }
+        entries.erase(found);
+    }
+}
+
+void TextureCache::requestResolution(TextureHandle handle, float pixels) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        handle = resolve(handle);
+    }
+    streamer->requestResolution(handle, pixels);
+}
+
+unsigned int TextureCache::getTexture(TextureHandle handle) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        handle = resolve(handle);
+        auto found = entries.find(handle);
+        if (found != entries.end()) {
+            found->second.lastUsedFrame = frame;
+        }
+    }
+    return streamer->getTexture(handle);
+}
+
+size_t TextureCache::getResidentBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return residentBytes;
+}
+
+size_t TextureCache::getHits() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+}
+
+size_t TextureCache::getMisses() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+}
+
+double TextureCache::getHitRate() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits + misses ? static_cast<double>(hits) / static_cast<double>(hits + misses) : 0.0;
+}
+
+size_t TextureCache::getEvictedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return evictedCount;
+}
+
+size_t TextureCache::getDroppedMipCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return droppedMipCount;
+}
+
+TextureStreamer *TextureCache::getStreamer() const {
+    return streamer;
+}
@@ -0,0 +1,168 @@
+#include "TextureFile.h"
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "CompressedTexture.h"
+
+// Los .tex empaquetados empiezan en un offset alineado igual que sus niveles
+static_assert(ASSET_PACK_TEXTURE_ALIGNMENT == TEXTURE_FILE_ALIGNMENT);
+
+static uint64_t alignOffset(uint64_t offset) {
+    return (offset + TEXTURE_FILE_ALIGNMENT - 1) / TEXTURE_FILE_ALIGNMENT * TEXTURE_FILE_ALIGNMENT;
+}
+
+bool writeTextureFile(const std::string &path, uint32_t format, int width, int height,
+                      const std::vector<std::vector<uint8_t> > &levels) {
+    if (levels.empty() || levels.size() > TEXTURE_FILE_MAX_LEVELS) {
+        printf("%s: %zu mip levels, expected 1-%u\n", path.c_str(), levels.size(), TEXTURE_FILE_MAX_LEVELS);
+        return false;
+    }
+
+    TextureFileHeader header = {};
+    header.magic = TEXTURE_FILE_MAGIC;
+    header.version = TEXTURE_FILE_VERSION;
+    header.format = format;
+    header.levelCount = static_cast<uint32_t>(levels.size());
+    header.width = static_cast<uint32_t>(width);
+    header.height = static_cast<uint32_t>(height);
+    uint64_t offset = alignOffset(sizeof(header));
+    for (uint32_t level = 0; level < header.levelCount; level++) {
+        header.levels[level] = {
+            offset, levels[level].size(), static_cast<uint32_t>(std::max(width >> level, 1)),
+            static_cast<uint32_t>(std::max(height >> level, 1))
+        };
+        offset = alignOffset(offset + levels[level].size());
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        printf("Unable to write %s\n", path.c_str());
+        return false;
+    }
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    const std::vector<char> padding(TEXTURE_FILE_ALIGNMENT, 0);
+    uint64_t written = sizeof(header);
+    for (uint32_t level = 0; level < header.levelCount; level++) {
+        file.write(padding.data(), static_cast<std::streamsize>(header.levels[level].offset - written));
+        file.write(reinterpret_cast<const char *>(levels[level].data()),
+                   static_cast<std::streamsize>(levels[level].size()));
+        written = header.levels[level].offset + levels[level].size();
+    }
+    // Relleno final: el ultimo nivel tambien ocupa paginas completas
+    file.write(padding.data(), static_cast<std::streamsize>(alignOffset(written) - written));
+    return static_cast<bool>(file);
+}
+
+MappedTextureFile::MappedTextureFile() {
+}
+
+MappedTextureFile::~MappedTextureFile() {
+    close();
+}
+
+bool MappedTextureFile::open(const std::string &path) {
+    close();
+    if (!assetFileSystem().read(path, data)) {
+        printf("Unable to open %s\n", path.c_str());
+        return false;
+    }
+
+    const size_t size = data.size();
+    if (size < sizeof(TextureFileHeader) || reinterpret_cast<uintptr_t>(data.data()) % alignof(TextureFileHeader)) {
+        printf("%s is not a valid texture file\n", path.c_str());
+        close();
+        return false;
+    }
+    const TextureFileHeader &header = getHeader();
+    bool valid = header.magic == TEXTURE_FILE_MAGIC && header.version == TEXTURE_FILE_VERSION &&
+                 header.levelCount >= 1 && header.levelCount <= TEXTURE_FILE_MAX_LEVELS &&
+                 (header.format == TEXTURE_FILE_RGBA8 || header.format <= BLOCK_FORMAT_COUNT);
+    for (uint32_t level = 0; valid && level < header.levelCount; level++) {
+        const TextureFileLevel &info = header.levels[level];
+        const size_t expected = header.format == TEXTURE_FILE_RGBA8
+                                    ? static_cast<size_t>(info.width) * info.height * 4
+                                    : blockFormatLevelBytes(static_cast<BlockFormat>(header.format - 1),
+                                                            static_cast<int>(info.width),
+                                                            static_cast<int>(info.height));
+        valid = info.size == expected && info.offset % TEXTURE_FILE_ALIGNMENT == 0 && info.offset + info.size <= size;
+    }
+    if (!valid) {
+        printf("%s is not a valid texture file\n", path.c_str());
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedTextureFile::close() {
+    data = AssetData();
+}
+
+void MappedTextureFile::prefetch(uint32_t firstLevel) const {
+    // Los niveles van de mayor a menor: de firstLevel hasta el final del fichero
+    data.prefetch(firstLevel < getHeader().levelCount ? getHeader().levels[firstLevel].offset : data.size());
+}
+
+const TextureFileHeader &MappedTextureFile::getHeader() const {
+    return *reinterpret_cast<const TextureFileHeader *>(data.data());
+}
+
+const uint8_t *MappedTextureFile::getLevelData(uint32_t level) const {
+    return data.data() + getHeader().levels[level].offset;
+}
+
+size_t MappedTextureFile::getDataBytes() const {
+    size_t bytes = 0;
+    for (uint32_t level = 0; level < getHeader().levelCount; level++) {
+        bytes += getHeader().levels[level].size;
+    }
+    return bytes;
+}
+
+void uploadTextureFileLevel(const MappedTextureFile &file, uint32_t level) {
+    const TextureFileHeader &header = file.getHeader();
+    const TextureFileLevel &info = header.levels[level];
+    const int width = static_cast<int>(info.width);
+    const int height = static_cast<int>(info.height);
+    const uint8_t *pixels = file.getLevelData(level);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    if (header.format == TEXTURE_FILE_RGBA8) {
+        // El driver lee directamente de las paginas mapeadas
+        glTexImage2D(GL_TEXTURE_2D, static_cast<int>(level), GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                     pixels);
+        return;
+    }
+    const BlockFormat blockFormat = static_cast<BlockFormat>(header.format - 1);
+    if (isBlockFormatSupported(blockFormat)) {
+        glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<int>(level), blockFormatGLFormat(blockFormat), width, height,
+                               0, static_cast<int>(info.size), pixels);
+        return;
+    }
+    std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+    decompressImage(blockFormat, pixels, width, height, rgba.data());
+    glTexImage2D(GL_TEXTURE_2D, static_cast<int>(level), GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                 rgba.data());
+}
+
+unsigned int createTextureFromFile(const MappedTextureFile &file, uint32_t baseLevel) {
+    const TextureFileHeader &header = file.getHeader();
+    baseLevel = std::min(baseLevel, header.levelCount - 1);
+
+    unsigned int texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, header.levelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<int>(baseLevel));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<int>(header.levelCount) - 1);
+    for (uint32_t level = baseLevel; level < header.levelCount; level++) {
+        uploadTextureFileLevel(file, level);
+    }
+    return texture;
+}
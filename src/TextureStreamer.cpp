@@ -0,0 +1,727 @@
+#include "TextureStreamer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "AssetFileSystem.h"
+#include "SurfaceUpload.h"
+
+// PBOs en vuelo como maximo; si se agotan la subida espera al siguiente frame
+static constexpr size_t MAX_PBOS = 4;
+// Streaming de mips: se cargan de entrada los niveles de hasta 64x64 (unos KB) y un nivel sobrante
+// se suelta tras medio segundo sin que nadie lo pida, para no subir y soltar en cada frame
+static constexpr uint32_t MIP_STREAM_TAIL_SIZE = 64;
+static constexpr int MIP_STREAM_OUT_FRAMES = 30;
+static constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+static constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+TextureStreamer::TextureStreamer() : jobs(nullptr), loader(nullptr), uploadBudgetBytes(0), mipBudgetBytes(0), streamedBytes(0),
+                                     streamedLevelsIn(0), streamedLevelsOut(0), placeholder(0), lastUploadBytes(0),
+                                     readyCount(0), failedCount(0), evictedCount(0) {
+}
+
+TextureStreamer::~TextureStreamer() {
+}
+
+void TextureStreamer::begin(JobSystem *jobs, size_t uploadBudgetBytes, GpuLoader *loader) {
+    this->jobs = jobs;
+    this->loader = loader;
+    this->uploadBudgetBytes = uploadBudgetBytes;
+
+    // Damero magenta/negro 2x2: visible a proposito mientras la textura real no llega
+    const uint8_t pixels[] = {
+        255, 0, 255, 255, 0, 0, 0, 255,
+        0, 0, 0, 255, 255, 0, 255, 255
+    };
+    glGenTextures(1, &placeholder);
+    glBindTexture(GL_TEXTURE_2D, placeholder);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 2, 2, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+}
+
+void TextureStreamer::setMipBudget(size_t bytes) {
+    mipBudgetBytes = bytes;
+}
+
+StreamedTextureId TextureStreamer::request(const std::string &path) {
+    StreamedTextureId id;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (freeIds.empty()) {
+            id = static_cast<StreamedTextureId>(entries.size());
+            entries.emplace_back().path = path;
+        } else {
+            id = freeIds.back();
+            freeIds.pop_back();
+            entries[id].path = path;
+        }
+    }
+
+    if (!jobs || jobs->getThreadCount() == 1) {
+        decode(id);
+        return id;
+    }
+    jobs->schedule({decodeJob, this, id, id + 1, 0, nullptr}, &decodes);
+    return id;
+}
+
+void TextureStreamer::decodeJob(void *data, uint32_t begin, uint32_t) {
+    static_cast<TextureStreamer *>(data)->decode(begin);
+}
+
+void TextureStreamer::hashContent(StreamedTextureId id) {
+    Entry &target = entry(id);
+    if (target.hashing || target.hashed) {
+        return;
+    }
+    target.hashing = true;
+    if (!jobs || jobs->getThreadCount() == 1) {
+        hash(id);
+        return;
+    }
+    jobs->schedule({hashJob, this, id, id + 1, 0, nullptr}, &decodes);
+}
+
+void TextureStreamer::hashJob(void *data, uint32_t begin, uint32_t) {
+    static_cast<TextureStreamer *>(data)->hash(begin);
+}
+
+void TextureStreamer::hash(StreamedTextureId id) {
+    Entry &target = entry(id);
+    // FNV-1a de todo el fichero
+    uint64_t hash = 0;
+    AssetData data;
+    if (assetFileSystem().read(target.path, data)) {
+        hash = FNV_OFFSET;
+        for (size_t i = 0; i < data.size(); i++) {
+            hash = (hash ^ data.data()[i]) * FNV_PRIME;
+        }
+    }
+    target.contentHash = hash;
+    target.hashed = true;
+    target.hashing = false;
+}
+
+bool TextureStreamer::getContentHash(StreamedTextureId id, uint64_t &hash) const {
+    const Entry &target = entry(id);
+    if (!target.hashed) {
+        return false;
+    }
+    hash = target.contentHash;
+    return true;
+}
+
+void TextureStreamer::fail(StreamedTextureId id) {
+    entry(id).state = STATE_FAILED;
+    failedCount++;
+}
+
+// Hilo GL: bytes de un nivel de la textura enlazada (comprimida o RGBA8); 0 si esta vacio
+static size_t measureBoundLevelBytes(int level) {
+    int width = 0;
+    int height = 0;
+    int compressed = 0;
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_WIDTH, &width);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_HEIGHT, &height);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED, &compressed);
+    if (!compressed) {
+        return static_cast<size_t>(width) * height * 4;
+    }
+    int size = 0;
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &size);
+    return static_cast<size_t>(size);
+}
+
+// Hilo GL: suma los niveles [BASE_LEVEL, MAX_LEVEL] de la textura enlazada
+static size_t measureBoundTextureBytes() {
+    int baseLevel = 0;
+    int maxLevel = 0;
+    glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, &baseLevel);
+    glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, &maxLevel);
+    size_t bytes = 0;
+    for (int level = baseLevel; level <= maxLevel; level++) {
+        const size_t levelBytes = measureBoundLevelBytes(level);
+        if (levelBytes == 0) {
+            break;
+        }
+        bytes += levelBytes;
+    }
+    return bytes;
+}
+
+void TextureStreamer::publish(StreamedTextureId id) {
+    Entry &target = entry(id);
+    glBindTexture(GL_TEXTURE_2D, target.texture);
+    target.bytes = measureBoundTextureBytes();
+    if (target.file) {
+        streamed.push_back(id);
+        streamedBytes += target.bytes;
+    }
+    target.state = STATE_READY;
+    readyCount++;
+}
+
+int TextureStreamer::streamTailBase(const MappedTextureFile &file) {
+    const TextureFileHeader &header = file.getHeader();
+    int level = 0;
+    while (level + 1 < static_cast<int>(header.levelCount) &&
+           std::max(header.levels[level].width, header.levels[level].height) > MIP_STREAM_TAIL_SIZE) {
+        level++;
+    }
+    return level;
+}
+
+void TextureStreamer::decodeCompressed(StreamedTextureId id) {
+    Entry &target = entry(id);
+    auto image = std::make_shared<CompressedImage>();
+    if (!readDds(target.path, *image)) {
+        fail(id);
+        return;
+    }
+
+    if (loader) {
+        queueLoaderUpload(id, loader->load(GPU_RESOURCE_TEXTURE, [image]() {
+            return createCompressedTexture(*image);
+        }));
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    decoded.push_back({id, nullptr, image, nullptr});
+    target.state = STATE_DECODED;
+}
+
+void TextureStreamer::mapTextureFile(StreamedTextureId id) {
+    Entry &target = entry(id);
+    auto file = std::make_shared<MappedTextureFile>();
+    if (!file->open(target.path)) {
+        fail(id);
+        return;
+    }
+    // Con streaming solo se suben ahora los niveles pequeños; el resto se pide en update()
+    int baseLevel = 0;
+    if (mipBudgetBytes) {
+        baseLevel = streamTailBase(*file);
+        target.file = file;
+        target.residentBase = baseLevel;
+        target.tailBase = baseLevel;
+    }
+    // Los fallos de pagina se pagan aqui, en el worker, y no al subir
+    file->prefetch(static_cast<uint32_t>(baseLevel));
+
+    if (loader) {
+        queueLoaderUpload(id, loader->load(GPU_RESOURCE_TEXTURE, [file, baseLevel]() {
+            return createTextureFromFile(*file, static_cast<uint32_t>(baseLevel));
+        }));
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    decoded.push_back({id, nullptr, nullptr, file});
+    target.state = STATE_DECODED;
+}
+
+void TextureStreamer::queueLoaderUpload(StreamedTextureId id, GpuResourceId resource) {
+    Entry &target = entry(id);
+    target.resource = resource;
+    target.loaded = true;
+    std::lock_guard<std::mutex> lock(mutex);
+    loading.push_back(id);
+    target.state = STATE_UPLOADING;
+}
+
+static bool hasExtension(const std::string &path, const char *extension) {
+    const size_t length = strlen(extension);
+    return path.size() > length && path.compare(path.size() - length, length, extension) == 0;
+}
+
+void TextureStreamer::decode(StreamedTextureId id) {
+    Entry &target = entry(id);
+    if (hasExtension(target.path, ".dds")) {
+        decodeCompressed(id);
+        return;
+    }
+    if (hasExtension(target.path, ".tex")) {
+        mapTextureFile(id);
+        return;
+    }
+
+    SDL_Surface *surface = loadAssetImage(target.path);
+    if (!surface) {
+        printf("Unable to load image %s! SDL_image Error: %s\n", target.path.c_str(), SDL_GetError());
+        fail(id);
+        return;
+    }
+
+    // Lo que uploadSurface no acepta se convierte aqui, en el worker, y no en el hilo GL
+    if (!isSurfaceUploadable(surface)) {
+        SDL_Surface *converted = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA32);
+        SDL_DestroySurface(surface);
+        surface = converted;
+        if (!surface) {
+            printf("Unable to convert image %s: %s\n", target.path.c_str(), SDL_GetError());
+            fail(id);
+            return;
+        }
+    }
+
+    if (loader) {
+        queueLoaderUpload(id, loader->loadTexture(surface));
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    decoded.push_back({id, surface, nullptr, nullptr});
+    target.state = STATE_DECODED;
+}
+
+void TextureStreamer::update() {
+    lastUploadBytes = 0;
+    if (loader) {
+        loader->publish();
+        std::vector<StreamedTextureId> published;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 0; i < loading.size();) {
+                if (!loader->isReady(entries[loading[i]].resource)) {
+                    i++;
+                    continue;
+                }
+                published.push_back(loading[i]);
+                loading[i] = loading.back();
+                loading.pop_back();
+            }
+        }
+        for (const StreamedTextureId id: published) {
+            entry(id).texture = loader->get(entry(id).resource);
+            publish(id);
+        }
+        streamMips();
+        return;
+    }
+
+    // Publicar las subidas cuya fence ya se señalo, sin bloquear
+    for (size_t i = 0; i < uploads.size();) {
+        Upload &pending = uploads[i];
+        if (glClientWaitSync(pending.fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+            i++;
+            continue;
+        }
+        glDeleteSync(pending.fence);
+        if (pending.pbo) {
+            freePBOs.push_back(pending.pbo);
+        }
+        publish(pending.id);
+        pending = uploads.back();
+        uploads.pop_back();
+    }
+
+    // Subir hasta agotar el presupuesto; siempre al menos una imagen para no atascarse con las grandes
+    while (lastUploadBytes < uploadBudgetBytes || lastUploadBytes == 0) {
+        DecodedImage image;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (decoded.empty()) {
+                break;
+            }
+            image = decoded.front();
+        }
+        if (!upload(image)) {
+            break;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            decoded.pop_front();
+        }
+        lastUploadBytes += imageBytes(image);
+        if (image.surface) {
+            SDL_DestroySurface(image.surface);
+        }
+    }
+    streamMips();
+}
+
+void TextureStreamer::requestResolution(StreamedTextureId id, float pixels) {
+    Entry &target = entry(id);
+    target.demand = std::max(target.demand, pixels);
+}
+
+void TextureStreamer::streamMips() {
+    std::vector<std::pair<int, StreamedTextureId> > wanted;
+    for (const StreamedTextureId id: streamed) {
+        Entry &target = entry(id);
+        // Nivel cuyo tamaño se acerca al diametro en pantalla; sin peticion, solo la cola inicial
+        int base = target.tailBase;
+        if (target.demand > 0.0f) {
+            const TextureFileHeader &header = target.file->getHeader();
+            const float size = static_cast<float>(std::max(header.width, header.height));
+            base = static_cast<int>(std::floor(std::log2(std::max(size / target.demand, 1.0f))));
+        }
+        base = std::clamp(base, target.minimumBase, target.tailBase);
+        target.lastDemand = target.demand;
+        target.demand = 0.0f;
+
+        if (base > target.residentBase) {
+            if (++target.idleFrames >= MIP_STREAM_OUT_FRAMES) {
+                unloadLevel(target);
+                target.idleFrames = 0;
+            }
+            continue;
+        }
+        target.idleFrames = 0;
+        if (base < target.residentBase) {
+            wanted.emplace_back(target.residentBase - base, id);
+        }
+    }
+
+    // Primero las que mas resolucion necesitan, un nivel por textura y frame, dentro de los dos presupuestos.
+    // Si el de mips no da, se quita el nivel mayor a las que se ven mas pequeñas que esta
+    std::sort(wanted.begin(), wanted.end(), std::greater<>());
+    for (const auto &[missingLevels, id]: wanted) {
+        if (lastUploadBytes >= uploadBudgetBytes) {
+            break;
+        }
+        Entry &target = entry(id);
+        const int level = target.residentBase - 1;
+        const size_t levelBytes = target.file->getHeader().levels[level].size;
+        while (streamedBytes + levelBytes > mipBudgetBytes) {
+            Entry *victim = lowestDemandVictim(id, target.lastDemand);
+            if (!victim) {
+                break;
+            }
+            unloadLevel(*victim);
+        }
+        if (streamedBytes + levelBytes > mipBudgetBytes) {
+            continue;
+        }
+        // El nivel se sube fuera de [BASE_LEVEL, MAX_LEVEL] y solo despues se amplia el rango
+        glBindTexture(GL_TEXTURE_2D, target.texture);
+        uploadTextureFileLevel(*target.file, static_cast<uint32_t>(level));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+        const size_t bytes = measureBoundLevelBytes(level);
+        target.residentBase = level;
+        target.bytes += bytes;
+        streamedBytes += bytes;
+        lastUploadBytes += bytes;
+        streamedLevelsIn++;
+    }
+}
+
+TextureStreamer::Entry *TextureStreamer::lowestDemandVictim(StreamedTextureId except, float demand) {
+    Entry *victim = nullptr;
+    for (const StreamedTextureId id: streamed) {
+        Entry &candidate = entry(id);
+        if (id == except || candidate.residentBase >= candidate.tailBase || candidate.lastDemand >= demand) {
+            continue;
+        }
+        // A igual demanda, la que tiene el nivel mas grande
+        if (!victim || candidate.lastDemand < victim->lastDemand ||
+            (candidate.lastDemand == victim->lastDemand && candidate.residentBase < victim->residentBase)) {
+            victim = &candidate;
+        }
+    }
+    return victim;
+}
+
+size_t TextureStreamer::unloadLevel(Entry &target) {
+    const int level = target.residentBase;
+    glBindTexture(GL_TEXTURE_2D, target.texture);
+    const size_t bytes = measureBoundLevelBytes(level);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level + 1);
+    // Un nivel de 0x0 libera su memoria; fuera de [BASE_LEVEL, MAX_LEVEL] no afecta a la completitud
+    glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    target.residentBase = level + 1;
+    target.bytes -= std::min(bytes, target.bytes);
+    streamedBytes -= std::min(bytes, streamedBytes);
+    streamedLevelsOut++;
+    return bytes;
+}
+
+size_t TextureStreamer::imageBytes(const DecodedImage &image) const {
+    if (image.mapped) {
+        // Con streaming de mips solo se suben los niveles desde residentBase
+        const TextureFileHeader &header = image.mapped->getHeader();
+        size_t bytes = 0;
+        for (uint32_t level = entry(image.id).residentBase; level < header.levelCount; level++) {
+            bytes += header.levels[level].size;
+        }
+        return bytes;
+    }
+    if (image.compressed) {
+        size_t bytes = 0;
+        for (const std::vector<uint8_t> &level: image.compressed->levels) {
+            bytes += level.size();
+        }
+        return bytes;
+    }
+    return static_cast<size_t>(image.surface->w) * image.surface->h * 4;
+}
+
+bool TextureStreamer::upload(const DecodedImage &image) {
+    if (image.compressed || image.mapped) {
+        // Ya vienen con sus mips: se suben directamente, sin PBO ni glGenerateMipmap
+        Entry &target = entry(image.id);
+        target.texture = image.mapped
+                             ? createTextureFromFile(*image.mapped, static_cast<uint32_t>(target.residentBase))
+                             : createCompressedTexture(*image.compressed);
+        uploads.push_back({image.id, 0, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0)});
+        target.state = STATE_UPLOADING;
+        return true;
+    }
+
+    if (freePBOs.empty()) {
+        // Solo cuentan las subidas que retienen un PBO
+        const auto inFlight = std::count_if(uploads.begin(), uploads.end(), [](const Upload &pending) {
+            return pending.pbo != 0;
+        });
+        if (static_cast<size_t>(inFlight) >= MAX_PBOS) {
+            return false;
+        }
+        unsigned int pbo;
+        glGenBuffers(1, &pbo);
+        freePBOs.push_back(pbo);
+    }
+    const unsigned int pbo = freePBOs.back();
+    freePBOs.pop_back();
+
+    Entry &target = entry(image.id);
+    glGenTextures(1, &target.texture);
+    glBindTexture(GL_TEXTURE_2D, target.texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    // Copia al PBO con el formato de la superficie, o RGB24/BGR24 expandido a RGBA8 en la misma pasada
+    uploadSurface(image.surface, pbo);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    uploads.push_back({image.id, pbo, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0)});
+    target.state = STATE_UPLOADING;
+    return true;
+}
+
+TextureStreamer::Entry &TextureStreamer::entry(StreamedTextureId id) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return const_cast<Entry &>(entries[id]);
+}
+
+unsigned int TextureStreamer::getTexture(StreamedTextureId id) const {
+    const Entry &target = entry(id);
+    return target.state == STATE_READY ? target.texture : placeholder;
+}
+
+bool TextureStreamer::isReady(StreamedTextureId id) const {
+    return entry(id).state == STATE_READY;
+}
+
+size_t TextureStreamer::getTextureBytes(StreamedTextureId id) const {
+    const Entry &target = entry(id);
+    return target.state == STATE_READY ? target.bytes : 0;
+}
+
+void TextureStreamer::evict(StreamedTextureId id) {
+    Entry &target = entry(id);
+    if (target.state != STATE_READY) {
+        return;
+    }
+    if (target.loaded) {
+        loader->release(target.resource);
+    } else {
+        glDeleteTextures(1, &target.texture);
+    }
+    if (target.file) {
+        std::erase(streamed, id);
+        streamedBytes -= std::min(target.bytes, streamedBytes);
+        target.file.reset();
+    }
+    target.texture = 0;
+    target.bytes = 0;
+    target.state = STATE_EVICTED;
+    readyCount--;
+    evictedCount++;
+}
+
+bool TextureStreamer::recycle(StreamedTextureId id) {
+    Entry &target = entry(id);
+    const int state = target.state;
+    if ((state != STATE_EVICTED && state != STATE_FAILED) || target.hashing) {
+        return false;
+    }
+    // Evicted y failed ya no tienen textura, subidas ni job pendientes
+    target.path.clear();
+    target.resource = 0;
+    target.loaded = false;
+    target.residentBase = 0;
+    target.tailBase = 0;
+    target.minimumBase = 0;
+    target.demand = 0.0f;
+    target.lastDemand = 0.0f;
+    target.idleFrames = 0;
+    target.hashed = false;
+    target.contentHash = 0;
+    target.state = STATE_DECODING;
+    if (state == STATE_EVICTED) {
+        evictedCount--;
+    } else {
+        failedCount--;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    freeIds.push_back(id);
+    return true;
+}
+
+size_t TextureStreamer::dropTopMip(StreamedTextureId id) {
+    Entry &target = entry(id);
+    if (target.state != STATE_READY) {
+        return 0;
+    }
+    if (target.file) {
+        // En streaming basta con soltar el nivel, y el streaming ya no lo vuelve a subir
+        if (target.residentBase + 1 >= static_cast<int>(target.file->getHeader().levelCount)) {
+            return 0;
+        }
+        const size_t freed = unloadLevel(target);
+        target.minimumBase = target.residentBase;
+        target.tailBase = std::max(target.tailBase, target.residentBase);
+        return freed;
+    }
+    glBindTexture(GL_TEXTURE_2D, target.texture);
+    int maxLevel = 0;
+    glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, &maxLevel);
+    int levels = 1;
+    for (; levels <= maxLevel; levels++) {
+        int width = 0;
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, levels, GL_TEXTURE_WIDTH, &width);
+        if (width == 0) {
+            break;
+        }
+    }
+    if (levels < 2) {
+        return 0;
+    }
+
+    // Lectura sincrona desde la GPU: cuesta, pero solo ocurre cuando la cache se pasa del presupuesto
+    unsigned int reduced;
+    glGenTextures(1, &reduced);
+    std::vector<uint8_t> pixels;
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    for (int level = 1; level < levels; level++) {
+        int width = 0;
+        int height = 0;
+        int compressed = 0;
+        int format = 0;
+        glBindTexture(GL_TEXTURE_2D, target.texture);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_WIDTH, &width);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_HEIGHT, &height);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED, &compressed);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_INTERNAL_FORMAT, &format);
+        if (compressed) {
+            int size = 0;
+            glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &size);
+            pixels.resize(static_cast<size_t>(size));
+            glGetCompressedTexImage(GL_TEXTURE_2D, level, pixels.data());
+            glBindTexture(GL_TEXTURE_2D, reduced);
+            glCompressedTexImage2D(GL_TEXTURE_2D, level - 1, static_cast<unsigned int>(format), width, height, 0, size,
+                                   pixels.data());
+        } else {
+            pixels.resize(static_cast<size_t>(width) * height * 4);
+            glGetTexImage(GL_TEXTURE_2D, level, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+            glBindTexture(GL_TEXTURE_2D, reduced);
+            glTexImage2D(GL_TEXTURE_2D, level - 1, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                         pixels.data());
+        }
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levels > 2 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 2);
+    const size_t bytes = measureBoundTextureBytes();
+
+    // La nueva es del streamer aunque la original la hubiera creado el loader
+    if (target.loaded) {
+        loader->release(target.resource);
+        target.loaded = false;
+    } else {
+        glDeleteTextures(1, &target.texture);
+    }
+    const size_t freed = target.bytes - std::min(bytes, target.bytes);
+    target.texture = reduced;
+    target.bytes = bytes;
+    return freed;
+}
+
+size_t TextureStreamer::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size() - freeIds.size() - readyCount - failedCount - evictedCount;
+}
+
+size_t TextureStreamer::getReadyCount() const {
+    return readyCount;
+}
+
+size_t TextureStreamer::getFailedCount() const {
+    return failedCount;
+}
+
+size_t TextureStreamer::getLastUploadBytes() const {
+    return lastUploadBytes;
+}
+
+size_t TextureStreamer::getStreamedBytes() const {
+    return streamedBytes;
+}
+
+size_t TextureStreamer::getStreamedLevelsIn() const {
+    return streamedLevelsIn;
+}
+
+size_t TextureStreamer::getStreamedLevelsOut() const {
+    return streamedLevelsOut;
+}
+
+void TextureStreamer::waitForDecodes() {
+    if (jobs) {
+        jobs->wait(decodes);
+    }
+}
+
+void TextureStreamer::destroy() {
+    for (const Upload &pending: uploads) {
+        glDeleteSync(pending.fence);
+        if (pending.pbo) {
+            glDeleteBuffers(1, &pending.pbo);
+        }
+    }
+    uploads.clear();
+    if (!freePBOs.empty()) {
+        glDeleteBuffers(static_cast<GLsizei>(freePBOs.size()), freePBOs.data());
+        freePBOs.clear();
+    }
+    for (const DecodedImage &image: decoded) {
+        if (image.surface) {
+            SDL_DestroySurface(image.surface);
+        }
+    }
+    decoded.clear();
+    loading.clear();
+    streamed.clear();
+    streamedBytes = 0;
+    for (Entry &target: entries) {
+        // Las del loader las borra GpuLoader::destroy
+        if (target.texture && !target.loaded) {
+            glDeleteTextures(1, &target.texture);
+            target.texture = 0;
+        }
+    }
+    if (placeholder) {
+        glDeleteTextures(1, &placeholder);
+        placeholder = 0;
+    }
+}
@@ -0,0 +1,405 @@
+#include "TransformSystem.h"
+
+#include <algorithm>
+#include <atomic>
+
+// El bloque de 4 nodos carga los quaternions tal cual: necesita el orden x, y, z, w de glm por defecto
+#if (defined(__SSE__) || defined(_M_X64)) && !defined(GLM_FORCE_QUAT_DATA_WXYZ)
+#include <xmmintrin.h>
+#define TRANSFORM_SSE 1
+#endif
+
+// Por debajo de este numero de nodos por nivel no compensa repartir el trabajo
+static constexpr uint32_t PARALLEL_THRESHOLD = 16384;
+static constexpr uint32_t PARALLEL_GRAIN = 4096;
+
+static inline void composeLocal(const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale,
+                                glm::mat4 &out) {
+    const glm::mat3 basis = glm::mat3_cast(rotation);
+    out[0] = glm::vec4(basis[0] * scale.x, 0.0f);
+    out[1] = glm::vec4(basis[1] * scale.y, 0.0f);
+    out[2] = glm::vec4(basis[2] * scale.z, 0.0f);
+    out[3] = glm::vec4(position, 1.0f);
+}
+
+// out = parent * local, aprovechando que local es afin (ultima fila 0 0 0 1). Nodos sueltos: los que no
+// completan un bloque de 4 (ver composeMultiply4)
+static inline void multiplyAffine(const glm::mat4 &parent, const glm::mat4 &local, glm::mat4 &out) {
+#ifdef TRANSFORM_SSE
+    const float *p = &parent[0][0];
+    const __m128 p0 = _mm_loadu_ps(p);
+    const __m128 p1 = _mm_loadu_ps(p + 4);
+    const __m128 p2 = _mm_loadu_ps(p + 8);
+    const __m128 p3 = _mm_loadu_ps(p + 12);
+    for (int c = 0; c < 4; c++) {
+        __m128 r = _mm_mul_ps(p0, _mm_set1_ps(local[c][0]));
+        r = _mm_add_ps(r, _mm_mul_ps(p1, _mm_set1_ps(local[c][1])));
+        r = _mm_add_ps(r, _mm_mul_ps(p2, _mm_set1_ps(local[c][2])));
+        if (c == 3) {
+            r = _mm_add_ps(r, p3);
+        }
+        _mm_storeu_ps(&out[c][0], r);
+    }
+#else
+    out = parent * local;
+#endif
+}
+
+#ifdef TRANSFORM_SSE
+static const glm::mat4 IDENTITY(1.0f);
+
+// 4 vec3 seguidos (48 bytes) a un registro por componente
+static inline void loadVec3x4(const glm::vec3 *values, __m128 &x, __m128 &y, __m128 &z) {
+    static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "vec3 sin relleno");
+    const float *v = &values[0].x;
+    const __m128 a = _mm_loadu_ps(v);
+    const __m128 b = _mm_loadu_ps(v + 4);
+    const __m128 c = _mm_loadu_ps(v + 8);
+    x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+    y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)),
+                       _MM_SHUFFLE(2, 0, 2, 0));
+    z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), c, _MM_SHUFFLE(3, 0, 2, 0));
+}
+
+// Cuatro nodos consecutivos, uno por carril: quaternions, escalas y posiciones se trasponen para que cada
+// registro lleve el mismo elemento de los cuatro. Compone la local y la multiplica por el padre sin pasar
+// por glm::mat4. Las matrices de mundo son afines, asi que la ultima fila no se calcula. Los hermanos van
+// seguidos (sortByDepth): si comparten padre, sus elementos se replican en vez de trasponer cuatro matrices
+static void composeMultiply4(const glm::vec3 *position, const glm::quat *rotation, const glm::vec3 *scale,
+                             const glm::mat4 *const parent[4], glm::mat4 *out) {
+    __m128 qx = _mm_loadu_ps(&rotation[0].x);
+    __m128 qy = _mm_loadu_ps(&rotation[1].x);
+    __m128 qz = _mm_loadu_ps(&rotation[2].x);
+    __m128 qw = _mm_loadu_ps(&rotation[3].x);
+    _MM_TRANSPOSE4_PS(qx, qy, qz, qw);
+
+    // glm::mat3_cast, columna a columna, por la escala de cada eje
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 xx = _mm_mul_ps(qx, qx), yy = _mm_mul_ps(qy, qy), zz = _mm_mul_ps(qz, qz);
+    const __m128 xy = _mm_mul_ps(qx, qy), xz = _mm_mul_ps(qx, qz), yz = _mm_mul_ps(qy, qz);
+    const __m128 wx = _mm_mul_ps(qw, qx), wy = _mm_mul_ps(qw, qy), wz = _mm_mul_ps(qw, qz);
+    __m128 local[4][3] = {
+        {
+            _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), _mm_mul_ps(two, _mm_add_ps(xy, wz)),
+            _mm_mul_ps(two, _mm_sub_ps(xz, wy))
+        },
+        {
+            _mm_mul_ps(two, _mm_sub_ps(xy, wz)), _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))),
+            _mm_mul_ps(two, _mm_add_ps(yz, wx))
+        },
+        {
+            _mm_mul_ps(two, _mm_add_ps(xz, wy)), _mm_mul_ps(two, _mm_sub_ps(yz, wx)),
+            _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy)))
+        }
+    };
+    loadVec3x4(position, local[3][0], local[3][1], local[3][2]);
+    __m128 scales[3];
+    loadVec3x4(scale, scales[0], scales[1], scales[2]);
+    for (int c = 0; c < 3; c++) {
+        for (int k = 0; k < 3; k++) {
+            local[c][k] = _mm_mul_ps(local[c][k], scales[c]);
+        }
+    }
+
+    // p[k][r]: elemento (columna k, fila r) de los cuatro padres
+    __m128 p[4][3];
+    if (parent[0] == parent[3]) {
+        for (int k = 0; k < 4; k++) {
+            const __m128 column = _mm_loadu_ps(&(*parent[0])[k][0]);
+            p[k][0] = _mm_shuffle_ps(column, column, _MM_SHUFFLE(0, 0, 0, 0));
+            p[k][1] = _mm_shuffle_ps(column, column, _MM_SHUFFLE(1, 1, 1, 1));
+            p[k][2] = _mm_shuffle_ps(column, column, _MM_SHUFFLE(2, 2, 2, 2));
+        }
+    } else {
+        for (int k = 0; k < 4; k++) {
+            __m128 c0 = _mm_loadu_ps(&(*parent[0])[k][0]);
+            __m128 c1 = _mm_loadu_ps(&(*parent[1])[k][0]);
+            __m128 c2 = _mm_loadu_ps(&(*parent[2])[k][0]);
+            __m128 c3 = _mm_loadu_ps(&(*parent[3])[k][0]);
+            _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+            p[k][0] = c0;
+            p[k][1] = c1;
+            p[k][2] = c2;
+        }
+    }
+
+    const __m128 zero = _mm_setzero_ps();
+    for (int c = 0; c < 4; c++) {
+        __m128 rows[4];
+        for (int r = 0; r < 3; r++) {
+            __m128 value = _mm_mul_ps(p[0][r], local[c][0]);
+            value = _mm_add_ps(value, _mm_mul_ps(p[1][r], local[c][1]));
+            value = _mm_add_ps(value, _mm_mul_ps(p[2][r], local[c][2]));
+            rows[r] = c == 3 ? _mm_add_ps(value, p[3][r]) : value;
+        }
+        rows[3] = c == 3 ? one : zero;
+        _MM_TRANSPOSE4_PS(rows[0], rows[1], rows[2], rows[3]);
+        for (int i = 0; i < 4; i++) {
+            _mm_storeu_ps(&out[i][c][0], rows[i]);
+        }
+    }
+}
+#endif
+
+TransformId TransformSystem::create(TransformId parent) {
+    const TransformId id = static_cast<TransformId>(idToSlot.size());
+    const uint32_t slot = static_cast<uint32_t>(parents.size());
+
+    const uint32_t parentSlot = parent == NO_PARENT ? NO_PARENT : idToSlot[parent];
+    const uint32_t depth = parentSlot == NO_PARENT ? 0 : depths[parentSlot] + 1;
+
+    parents.push_back(parentSlot);
+    positions.emplace_back(0.0f);
+    rotations.emplace_back(1.0f, 0.0f, 0.0f, 0.0f);
+    scales.emplace_back(1.0f);
+    worlds.emplace_back(1.0f);
+    dirty.push_back(1);
+    depths.push_back(depth);
+
+    idToSlot.push_back(slot);
+    slotToId.push_back(id);
+
+    // La estructura cambio: reordenar y reconstruir los niveles en el proximo update
+    needsSort = true;
+    return id;
+}
+
+void TransformSystem::markDirty(uint32_t slot) {
+    dirty[slot] = 1;
+    // Con la estructura pendiente de reordenar, sortByDepth rehace los rangos
+    if (!needsSort) {
+        const uint32_t depth = depths[slot];
+        dirtyBegin[depth] = std::min(dirtyBegin[depth], slot);
+        dirtyEnd[depth] = std::max(dirtyEnd[depth], slot + 1);
+    }
+}
+
+void TransformSystem::setPosition(TransformId id, const glm::vec3 &position) {
+    const uint32_t slot = idToSlot[id];
+    positions[slot] = position;
+    markDirty(slot);
+}
+
+void TransformSystem::setRotation(TransformId id, const glm::quat &rotation) {
+    const uint32_t slot = idToSlot[id];
+    rotations[slot] = rotation;
+    markDirty(slot);
+}
+
+void TransformSystem::setScale(TransformId id, const glm::vec3 &scale) {
+    const uint32_t slot = idToSlot[id];
+    scales[slot] = scale;
+    markDirty(slot);
+}
+
+void TransformSystem::setLocal(TransformId id, const glm::vec3 &position, const glm::quat &rotation,
+                               const glm::vec3 &scale) {
+    const uint32_t slot = idToSlot[id];
+    positions[slot] = position;
+    rotations[slot] = rotation;
+    scales[slot] = scale;
+    markDirty(slot);
+}
+
+const glm::mat4 &TransformSystem::getWorld(TransformId id) const {
+    return worlds[idToSlot[id]];
+}
+
+size_t TransformSystem::size() const {
+    return parents.size();
+}
+
+size_t TransformSystem::getLastUpdatedCount() const {
+    return lastUpdated;
+}
+
+// Orden en anchura: por profundidad y, dentro de cada nivel, por slot del padre, de modo que los hijos de
+// un rango de padres son un rango contiguo del nivel siguiente. Solo se ejecuta cuando cambia la estructura
+void TransformSystem::sortByDepth() {
+    const size_t count = parents.size();
+    const uint32_t maxDepth = count ? *std::max_element(depths.begin(), depths.end()) : 0;
+
+    levels.assign(maxDepth + 2, 0);
+    for (const uint32_t depth: depths) {
+        levels[depth + 1]++;
+    }
+    for (size_t d = 1; d < levels.size(); d++) {
+        levels[d] += levels[d - 1];
+    }
+
+    // Hijos de cada slot (orden actual), agrupados por padre
+    std::vector<uint32_t> firstChild(count + 1, 0);
+    for (const uint32_t parent: parents) {
+        if (parent != NO_PARENT) {
+            firstChild[parent + 1]++;
+        }
+    }
+    for (size_t slot = 1; slot <= count; slot++) {
+        firstChild[slot] += firstChild[slot - 1];
+    }
+    std::vector<uint32_t> children(firstChild[count]);
+    std::vector<uint32_t> cursor(firstChild.begin(), firstChild.end() - 1);
+    std::vector<uint32_t> order;
+    order.reserve(count);
+    for (size_t slot = 0; slot < count; slot++) {
+        if (parents[slot] == NO_PARENT) {
+            order.push_back(static_cast<uint32_t>(slot));
+        } else {
+            children[cursor[parents[slot]]++] = static_cast<uint32_t>(slot);
+        }
+    }
+    for (size_t i = 0; i < order.size(); i++) {
+        const uint32_t slot = order[i];
+        order.insert(order.end(), children.begin() + firstChild[slot], children.begin() + firstChild[slot + 1]);
+    }
+
+    std::vector<uint32_t> newSlot(count);
+    for (size_t i = 0; i < count; i++) {
+        newSlot[order[i]] = static_cast<uint32_t>(i);
+    }
+
+    auto permute = [&](auto &values) {
+        std::remove_reference_t<decltype(values)> sorted(values.size());
+        for (size_t slot = 0; slot < count; slot++) {
+            sorted[newSlot[slot]] = values[slot];
+        }
+        values.swap(sorted);
+    };
+    permute(positions);
+    permute(rotations);
+    permute(scales);
+    permute(worlds);
+    permute(dirty);
+    permute(depths);
+    permute(slotToId);
+    permute(parents);
+    for (uint32_t &parent: parents) {
+        if (parent != NO_PARENT) {
+            parent = newSlot[parent];
+        }
+    }
+    for (size_t slot = 0; slot < count; slot++) {
+        idToSlot[slotToId[slot]] = static_cast<uint32_t>(slot);
+    }
+
+    // Los slots cambiaron: cada nivel se revisa entero una vez
+    dirtyBegin.assign(levels.begin(), levels.end() - 1);
+    dirtyEnd.assign(levels.begin() + 1, levels.end());
+    needsSort = false;
+}
+
+// El padre esta en un nivel anterior, ya procesado: si se recalculo, el hijo tambien
+bool TransformSystem::resolveDirty(uint32_t slot) {
+    const uint32_t parent = parents[slot];
+    if (parent != NO_PARENT && dirty[parent]) {
+        dirty[slot] = 1;
+    }
+    return dirty[slot] != 0;
+}
+
+void TransformSystem::updateSlot(uint32_t slot) {
+    glm::mat4 local;
+    composeLocal(positions[slot], rotations[slot], scales[slot], local);
+    const uint32_t parent = parents[slot];
+    if (parent == NO_PARENT) {
+        worlds[slot] = local;
+    } else {
+        multiplyAffine(worlds[parent], local, worlds[slot]);
+    }
+}
+
+void TransformSystem::updateRange(uint32_t begin, uint32_t end, size_t &updated) {
+    uint32_t slot = begin;
+#ifdef TRANSFORM_SSE
+    // Bloques de 4 nodos consecutivos del mismo nivel; si alguno esta limpio, nodo a nodo
+    for (; slot + 4 <= end; slot += 4) {
+        uint32_t mask = 0;
+        for (uint32_t i = 0; i < 4; i++) {
+            mask |= static_cast<uint32_t>(resolveDirty(slot + i)) << i;
+        }
+        if (mask == 0) {
+            continue;
+        }
+        if (mask == 0xF) {
+            const glm::mat4 *parentWorlds[4];
+            for (uint32_t i = 0; i < 4; i++) {
+                const uint32_t parent = parents[slot + i];
+                parentWorlds[i] = parent == NO_PARENT ? &IDENTITY : &worlds[parent];
+            }
+            composeMultiply4(&positions[slot], &rotations[slot], &scales[slot], parentWorlds, &worlds[slot]);
+            updated += 4;
+            continue;
+        }
+        for (uint32_t i = 0; i < 4; i++) {
+            if (mask & 1u << i) {
+                updateSlot(slot + i);
+                updated++;
+            }
+        }
+    }
+#endif
+    for (; slot < end; slot++) {
+        if (resolveDirty(slot)) {
+            updateSlot(slot);
+            updated++;
+        }
+    }
+}
+
+void TransformSystem::update(JobSystem *jobs) {
+    if (needsSort) {
+        sortByDepth();
+    }
+
+    const size_t levelCount = levels.empty() ? 0 : levels.size() - 1;
+    size_t updated = 0;
+    // Rango recalculado del nivel anterior; vacio si no se toco
+    uint32_t parentBegin = 0;
+    uint32_t parentEnd = 0;
+    for (size_t d = 0; d < levelCount; d++) {
+        uint32_t begin = dirtyBegin[d];
+        uint32_t end = dirtyEnd[d];
+        if (parentBegin < parentEnd) {
+            // Dentro del nivel los nodos van ordenados por padre (sortByDepth)
+            const auto first = parents.begin() + levels[d];
+            const auto last = parents.begin() + levels[d + 1];
+            const uint32_t childBegin = static_cast<uint32_t>(
+                std::lower_bound(first, last, parentBegin) - parents.begin());
+            const uint32_t childEnd = static_cast<uint32_t>(
+                std::lower_bound(first, last, parentEnd) - parents.begin());
+            if (childBegin < childEnd) {
+                begin = std::min(begin, childBegin);
+                end = std::max(end, childEnd);
+            }
+        }
+        if (begin >= end) {
+            parentBegin = parentEnd = 0;
+            continue;
+        }
+        // Se guarda el rango recorrido para limpiar solo esa parte al final
+        dirtyBegin[d] = parentBegin = begin;
+        dirtyEnd[d] = parentEnd = end;
+        if (!jobs || end - begin < PARALLEL_THRESHOLD) {
+            updateRange(begin, end, updated);
+            continue;
+        }
+        // parallelFor vuelve cuando el nivel esta completo: el siguiente ya ve a sus padres
+        std::atomic<size_t> levelUpdated(0);
+        jobs->parallelFor(begin, end, PARALLEL_GRAIN, [&](uint32_t first, uint32_t last) {
+            size_t count = 0;
+            updateRange(first, last, count);
+            levelUpdated.fetch_add(count, std::memory_order_relaxed);
+        });
+        updated += levelUpdated.load();
+    }
+
+    for (size_t d = 0; d < levelCount; d++) {
+        if (dirtyBegin[d] < dirtyEnd[d]) {
+            std::fill(dirty.begin() + dirtyBegin[d], dirty.begin() + dirtyEnd[d], 0);
+        }
+        dirtyBegin[d] = UINT32_MAX;
+        dirtyEnd[d] = 0;
+    }
+    lastUpdated = updated;
+}
@@ -7,34 +7,156 @@
 #include <glm.hpp>
 #include <gtc/matrix_transform.hpp>
 #include <gtc/type_ptr.hpp>
+#include <filesystem>
 
+#include "AssetCooker.h"
+#include "AssetFileSystem.h"
 #include "Shader.h"
-#include "Texture.h"
+#include "ShaderManager.h"
+#include "TextureCache.h"
+#include "TextureStreamer.h"
+#include "GpuLoader.h"
 #include "Camera.h"
+#include "AppConfig.h"
+#include "BenchmarkReport.h"
+#include "CameraPath.h"
+#include "HeadlessContext.h"
+#include "InputRecording.h"
+#include "FixedTimestep.h"
+#include "FramePacer.h"
+#include "InputLatch.h"
+#include "Benchmarks.h"
+#include "TransformSystem.h"
+#include "ECS.h"
+#include "JobSystem.h"
+#include "SceneSystems.h"
+#include "FramePacket.h"
+#include "RenderThread.h"
 
 // Variables globales para ventana y contexto OpenGL
 static SDL_Window* window = nullptr;
 static SDL_GLContext context = nullptr;
+// Solo en modo headless (sustituye a window/context)
+static HeadlessContext* headless = nullptr;
+// Contexto compartido del hilo de carga (--loader-thread)
+static SDL_GLContext loaderContext = nullptr;
+static HeadlessContext* loaderHeadless = nullptr;
+// Binarios de los programas de arranque (--program-cache)
+static ProgramCache programCache;
 
 uint64_t lastFrame = 0;
 uint64_t currentFrame = 0;
 float deltaTime = 0.0f;
 
-// TEMPORAL Lo correcto sería usar una clase para el objeto e ir alterando su rotation ahi, o algo.
-float totalRotation = 0.0f;
+// Paso fijo en modo headless para que todas las ejecuciones vean los mismos frames
+#define HEADLESS_DELTA_TIME (1.0f / 60.0f)
 
-#define WINDOW_WIDTH 800
-#define WINDOW_HEIGHT 600
+// Estado de la simulacion que se interpola entre los dos ultimos ticks al renderizar
+typedef struct SimState
+{
+    // TEMPORAL Lo correcto sería usar una clase para el objeto e ir alterando su rotation ahi, o algo.
+    float totalRotation;
+    glm::vec3 cameraPosition;
+} SimState;
 
 typedef struct AppState
 {
     unsigned int VBO, cubeVAO, lightVAO; // Vertex Buffer Object y Vertex Array Object
-    Shader cubeShader;
-    Shader lightShader;
+    // Programas compilados sin bloquear y recargados en caliente con --hot-reload
+    ShaderManager shaders;
+    ProgramHandle cubeProgram;
+    ProgramHandle lightProgram;
     Camera* camera;
+    AppConfig config;
+    BenchmarkReport* report;
+    CameraPath cameraPath;
+    int frameIndex;
+    InputRecorder* recorder;
+    InputReplay* replay;
+    FixedTimestep timestep;
+    SimState previous;
+    SimState current;
+    FramePacer pacer;
+    InputLatch latch;
+    unsigned int cameraUBO;
+    TransformSystem transforms;
+    // Escena: cubo y luz son entidades; render/culling/animacion son sistemas sobre el World
+    World world;
+    AnimationSystem animation;
+    LightSystem lighting;
+    TextureDemandSystem textureDemand;
+    CullingSystem culling;
+    RenderSystem rendering;
+    Material cubeMaterial;
+    Material lightMaterial;
+    JobSystem* jobs;
+    // Texturas decodificadas en los workers y subidas por el hilo de render, servidas por la cache
+    TextureStreamer textures;
+    TextureCache textureCache;
+    GpuLoader loader;
+    TextureHandle woodTexture;
+    TextureHandle faceTexture;
+    // Posee el contexto GL durante la ejecucion; el hilo principal solo produce FramePackets
+    RenderThread renderer;
 } AppState;
 
-SDL_AppResult SDL_AppInit(void** appstate, int argc, char* argv[])
+// La textura cocinada (ver AssetCooker.h): sin decodificar ni generar mips al arrancar. Si no esta en el
+// paquete es un error, salvo en modo desarrollo (devAssets), que decodifica la imagen original suelta
+static bool cookedTexture(const AppConfig& config, const std::string& path, std::string& out)
+{
+    const std::string cooked = cookedAssetPath(path);
+    if (assetFileSystem().exists(cooked))
+    {
+        out = cooked;
+        return true;
+    }
+    if (!config.devAssets)
+    {
+        SDL_Log("%s is not in the asset pack: cook %s (cook target or asset_cooker)", cooked.c_str(), path.c_str());
+        return false;
+    }
+    SDL_Log("%s is not cooked, decoding %s", cooked.c_str(), path.c_str());
+    out = path;
+    return true;
+}
+
+static SDL_AppResult initHeadless(const AppConfig& config)
+{
+    // llvmpipe lee LP_NUM_THREADS al crear el contexto
+    if (config.llvmpipeThreads > 0)
+    {
+        SDL_setenv_unsafe("LP_NUM_THREADS", std::to_string(config.llvmpipeThreads).c_str(), 1);
+    }
+
+    if (!SDL_Init(0))
+    {
+        SDL_Log("SDL_Init failed: %s", SDL_GetError());
+        return SDL_APP_FAILURE;
+    }
+
+    headless = new HeadlessContext();
+    if (!headless->create(config.width, config.height))
+    {
+        SDL_Log("Couldn't create headless OpenGL context");
+        return SDL_APP_FAILURE;
+    }
+
+    SDL_Log("Headless OpenGL context: %s (%dx%d, %d frames)", glGetString(GL_RENDERER), config.width,
+            config.height, config.frames);
+
+    if (config.loaderThread)
+    {
+        loaderHeadless = new HeadlessContext();
+        if (!loaderHeadless->createShared(*headless))
+        {
+            SDL_Log("Couldn't create shared OpenGL context for the loader thread");
+            return SDL_APP_FAILURE;
+        }
+    }
+    return SDL_APP_CONTINUE;
+}
+
+static SDL_AppResult initWindow(const AppConfig& config)
 {
     if (!SDL_Init(SDL_INIT_VIDEO))
     {
@@ -45,9 +167,7 @@ SDL_AppResult SDL_AppInit(void** appstate, int argc, char* argv[])
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, SDL_GL_CONTEXT_DEBUG_FLAG);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 1);
-
-    // SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 6);
 
     // Configurar atributos del contexto OpenGL antes de crearlo
     SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 8); // 8 bits para canal rojo
@@ -57,21 +177,40 @@ SDL_AppResult SDL_AppInit(void** appstate, int argc, char* argv[])
     SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1); // Habilitar double buffering
 
     // Crear ventana con soporte OpenGL
-    window = SDL_CreateWindow("SDL OpenGL", WINDOW_WIDTH, WINDOW_HEIGHT, SDL_WINDOW_OPENGL);
+    window = SDL_CreateWindow("SDL OpenGL", config.width, config.height, SDL_WINDOW_OPENGL);
     if (!window)
     {
         SDL_Log("Couldn't create window: %s", SDL_GetError());
         return SDL_APP_FAILURE;
     }
 
-    // Crear contexto OpenGL asociado a la ventana
+    // Crear contexto OpenGL asociado a la ventana: 4.6 para cargar los shaders SPIR-V cocinados, 4.1 si el
+    // driver no llega (macOS)
     context = SDL_GL_CreateContext(window);
     if (!context)
+    {
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 1);
+        context = SDL_GL_CreateContext(window);
+    }
+    if (!context)
     {
         SDL_Log("Couldn't create OpenGL context: %s", SDL_GetError());
         return SDL_APP_FAILURE;
     }
 
+    if (config.loaderThread)
+    {
+        // El segundo contexto comparte objetos con el actual; crearlo lo activa, asi que se restaura el principal
+        SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
+        loaderContext = SDL_GL_CreateContext(window);
+        if (!loaderContext)
+        {
+            SDL_Log("Couldn't create shared OpenGL context: %s", SDL_GetError());
+            return SDL_APP_FAILURE;
+        }
+        SDL_GL_MakeCurrent(window, context);
+    }
+
     SDL_SetWindowRelativeMouseMode(window, true);
     SDL_SetWindowMouseGrab(window, true);
 
@@ -98,33 +237,145 @@ SDL_AppResult SDL_AppInit(void** appstate, int argc, char* argv[])
         return SDL_APP_FAILURE;
     }
 
-    // TODO Necesito crear con new para que no se destruya una vez salga del contexto actual
-    Texture wood("assets/container.jpg");
-    Texture awesomeface("assets/awesomeface.png");
-
-    // activa texture0 y bindea el id de textura wood a esa textura
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, wood.getID());
-    // glBindTextureUnit(0, wood.getID());
-
-    // activa texture1 y bindea el id de textura awesomeface a esa textura
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, awesomeface.getID());
-    // glBindTextureUnit(1, awesomeface.getID());
-
-    // Constructor se llama por defecto por lo que se debe asignar
-    // Shader ahora, ya que es un objeto no puntero.
-    auto* state = new AppState{
-        0, 0, 0,
-        Shader(
-            "shaders/cube.vert",
-            "shaders/cube.frag"
-        ),
-        Shader(
-            "shaders/light.vert",
-            "shaders/light.frag"
-        )
-    };
+    return SDL_APP_CONTINUE;
+}
+
+// Todos los loaders leen de aqui: con el paquete montado el arranque abre un solo fichero de assets.
+// Fuera del modo desarrollo solo se lee el paquete, asi que sin el no se puede arrancar
+static bool mountAssets(const AppConfig& config)
+{
+    // Sin --source-dir (ni arbol de fuentes en Debug) los ficheros sueltos estan junto al ejecutable
+    const char* basePath = SDL_GetBasePath();
+    const std::string looseDirectory = !config.sourceDirectory.empty() ? config.sourceDirectory
+                                                                       : basePath ? basePath : "";
+    const char* looseName = looseDirectory.empty() ? "the current directory" : looseDirectory.c_str();
+    // Para editar en caliente el fichero suelto (el del arbol de fuentes) gana al empaquetado
+    assetFileSystem().setLooseDirectory(looseDirectory);
+    assetFileSystem().setLooseFirst(config.hotReload);
+    assetFileSystem().setLooseEnabled(config.devAssets);
+    if (config.packPath.empty())
+    {
+        SDL_Log("No asset pack mounted (--no-pack): reading loose files from %s", looseName);
+        return true;
+    }
+    // El paquete por defecto lo deja el target cook junto al ejecutable, no en el directorio actual
+    std::string packPath = config.packPath;
+    if (basePath && std::filesystem::path(packPath).is_relative())
+    {
+        packPath = (std::filesystem::path(basePath) / packPath).string();
+    }
+    if (assetFileSystem().mount(packPath))
+    {
+        SDL_Log("Asset pack %s: %zu entries", packPath.c_str(), assetFileSystem().getEntryCount());
+        return true;
+    }
+    if (!config.devAssets)
+    {
+        SDL_Log("No asset pack mounted: unable to read %s. Build the cook target or pass --pack FILE "
+                "(--source-dir DIR reads the uncooked sources)", packPath.c_str());
+        return false;
+    }
+    SDL_Log("No asset pack mounted: unable to read %s, reading loose files from %s", packPath.c_str(), looseName);
+    return true;
+}
+
+// La cache por defecto no va al directorio actual: en el de preferencias del usuario, escribible aunque el
+// ejecutable este instalado, o si SDL no lo da junto al ejecutable
+static std::string programCacheDirectory(const AppConfig& config)
+{
+    if (std::filesystem::path(config.programCacheDir).is_absolute())
+    {
+        return config.programCacheDir;
+    }
+    std::string base;
+    if (char* prefPath = SDL_GetPrefPath("sdl_ogl", "sdl_ogl"))
+    {
+        base = prefPath;
+        SDL_free(prefPath);
+    }
+    else if (const char* basePath = SDL_GetBasePath())
+    {
+        base = basePath;
+    }
+    return base.empty() ? config.programCacheDir : (std::filesystem::path(base) / config.programCacheDir).string();
+}
+
+SDL_AppResult SDL_AppInit(void** appstate, int argc, char* argv[])
+{
+    AppConfig config;
+    if (!parseAppConfig(argc, argv, config))
+    {
+        return SDL_APP_FAILURE;
+    }
+    if (!mountAssets(config))
+    {
+        return SDL_APP_FAILURE;
+    }
+
+    if (!config.benchmark.empty())
+    {
+        return runBenchmark(config) ? SDL_APP_SUCCESS : SDL_APP_FAILURE;
+    }
+
+    std::string woodPath;
+    std::string facePath;
+    if (!cookedTexture(config, "assets/container.jpg", woodPath) ||
+        !cookedTexture(config, "assets/awesomeface.png", facePath))
+    {
+        return SDL_APP_FAILURE;
+    }
+
+    const SDL_AppResult initResult = config.headless ? initHeadless(config) : initWindow(config);
+    if (initResult != SDL_APP_CONTINUE)
+    {
+        return initResult;
+    }
+
+    ProgramCache* programs = nullptr;
+    if (!config.programCacheDir.empty() && programCache.begin(programCacheDirectory(config)))
+    {
+        programs = &programCache;
+    }
+
+    auto* state = new AppState{};
+    // Los dos programas se compilan a la vez; finish() solo espera a que terminen
+    state->shaders.begin(programs);
+    state->shaders.setUniformBlockBinding("CameraBlock", 0);
+    // Las unidades en las que RenderThread enlaza packet.textures
+    state->shaders.setSamplerBinding("texture1", 0);
+    state->shaders.setSamplerBinding("texture2", 1);
+    // Un modulo que falte (cocinado sin glslangValidator/spirv-opt) o que el driver rechace compila su GLSL
+    if (config.spirv && !state->shaders.useSpirv("shaders/spirv"))
+    {
+        SDL_Log("No OpenGL 4.6 context: SPIR-V unavailable, compiling GLSL");
+    }
+    else if (!config.spirv)
+    {
+        SDL_Log("--no-spirv: compiling GLSL");
+    }
+    // El cubo muestrea las dos texturas de la cache (y su demanda alimenta el streaming de mips)
+    ShaderPermutation textured;
+    textured.textured = true;
+    state->cubeProgram = state->shaders.load("shaders/cube.vert", "shaders/cube.frag", textured);
+    state->lightProgram = state->shaders.load("shaders/light.vert", "shaders/light.frag");
+    if (!state->shaders.finish())
+    {
+        SDL_Log("Unable to build shaders:\n%s", state->shaders.getLastError().c_str());
+        delete state;
+        return SDL_APP_FAILURE;
+    }
+    SDL_Log("Shaders: %zu programs, %zu from SPIR-V", state->shaders.getProgramCount(),
+            state->shaders.getSpirvCount());
+    if (config.hotReload)
+    {
+        state->shaders.watch(assetFileSystem().loosePath("shaders"));
+    }
+    if (programs)
+    {
+        SDL_Log("Program cache: %zu hits, %zu misses, %zu rejected, %.2f ms compiling, %.2f ms saved",
+                programCache.getHits(), programCache.getMisses(), programCache.getRejected(),
+                programCache.getCompileMs(), programCache.getSavedMs());
+    }
 
 
     // Habilitar test de profundidad para 3D correcto
@@ -183,49 +434,49 @@ SDL_AppResult SDL_AppInit(void** appstate, int argc, char* argv[])
     //     -0.5f, 0.5f, -0.5f, 0.0f, 1.0f
     // };
 
-    // xyz - normals
+    // xyz - normals - uv
     constexpr float vertices[] = {
-        -0.5f, -0.5f, -0.5f, 0.0f, 0.0f, -1.0f,
-        0.5f, -0.5f, -0.5f, 0.0f, 0.0f, -1.0f,
-        0.5f, 0.5f, -0.5f, 0.0f, 0.0f, -1.0f,
-        0.5f, 0.5f, -0.5f, 0.0f, 0.0f, -1.0f,
-        -0.5f, 0.5f, -0.5f, 0.0f, 0.0f, -1.0f,
-        -0.5f, -0.5f, -0.5f, 0.0f, 0.0f, -1.0f,
-
-        -0.5f, -0.5f, 0.5f, 0.0f, 0.0f, 1.0f,
-        0.5f, -0.5f, 0.5f, 0.0f, 0.0f, 1.0f,
-        0.5f, 0.5f, 0.5f, 0.0f, 0.0f, 1.0f,
-        0.5f, 0.5f, 0.5f, 0.0f, 0.0f, 1.0f,
-        -0.5f, 0.5f, 0.5f, 0.0f, 0.0f, 1.0f,
-        -0.5f, -0.5f, 0.5f, 0.0f, 0.0f, 1.0f,
-
-        -0.5f, 0.5f, 0.5f, -1.0f, 0.0f, 0.0f,
-        -0.5f, 0.5f, -0.5f, -1.0f, 0.0f, 0.0f,
-        -0.5f, -0.5f, -0.5f, -1.0f, 0.0f, 0.0f,
-        -0.5f, -0.5f, -0.5f, -1.0f, 0.0f, 0.0f,
-        -0.5f, -0.5f, 0.5f, -1.0f, 0.0f, 0.0f,
-        -0.5f, 0.5f, 0.5f, -1.0f, 0.0f, 0.0f,
-
-        0.5f, 0.5f, 0.5f, 1.0f, 0.0f, 0.0f,
-        0.5f, 0.5f, -0.5f, 1.0f, 0.0f, 0.0f,
-        0.5f, -0.5f, -0.5f, 1.0f, 0.0f, 0.0f,
-        0.5f, -0.5f, -0.5f, 1.0f, 0.0f, 0.0f,
-        0.5f, -0.5f, 0.5f, 1.0f, 0.0f, 0.0f,
-        0.5f, 0.5f, 0.5f, 1.0f, 0.0f, 0.0f,
-
-        -0.5f, -0.5f, -0.5f, 0.0f, -1.0f, 0.0f,
-        0.5f, -0.5f, -0.5f, 0.0f, -1.0f, 0.0f,
-        0.5f, -0.5f, 0.5f, 0.0f, -1.0f, 0.0f,
-        0.5f, -0.5f, 0.5f, 0.0f, -1.0f, 0.0f,
-        -0.5f, -0.5f, 0.5f, 0.0f, -1.0f, 0.0f,
-        -0.5f, -0.5f, -0.5f, 0.0f, -1.0f, 0.0f,
-
-        -0.5f, 0.5f, -0.5f, 0.0f, 1.0f, 0.0f,
-        0.5f, 0.5f, -0.5f, 0.0f, 1.0f, 0.0f,
-        0.5f, 0.5f, 0.5f, 0.0f, 1.0f, 0.0f,
-        0.5f, 0.5f, 0.5f, 0.0f, 1.0f, 0.0f,
-        -0.5f, 0.5f, 0.5f, 0.0f, 1.0f, 0.0f,
-        -0.5f, 0.5f, -0.5f, 0.0f, 1.0f, 0.0f
+        -0.5f, -0.5f, -0.5f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f,
+        0.5f, -0.5f, -0.5f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f,
+        0.5f, 0.5f, -0.5f, 0.0f, 0.0f, -1.0f, 1.0f, 1.0f,
+        0.5f, 0.5f, -0.5f, 0.0f, 0.0f, -1.0f, 1.0f, 1.0f,
+        -0.5f, 0.5f, -0.5f, 0.0f, 0.0f, -1.0f, 0.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f,
+
+        -0.5f, -0.5f, 0.5f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
+        0.5f, -0.5f, 0.5f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f,
+        0.5f, 0.5f, 0.5f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f,
+        0.5f, 0.5f, 0.5f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f,
+        -0.5f, 0.5f, 0.5f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f,
+        -0.5f, -0.5f, 0.5f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
+
+        -0.5f, 0.5f, 0.5f, -1.0f, 0.0f, 0.0f, 1.0f, 0.0f,
+        -0.5f, 0.5f, -0.5f, -1.0f, 0.0f, 0.0f, 1.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f, -1.0f, 0.0f, 0.0f, 0.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f, -1.0f, 0.0f, 0.0f, 0.0f, 1.0f,
+        -0.5f, -0.5f, 0.5f, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+        -0.5f, 0.5f, 0.5f, -1.0f, 0.0f, 0.0f, 1.0f, 0.0f,
+
+        0.5f, 0.5f, 0.5f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f,
+        0.5f, 0.5f, -0.5f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f,
+        0.5f, -0.5f, -0.5f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f,
+        0.5f, -0.5f, -0.5f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f,
+        0.5f, -0.5f, 0.5f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+        0.5f, 0.5f, 0.5f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f,
+
+        -0.5f, -0.5f, -0.5f, 0.0f, -1.0f, 0.0f, 0.0f, 1.0f,
+        0.5f, -0.5f, -0.5f, 0.0f, -1.0f, 0.0f, 1.0f, 1.0f,
+        0.5f, -0.5f, 0.5f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f,
+        0.5f, -0.5f, 0.5f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f,
+        -0.5f, -0.5f, 0.5f, 0.0f, -1.0f, 0.0f, 0.0f, 0.0f,
+        -0.5f, -0.5f, -0.5f, 0.0f, -1.0f, 0.0f, 0.0f, 1.0f,
+
+        -0.5f, 0.5f, -0.5f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f,
+        0.5f, 0.5f, -0.5f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f,
+        0.5f, 0.5f, 0.5f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f,
+        0.5f, 0.5f, 0.5f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f,
+        -0.5f, 0.5f, 0.5f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f,
+        -0.5f, 0.5f, -0.5f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f
     };
 
     // CONFIGURACIÓN DE BUFFERS OPENGL:
@@ -241,12 +492,16 @@ SDL_AppResult SDL_AppInit(void** appstate, int argc, char* argv[])
     // num_componentes: cuántos valores leer (3 para XYZ, 2 para UV)
     // stride: bytes entre vértices consecutivos
     // offset: bytes desde el inicio del vértice hasta este atributo
-    // Formato del buffer: [X Y Z U V] [X Y Z U V] [X Y Z U V]...
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+    // Formato del buffer: [X Y Z NX NY NZ U V] [X Y Z NX NY NZ U V]...
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0); // Habilitar atributo de posición
 
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1); // Habilitar atributo de posición
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1); // Habilitar atributo de normal
+
+    // Layout = 2: UV, solo lo lee la variante TEXTURED de cube.vert
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(2);
 
     // Layout = 1
     // glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *) (3 * sizeof(float)));
@@ -257,16 +512,94 @@ SDL_AppResult SDL_AppInit(void** appstate, int argc, char* argv[])
     glGenVertexArrays(1, &state->lightVAO);
     glBindVertexArray(state->lightVAO);
     glBindBuffer(GL_ARRAY_BUFFER, state->VBO);
-    glVertexAttribPointer(0, 3,GL_FLOAT,GL_FALSE, 6 * sizeof(float), (void*)0);
+    glVertexAttribPointer(0, 3,GL_FLOAT,GL_FALSE, 8 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
 
+    // UBO de camara: se sube una vez por frame y lo comparten ambos shaders
+    glGenBuffers(1, &state->cameraUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, state->cameraUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraUniforms), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, 0, state->cameraUBO);
 
     *appstate = state; // Pasar estado a SDL
-    SDL_GL_SetSwapInterval(1);
+    state->config = config;
+    state->pacer.begin(config.pacing, config.targetFps, config.framesInFlight, config.smoothingFrames, !headless);
+    SDL_Log("Frame pacing: %s, %d frames in flight", FramePacer::modeName(config.pacing), config.framesInFlight);
+
+    currentFrame = SDL_GetTicksNS();
+
+    // El hilo principal es el worker 0 del planificador
+    state->jobs = new JobSystem(config.threads, config.pinThreads);
+    SDL_Log("Job system: %d threads", state->jobs->getThreadCount());
+
+    // Las locations se resuelven aqui, con el contexto GL aun en este hilo
+    state->cubeMaterial = state->shaders.getMaterial(state->cubeProgram);
+    state->lightMaterial = state->shaders.getMaterial(state->lightProgram);
+    // Si se recompilan, applyUpdates() los reescribe
+    state->shaders.bindMaterial(state->cubeProgram, &state->cubeMaterial);
+    state->shaders.bindMaterial(state->lightProgram, &state->lightMaterial);
+
+    // Hasta que terminen de subirse, texture0/texture1 muestran el placeholder
+    if (config.loaderThread)
+    {
+        state->loader.start({window, loaderContext, loaderHeadless});
+    }
+    state->textures.begin(state->jobs, static_cast<size_t>(config.uploadBudgetKB) * 1024,
+                          config.loaderThread ? &state->loader : nullptr);
+    state->textures.setMipBudget(static_cast<size_t>(config.mipBudgetMB) * 1024 * 1024);
+    state->textureCache.begin(&state->textures, static_cast<size_t>(config.vramBudgetMB) * 1024 * 1024);
+    state->woodTexture = state->textureCache.acquire(woodPath);
+    state->faceTexture = state->textureCache.acquire(facePath);
+
+    const TransformId cubeTransform = state->transforms.create();
+    state->world.create(TransformComponent{cubeTransform},
+                        MeshRenderer{state->cubeVAO, 36, &state->cubeMaterial, glm::vec3(1.0f, 0.5f, 0.31f)},
+                        BoundingSphere{0.87f}, Visible{true});
 
-    lastFrame = SDL_GetTicksNS();
+    // TODO temporal, abstraer
+    const glm::vec3 lightPos(1.2f, 1.0f, 2.0f);
+    // glm::vec3 lightPos(0.8f, 1.0f, .0f);
+    const TransformId lightTransform = state->transforms.create();
+    state->transforms.setLocal(lightTransform, lightPos, glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(0.2f)); // Posición del cubo de luz
+    state->world.create(TransformComponent{lightTransform},
+                        MeshRenderer{state->lightVAO, 36, &state->lightMaterial, glm::vec3(1.0f)},
+                        BoundingSphere{0.87f}, Visible{true}, LightSource{glm::vec3(1.0f, 1.0f, 1.0f)});
 
     state->camera = new Camera();
+    state->camera->setAspectRatio(static_cast<float>(config.width) / static_cast<float>(config.height));
+    state->timestep.setTickRate(static_cast<float>(config.tickRate));
+    state->current = {0.0f, state->camera->getPosition()};
+    state->previous = state->current;
+
+    if (!config.recordPath.empty())
+    {
+        state->recorder = new InputRecorder();
+        if (!state->recorder->open(config.recordPath))
+        {
+            return SDL_APP_FAILURE;
+        }
+    }
+    if (!config.replayPath.empty())
+    {
+        state->replay = new InputReplay();
+        if (!state->replay->open(config.replayPath))
+        {
+            return SDL_APP_FAILURE;
+        }
+    }
+
+    if (headless)
+    {
+        state->report = new BenchmarkReport();
+        state->report->begin(config.width, config.height, resolveLlvmpipeThreads(config), config.warmupFrames);
+        state->report->setProgramCache(programCache.getHits(), programCache.getMisses(),
+                                       programCache.getCompileMs(), programCache.getSavedMs());
+    }
+
+    // A partir de aqui el contexto GL pasa al hilo de render
+    state->renderer.start({window, context, headless}, &state->pacer, state->report, state->cameraUBO,
+                          &state->textureCache, &state->shaders, config.renderThread, config.latencyLog);
+    SDL_Log("Render thread: %s", config.renderThread ? "enabled" : "disabled");
 
     return SDL_APP_CONTINUE;
 }
@@ -275,14 +608,16 @@ SDL_AppResult SDL_AppEvent(void* appstate, SDL_Event* event)
 {
     AppState* state = static_cast<AppState*>(appstate);
 
-    if (event->type == SDL_EVENT_MOUSE_MOTION)
+    // El input solo se acumula; se aplica en SDL_AppIterate (durante un replay se ignora el input real)
+    if (!state->replay)
     {
-        if (SDL_GetWindowRelativeMouseMode(window))
+        if (event->type == SDL_EVENT_MOUSE_MOTION && SDL_GetWindowRelativeMouseMode(window))
         {
-            const float xOffset = event->motion.xrel;
-            const float yOffset = event->motion.yrel;
-
-            state->camera->processMouse(xOffset, yOffset);
+            state->latch.addMouseMotion(event->motion);
+        }
+        if (event->type == SDL_EVENT_KEY_DOWN || event->type == SDL_EVENT_KEY_UP)
+        {
+            state->latch.addKey(event->key);
         }
     }
 
@@ -304,78 +639,184 @@ SDL_AppResult SDL_AppEvent(void* appstate, SDL_Event* event)
     return SDL_APP_CONTINUE;
 }
 
-SDL_AppResult SDL_AppIterate(void* appstate)
+// Un tick de simulacion de duracion fija dt, que cubre [tickBeginNS, tickEndNS] en tiempo real
+static void simulate(AppState* state, float dt, uint64_t tickBeginNS, uint64_t tickEndNS)
 {
-    auto* state = static_cast<AppState*>(appstate);
-
-    // TODO temporal, abstraer
-    glm::vec3 lightPos(1.2f, 1.0f, 2.0f);
-    // glm::vec3 lightPos(0.8f, 1.0f, .0f);
-
-    const bool* keys = SDL_GetKeyboardState(nullptr);
-
-    // Delta Time
-    currentFrame = SDL_GetTicksNS();
-    deltaTime = static_cast<float>(currentFrame - lastFrame) / 1000000000.0f;
-    lastFrame = currentFrame;
-
-    // RENDERIZADO:
-    glClearColor(0.2f, 0.3f, 0.3f, 1.0f); // Color de fondo (gris-azulado)
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // Limpiar buffers
-
-
-    if (keys[SDL_SCANCODE_W])
+    // En headless la camara la mueve cameraPath (o el replay)
+    if (!headless || state->replay)
     {
-        state->camera->processKeyboard(FORWARD, deltaTime);
+        // Cada tecla mueve la camara solo la parte del tick en la que estuvo pulsada
+        const float forward = state->latch.heldFraction(SDL_SCANCODE_W, tickBeginNS, tickEndNS);
+        const float backward = state->latch.heldFraction(SDL_SCANCODE_S, tickBeginNS, tickEndNS);
+        const float left = state->latch.heldFraction(SDL_SCANCODE_A, tickBeginNS, tickEndNS);
+        const float right = state->latch.heldFraction(SDL_SCANCODE_D, tickBeginNS, tickEndNS);
+        if (forward > 0.0f)
+        {
+            state->camera->processKeyboard(FORWARD, dt * forward);
+        }
+        if (backward > 0.0f)
+        {
+            state->camera->processKeyboard(BACKWARD, dt * backward);
+        }
+        if (left > 0.0f)
+        {
+            state->camera->processKeyboard(LEFT, dt * left);
+        }
+        if (right > 0.0f)
+        {
+            state->camera->processKeyboard(RIGHT, dt * right);
+        }
     }
-    if (keys[SDL_SCANCODE_S])
+
+    constexpr float speed = 20.0f;
+    state->current.totalRotation += dt * speed;
+    state->current.cameraPosition = state->camera->getPosition();
+}
+
+// Late latch: recoge el movimiento de raton llegado durante la simulacion y lo aplica
+// a la camara justo antes de subirla, para acortar la latencia movimiento-imagen
+static void latchCameraInput(AppState* state)
+{
+    if (!state->replay && SDL_GetWindowRelativeMouseMode(window))
     {
-        state->camera->processKeyboard(BACKWARD, deltaTime);
+        SDL_PumpEvents();
+        SDL_Event events[32];
+        int count;
+        while ((count = SDL_PeepEvents(events, 32, SDL_GETEVENT, SDL_EVENT_MOUSE_MOTION, SDL_EVENT_MOUSE_MOTION)) > 0)
+        {
+            for (int i = 0; i < count; i++)
+            {
+                state->latch.addMouseMotion(events[i].motion);
+            }
+        }
     }
-    if (keys[SDL_SCANCODE_A])
+
+    float xOffset, yOffset;
+    if (state->latch.takeMouseDelta(xOffset, yOffset))
     {
-        state->camera->processKeyboard(LEFT, deltaTime);
+        state->camera->processMouse(xOffset, yOffset);
     }
-    if (keys[SDL_SCANCODE_D])
+}
+
+// Cierre de frame comun a ventana y headless: grabacion y reinicio del input.
+// La latencia la mide el hilo de render al presentar (ver FramePacket)
+static void finishInputFrame(AppState* state)
+{
+    if (state->recorder)
     {
-        state->camera->processKeyboard(RIGHT, deltaTime);
+        for (const InputEvent& input : state->latch.getFrameEvents())
+        {
+            state->recorder->recordEvent(input);
+        }
+        state->recorder->recordFrame(deltaTime, lastFrame, currentFrame);
     }
 
-    // Cube
-    state->cubeShader.use();
-    state->cubeShader.setVec3("objectColor", glm::vec3(1.0f, 0.5f, 0.31f));
-    state->cubeShader.setVec3("lightColor", glm::vec3(1.0f, 1.0f, 1.0f));
-    state->cubeShader.setVec3("lightPos", lightPos);
-    state->cubeShader.setVec3("viewPos", state->camera->position);
+    state->latch.endFrame();
+}
 
-    glm::mat4 projection = glm::perspective(glm::radians(state->camera->fov), static_cast<float>(WINDOW_WIDTH) / static_cast<float>(WINDOW_HEIGHT), 0.1f, 100.0f);
-    glm::mat4 view = state->camera->getViewMatrix();
-    state->cubeShader.setMat4("projection", projection);
-    state->cubeShader.setMat4("view", view);
+// Fin del modo headless: recupera el contexto del hilo de render y escribe el reporte
+static SDL_AppResult finishReport(AppState* state)
+{
+    state->renderer.stop();
+    state->report->setThreadWaits(state->renderer.getMainWaitMs(), state->renderer.getRenderWaitMs());
+    state->report->setTextureCache(state->textureCache.getHitRate(), state->textureCache.getResidentBytes());
+    state->report->finish();
+    return state->report->write(state->config.reportPath) ? SDL_APP_SUCCESS : SDL_APP_FAILURE;
+}
 
-    auto model = glm::mat4(1.0f);
-    constexpr float speed = 20.0f;
-    totalRotation += deltaTime * speed;
-    // model = glm::rotate(model, glm::radians(totalRotation), glm::vec3(1.0f, 0.3f, 0.5f));
-    state->cubeShader.setMat4("model", model);
+SDL_AppResult SDL_AppIterate(void* appstate)
+{
+    auto* state = static_cast<AppState*>(appstate);
 
-    // Render cube
-    glBindVertexArray(state->cubeVAO); // Activar configuración de vértices
-    glDrawArrays(GL_TRIANGLES, 0, 36);
-    glBindVertexArray(0); // Desvincular después de dibujar
+    // Delta Time
+    lastFrame = currentFrame;
+    currentFrame = SDL_GetTicksNS();
+    deltaTime = state->pacer.smoothDelta(static_cast<float>(currentFrame - lastFrame) / 1000000000.0f);
 
-    // Light Cube
-    state->lightShader.use();
-    state->lightShader.setMat4("projection", projection);
-    state->lightShader.setMat4("view", view);
-    model = glm::translate(glm::mat4(1.0f), lightPos); // Posición del cubo de luz
-    model = glm::scale(model, glm::vec3(0.2f));
-    state->lightShader.setMat4("model", model);
+    if (state->replay)
+    {
+        // Paso fijo: se reutiliza el deltaTime grabado, no el reloj real
+        if (!state->replay->nextFrame(deltaTime, lastFrame, currentFrame))
+        {
+            SDL_Log("Replay finished after %u frames", state->replay->getFrameCount());
+            if (headless)
+            {
+                return finishReport(state);
+            }
+            return SDL_APP_SUCCESS;
+        }
+        for (const InputEvent& input : state->replay->getEvents())
+        {
+            state->latch.addEvent(input);
+        }
+    }
+    else if (headless)
+    {
+        deltaTime = HEADLESS_DELTA_TIME;
+        state->cameraPath.apply(*state->camera, static_cast<float>(state->frameIndex) / (state->config.warmupFrames + state->config.frames));
+        // Camara teletransportada: no interpolar desde la posicion anterior
+        state->current.cameraPosition = state->camera->getPosition();
+        state->previous.cameraPosition = state->camera->getPosition();
+    }
 
-    glBindVertexArray(state->lightVAO); // Activar VAO del cubo de luz
-    glDrawArrays(GL_TRIANGLES, 0, 36); // Dibujar cubo
+    // Simulacion de paso fijo, desacoplada del framerate
+    // Los ticks se reparten uniformemente sobre el intervalo real del frame
+    const int ticks = state->timestep.advance(deltaTime);
+    for (int i = 0; i < ticks; i++)
+    {
+        state->previous = state->current;
+        const uint64_t tickBegin = lastFrame + (currentFrame - lastFrame) * i / ticks;
+        const uint64_t tickEnd = lastFrame + (currentFrame - lastFrame) * (i + 1) / ticks;
+        simulate(state, state->timestep.getStep(), tickBegin, tickEnd);
+    }
 
-    SDL_GL_SwapWindow(window); // Intercambiar buffers (mostrar frame renderizado)
+    // Interpolar entre los dos ultimos ticks
+    const float alpha = state->timestep.getAlpha();
+    const float rotation = glm::mix(state->previous.totalRotation, state->current.totalRotation, alpha);
+    const glm::vec3 eyePosition = glm::mix(state->previous.cameraPosition, state->current.cameraPosition, alpha);
+
+    // Bloquea si el hilo de render va dos frames por detras
+    FramePacket* packet = state->renderer.acquirePacket();
+    // Programas recompilados por el hilo de render: se usan desde este paquete
+    state->shaders.applyUpdates();
+
+    // La vista se calcula lo mas tarde posible, justo antes de entregar el paquete
+    latchCameraInput(state);
+    packet->camera.projection = state->camera->getProjectionMatrix();
+    packet->camera.view = state->camera->getViewMatrix(eyePosition);
+    packet->camera.viewPos = glm::vec4(eyePosition, 1.0f);
+    packet->cameraVersion = state->camera->getVersion();
+    packet->eyePosition = eyePosition;
+    packet->clearColor = glm::vec4(0.2f, 0.3f, 0.3f, 1.0f); // Color de fondo (gris-azulado)
+    packet->textures[0] = state->woodTexture;
+    packet->textures[1] = state->faceTexture;
+    packet->textureCount = 2;
+
+    // Para que el cubo gire basta con crearlo con Spin{glm::normalize(glm::vec3(1.0f, 0.3f, 0.5f)), 1.0f}
+    state->animation.run(state->world, state->transforms, rotation);
+    state->transforms.update(state->jobs);
+    state->culling.run(state->world, state->transforms, packet->camera.projection * packet->camera.view, state->jobs);
+    // Las dos texturas van en el material del cubo: sus mips siguen a lo que ocupa en pantalla
+    const float cubeDemand = state->textureDemand.run(state->world, state->transforms, &state->cubeMaterial,
+                                                      packet->camera.projection, eyePosition, state->config.height);
+    packet->textureDemand[0] = cubeDemand;
+    packet->textureDemand[1] = cubeDemand;
+    // Grabacion de comandos en paralelo; el hilo de render solo los reproduce
+    state->rendering.run(state->world, state->transforms, state->lighting.run(state->world, state->transforms),
+                         state->jobs, packet->commandLists);
+
+    packet->simTicks = ticks;
+    packet->oldestEventNS = state->replay ? 0 : state->latch.getOldestEventNS();
+    packet->newestEventNS = state->latch.getNewestEventNS();
+    packet->eventCount = state->latch.getFrameEvents().size();
+    state->renderer.submit(packet);
+
+    finishInputFrame(state);
+
+    if (headless && ++state->frameIndex >= state->config.warmupFrames + state->config.frames)
+    {
+        return finishReport(state);
+    }
 
     return SDL_APP_CONTINUE;
 }
@@ -386,6 +827,16 @@ void SDL_AppQuit(void* appstate, SDL_AppResult result)
 
     if (state)
     {
+        // Devuelve el contexto GL a este hilo antes de borrar nada
+        state->renderer.stop();
+        SDL_Log("Render thread: main waited %.1f ms, render waited %.1f ms", state->renderer.getMainWaitMs(),
+                state->renderer.getRenderWaitMs());
+        // Las decodificaciones en curso escriben en el streamer: esperarlas antes de liberarlo
+        state->textures.waitForDecodes();
+        state->loader.stop();
+        state->textures.destroy();
+        state->loader.destroy();
+        state->shaders.destroy();
         if (state->cubeVAO != 0)
         {
             glDeleteVertexArrays(1, &state->cubeVAO);
@@ -395,9 +846,49 @@ void SDL_AppQuit(void* appstate, SDL_AppResult result)
         {
             glDeleteBuffers(1, &state->VBO);
         }
+        if (state->cameraUBO != 0)
+        {
+            glDeleteBuffers(1, &state->cameraUBO);
+        }
+        SDL_Log("Simulation: %.2f ticks/frame on average, peak %d, %llu ticks dropped",
+                state->timestep.getAverageTicksPerFrame(), state->timestep.getPeakTicksPerFrame(),
+                static_cast<unsigned long long>(state->timestep.getDroppedTicks()));
+        SDL_Log("Frame pacing: %.1f ms waiting on fences, %.1f ms in limiter", state->pacer.getFenceWaitMs(),
+                state->pacer.getLimiterWaitMs());
+        SDL_Log("Assets: %zu files opened, %zu pack reads (%zu zero-copy), %zu loose reads",
+                assetFileSystem().getFileOpenCount(), assetFileSystem().getPackReadCount(),
+                assetFileSystem().getZeroCopyCount(), assetFileSystem().getLooseReadCount());
+        if (state->recorder)
+        {
+            state->recorder->close();
+            SDL_Log("Recorded %u frames of input", state->recorder->getFrameCount());
+        }
+        delete state->recorder;
+        delete state->replay;
+        delete state->report;
+        delete state->camera;
+        delete state->jobs;
         delete state;
     }
 
+    // Los contextos compartidos antes que el principal (usan su display)
+    if (loaderHeadless)
+    {
+        loaderHeadless->destroy();
+        delete loaderHeadless;
+    }
+
+    if (loaderContext)
+    {
+        SDL_GL_DestroyContext(loaderContext);
+    }
+
+    if (headless)
+    {
+        headless->destroy();
+        delete headless;
+    }
+
     if (context)
     {
         SDL_GL_DestroyContext(context);
@@ -0,0 +1,126 @@
+// GpuLoader sobre dos contextos EGL surfaceless (ver HeadlessContext.h): el de render en este hilo y uno
+// compartido para el hilo de carga. Uso: gpu_loader_test <directorio de fuentes> (shaders/ sueltos)
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "AssetFileSystem.h"
+#include "GpuLoader.h"
+#include "HeadlessContext.h"
+
+// CTest marca la prueba como omitida (SKIP_RETURN_CODE) si no hay contexto
+static constexpr int EXIT_SKIP = 77;
+static constexpr uint64_t PUBLISH_TIMEOUT_NS = 10000000000ull;
+
+static int failures = 0;
+
+static void check(bool condition, const char *what) {
+    printf("%s: %s\n", condition ? "ok" : "FAIL", what);
+    if (!condition) {
+        failures++;
+    }
+}
+
+// Hilo de render: publica hasta que el recurso este listo o pase el plazo
+static bool waitReady(GpuLoader &loader, GpuResourceId id) {
+    const uint64_t start = SDL_GetTicksNS();
+    while (!loader.isReady(id)) {
+        if (SDL_GetTicksNS() - start > PUBLISH_TIMEOUT_NS) {
+            return false;
+        }
+        loader.publish();
+        SDL_DelayNS(100000);
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) {
+        assetFileSystem().setLooseDirectory(argv[1]);
+    }
+
+    HeadlessContext render;
+    HeadlessContext loading;
+    if (!render.create(16, 16) || !loading.createShared(render)) {
+        printf("No surfaceless EGL context, skipping\n");
+        return EXIT_SKIP;
+    }
+
+    GpuLoader loader;
+    loader.start({nullptr, nullptr, &loading});
+
+    // Un buffer cuya creacion retiene el hilo de carga: sin fence emitida no se publica
+    const std::vector<uint8_t> bytes = {1, 2, 3, 4, 5, 6, 7, 8};
+    std::atomic<bool> gate(false);
+    std::atomic<bool> entered(false);
+    const GpuResourceId gated = loader.load(GPU_RESOURCE_BUFFER, [&]() {
+        entered = true;
+        while (!gate) {
+            SDL_DelayNS(100000);
+        }
+        unsigned int buffer;
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(bytes.size()), bytes.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return buffer;
+    });
+    while (!entered) {
+        SDL_DelayNS(100000);
+    }
+    bool early = false;
+    for (int i = 0; i < 50; i++) {
+        early = loader.publish() != 0 || loader.isReady(gated) || loader.get(gated) != 0 || early;
+        SDL_DelayNS(100000);
+    }
+    check(!early, "isReady stays false while the loader has not fenced the resource");
+    check(loader.getPendingCount() == 1, "the held resource is still pending");
+    gate = true;
+
+    check(waitReady(loader, gated), "the held buffer is published once its fence signals");
+    const unsigned int buffer = loader.get(gated);
+    check(buffer != 0 && glIsBuffer(buffer), "buffer is valid in the render context");
+    std::vector<uint8_t> readBack(bytes.size());
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glGetBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(readBack.size()), readBack.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    check(readBack == bytes, "buffer contents are complete when published");
+
+    SDL_Surface *surface = SDL_CreateSurface(4, 4, SDL_PIXELFORMAT_RGBA32);
+    for (int y = 0; y < surface->h; y++) {
+        memset(static_cast<uint8_t *>(surface->pixels) + y * surface->pitch, 0x40 + y, surface->w * 4);
+    }
+    const GpuResourceId texture = loader.loadTexture(surface);
+    const GpuResourceId vertices = loader.loadBuffer(GL_ARRAY_BUFFER, {9, 8, 7, 6});
+    const GpuResourceId program = loader.loadProgram("shaders/light.vert", "shaders/light.frag");
+
+    check(waitReady(loader, texture), "texture is published");
+    check(loader.get(texture) != 0 && glIsTexture(loader.get(texture)), "texture is valid in the render context");
+    uint8_t pixels[4 * 4 * 4] = {};
+    glBindTexture(GL_TEXTURE_2D, loader.get(texture));
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    check(pixels[0] == 0x40 && pixels[sizeof(pixels) - 1] == 0x43, "texture level 0 holds the surface pixels");
+
+    check(waitReady(loader, vertices), "buffer is published");
+    check(loader.get(vertices) != 0 && glIsBuffer(loader.get(vertices)), "loadBuffer result is valid in the render context");
+
+    check(waitReady(loader, program), "program is published");
+    int linked = GL_FALSE;
+    if (loader.get(program) != 0 && glIsProgram(loader.get(program))) {
+        glGetProgramiv(loader.get(program), GL_LINK_STATUS, &linked);
+    }
+    check(linked == GL_TRUE, "program is valid and linked in the render context");
+    check(loader.getPendingCount() == 0, "nothing left pending");
+
+    loader.stop();
+    loader.destroy();
+    loading.destroy();
+    render.destroy();
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    return 0;
+}
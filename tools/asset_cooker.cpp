@@ -0,0 +1,55 @@
+// Cocinado incremental de assets (ver AssetCooker.h): convierte los fuentes a los formatos del runtime en
+// el directorio de cache, en paralelo, y empaqueta el resultado. Solo cocina lo que cambio desde la ultima
+// vez (hash del contenido y de las dependencias).
+// Uso: asset_cooker --source DIR --cache DIR [--pack FILE] [--threads N]
+//                   [--shader-compiler PATH --glslang PATH --spirv-opt PATH] INPUT...
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "AssetCooker.h"
+
+int main(int argc, char *argv[]) {
+    AssetCookOptions options;
+    int threads = SDL_GetNumLogicalCPUCores();
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--source") == 0 && i + 1 < argc) {
+            options.sourceDirectory = argv[++i];
+        } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+            options.cacheDirectory = argv[++i];
+        } else if (strcmp(argv[i], "--pack") == 0 && i + 1 < argc) {
+            options.packPath = argv[++i];
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::max(atoi(argv[++i]), 1);
+        } else if (strcmp(argv[i], "--shader-compiler") == 0 && i + 1 < argc) {
+            options.shaderCompiler = argv[++i];
+        } else if (strcmp(argv[i], "--glslang") == 0 && i + 1 < argc) {
+            options.glslang = argv[++i];
+        } else if (strcmp(argv[i], "--spirv-opt") == 0 && i + 1 < argc) {
+            options.spirvOptimizer = argv[++i];
+        } else {
+            options.inputs.emplace_back(argv[i]);
+        }
+    }
+    if (options.sourceDirectory.empty() || options.cacheDirectory.empty() || options.inputs.empty()) {
+        printf("Usage: %s --source DIR --cache DIR [--pack FILE] [--threads N]\n"
+               "       [--shader-compiler PATH --glslang PATH --spirv-opt PATH] INPUT...\n", argv[0]);
+        return 1;
+    }
+    if (!options.shaderCompiler.empty() && (options.glslang.empty() || options.spirvOptimizer.empty())) {
+        printf("--shader-compiler needs --glslang and --spirv-opt\n");
+        return 1;
+    }
+
+    JobSystem jobs(threads);
+    AssetCookStats stats;
+    const uint64_t start = SDL_GetTicksNS();
+    const bool ok = cookAssets(options, jobs, stats);
+    printf("%zu sources: %zu cooked, %zu up to date, %zu failed, %zu stale outputs removed in %.1f ms\n",
+           stats.sourceCount, stats.cookedCount, stats.upToDateCount, stats.failedCount, stats.removedCount,
+           static_cast<double>(SDL_GetTicksNS() - start) / 1000000.0);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+// Empaquetador de assets: junta ficheros y directorios (recursivos) en un paquete (ver AssetPack.h) que la
+// aplicacion monta con AssetFileSystem. Cada fichero se guarda con su ruta relativa a --root (por defecto
+// el directorio actual); --root se aplica a las rutas que le siguen. El paquete se escribe aparte y se
+// renombra al final: un proceso que tenga mapeado el anterior no ve un fichero a medias. Si el paquete es
+// mas reciente que todas las entradas y tiene las mismas rutas no se reescribe.
+// Uso: asset_packer --out FILE [--root DIR] PATH... [--root DIR PATH...]
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "AssetPack.h"
+
+static void addFile(const std::filesystem::path &root, const std::filesystem::path &file,
+                    std::vector<AssetPackInput> &inputs) {
+    inputs.push_back({file.lexically_relative(root).generic_string(), file.string()});
+}
+
+static bool addPath(const std::filesystem::path &root, const std::string &input,
+                    std::vector<AssetPackInput> &inputs) {
+    const std::filesystem::path path = (root / input).lexically_normal();
+    std::error_code error;
+    if (std::filesystem::is_regular_file(path, error)) {
+        addFile(root, path, inputs);
+        return true;
+    }
+    if (!std::filesystem::is_directory(path, error)) {
+        printf("%s not found\n", path.string().c_str());
+        return false;
+    }
+    for (const auto &file: std::filesystem::recursive_directory_iterator(path, error)) {
+        if (file.is_regular_file()) {
+            addFile(root, file.path(), inputs);
+        }
+    }
+    return !error;
+}
+
+// La tabla del paquete existente tiene exactamente las rutas de inputs (nada borrado ni renombrado)
+static bool samePaths(const std::string &path, const std::vector<AssetPackInput> &inputs) {
+    std::ifstream file(path, std::ios::binary);
+    AssetPackHeader header = {};
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) || header.magic != ASSET_PACK_MAGIC ||
+        header.version != ASSET_PACK_VERSION || header.entryCount != inputs.size()) {
+        return false;
+    }
+    std::vector<AssetPackEntry> entries(header.entryCount);
+    if (!file.read(reinterpret_cast<char *>(entries.data()),
+                   static_cast<std::streamsize>(entries.size() * sizeof(AssetPackEntry)))) {
+        return false;
+    }
+    // Mismo orden que la tabla: hash y, a igualdad, ruta
+    std::vector<std::pair<uint64_t, std::string> > names;
+    for (const AssetPackInput &input: inputs) {
+        const std::string name = normalizeAssetPath(input.name);
+        names.emplace_back(hashAssetPath(name), name);
+    }
+    std::sort(names.begin(), names.end());
+    std::string stored;
+    for (size_t i = 0; i < names.size(); i++) {
+        stored.resize(entries[i].nameSize);
+        file.seekg(static_cast<std::streamoff>(entries[i].nameOffset));
+        if (names[i].first != entries[i].pathHash || entries[i].nameSize > names[i].second.size() ||
+            !file.read(stored.data(), static_cast<std::streamsize>(stored.size())) || stored != names[i].second) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    std::string output;
+    std::filesystem::path root = ".";
+    std::vector<AssetPackInput> inputs;
+    bool ok = true;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if (strcmp(argv[i], "--root") == 0 && i + 1 < argc) {
+            root = argv[++i];
+        } else {
+            ok = addPath(root, argv[i], inputs) && ok;
+        }
+    }
+    if (output.empty() || inputs.empty()) {
+        printf("Usage: %s --out FILE [--root DIR] PATH... [--root DIR PATH...]\n", argv[0]);
+        return 1;
+    }
+    if (!ok) {
+        return 1;
+    }
+    // Orden estable: el mismo contenido produce el mismo paquete
+    std::sort(inputs.begin(), inputs.end(), [](const AssetPackInput &a, const AssetPackInput &b) {
+        return a.name < b.name;
+    });
+
+    std::error_code error;
+    const auto packTime = std::filesystem::last_write_time(output, error);
+    bool upToDate = !error && samePaths(output, inputs);
+    for (size_t i = 0; upToDate && i < inputs.size(); i++) {
+        upToDate = std::filesystem::last_write_time(inputs[i].sourcePath, error) < packTime && !error;
+    }
+    if (upToDate) {
+        printf("%s up to date\n", output.c_str());
+        return 0;
+    }
+
+    const std::string temporary = output + ".tmp";
+    AssetPackSummary summary;
+    if (!writeAssetPack(temporary, inputs, &summary)) {
+        std::filesystem::remove(temporary, error);
+        return 1;
+    }
+    std::filesystem::rename(temporary, output, error);
+    if (error) {
+        printf("Unable to write %s: %s\n", output.c_str(), error.message().c_str());
+        return 1;
+    }
+    printf("%s: %zu entries (%zu LZ4), %llu -> %llu bytes, %llu bytes with alignment\n", output.c_str(),
+           summary.entryCount, summary.compressedCount, static_cast<unsigned long long>(summary.originalBytes),
+           static_cast<unsigned long long>(summary.storedBytes), static_cast<unsigned long long>(summary.packBytes));
+    return 0;
+}
@@ -0,0 +1,151 @@
+// Compilador offline de shaders: GLSL (con #include y los defines de cada variante de spirvPermutations())
+// -> SPIR-V para GL_ARB_gl_spirv con glslangValidator, optimizado con spirv-opt -O (eliminacion de codigo
+// muerto, plegado de constantes, inlining). Escribe OUT/<fichero>.<hash>.spv (ver Spirv.h) por variante y,
+// para comparar, el modulo sin optimizar en .unoptimized.spv, y muestra cuantas instrucciones quedan. Un
+// modulo cuyo hash ya existe no se recompila.
+// Uso: shader_compiler --glslang PATH --spirv-opt PATH --out DIR SHADER...
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Process.h"
+#include "ShaderSource.h"
+#include "Spirv.h"
+
+// glslang cita el fichero temporal: se cambia por "0" para que mapShaderLog lo entienda
+static std::string mapGlslangLog(std::string log, const std::string &temporary, const ShaderSource &source) {
+    for (size_t at = log.find(temporary); at != std::string::npos; at = log.find(temporary, at + 1)) {
+        log.replace(at, temporary.size(), "0");
+    }
+    return mapShaderLog(log, source);
+}
+
+// Una variante ya expandida de path
+static bool compile(const std::string &path, const ShaderSource &source, const std::string &glslang,
+                    const std::string &optimizer, const std::filesystem::path &outputDirectory) {
+    const std::string extension = std::filesystem::path(path).extension().string();
+    const std::string output = spirvPath(outputDirectory.string(), path, source);
+    if (std::filesystem::exists(output)) {
+        printf("%-24s up to date\n", path.c_str());
+        return true;
+    }
+
+    const std::string temporary = output + ".glsl";
+    // Se conserva para comparar (benchmark "spirv")
+    const std::string unoptimized = output.substr(0, output.size() - 4) + ".unoptimized.spv";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file << source.text;
+    }
+    // --auto-map-locations: entradas y salidas por orden de declaracion (los uniforms ya la llevan)
+    std::string log;
+    bool ok = runProcess({glslang, "-G", "-S", extension.substr(1), "--auto-map-locations", "-o", unoptimized,
+                          temporary}, log);
+    if (!ok) {
+        printf("%s: glslang failed\n%s", path.c_str(), mapGlslangLog(log, temporary, source).c_str());
+    }
+    if (ok) {
+        log.clear();
+        ok = runProcess({optimizer, "-O", unoptimized, "-o", output}, log);
+        if (!ok) {
+            printf("%s: spirv-opt failed\n%s", path.c_str(), log.c_str());
+        }
+    }
+
+    std::vector<uint32_t> before;
+    std::vector<uint32_t> after;
+    if (ok && readSpirv(unoptimized, before) && readSpirv(output, after)) {
+        const size_t beforeCount = countSpirvInstructions(before);
+        const size_t afterCount = countSpirvInstructions(after);
+        printf("%-24s %6zu -> %6zu instructions (%+.1f%%)\n", path.c_str(), beforeCount, afterCount,
+               beforeCount ? 100.0 * (static_cast<double>(afterCount) / static_cast<double>(beforeCount) - 1.0)
+                           : 0.0);
+    } else if (ok) {
+        printf("%s: invalid SPIR-V output\n", path.c_str());
+        ok = false;
+    }
+    std::error_code error;
+    std::filesystem::remove(temporary, error);
+    if (!ok) {
+        std::filesystem::remove(unoptimized, error);
+        std::filesystem::remove(output, error);
+    }
+    return ok;
+}
+
+// Todas las variantes de path; despues borra los modulos de versiones anteriores del mismo fichero
+static bool compileVariants(const std::string &path, const std::string &glslang, const std::string &optimizer,
+                            const std::filesystem::path &outputDirectory) {
+    const std::string extension = std::filesystem::path(path).extension().string();
+    if (extension != ".vert" && extension != ".frag") {
+        printf("%s: unknown stage (expected .vert or .frag)\n", path.c_str());
+        return false;
+    }
+    bool ok = true;
+    std::vector<std::string> current;
+    for (const ShaderPermutation &permutation: spirvPermutations()) {
+        ShaderSource source;
+        if (!loadShaderSource(path, source, permutation.defines())) {
+            printf("Unable to read %s\n", path.c_str());
+            return false;
+        }
+        const std::string output = spirvPath(outputDirectory.string(), path, source);
+        current.push_back(std::filesystem::path(output).filename().string());
+        current.push_back(std::filesystem::path(output.substr(0, output.size() - 4) + ".unoptimized.spv").
+                filename().string());
+        ok = compile(path, source, glslang, optimizer, outputDirectory) && ok;
+    }
+    if (!ok) {
+        return false;
+    }
+
+    const std::string prefix = std::filesystem::path(path).filename().string() + ".";
+    std::error_code error;
+    for (const auto &file: std::filesystem::directory_iterator(outputDirectory, error)) {
+        const std::string name = file.path().filename().string();
+        if (name.compare(0, prefix.size(), prefix) == 0 && file.path().extension() == ".spv" &&
+            std::find(current.begin(), current.end(), name) == current.end()) {
+            std::filesystem::remove(file.path(), error);
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    std::string glslang = "glslangValidator";
+    std::string optimizer = "spirv-opt";
+    std::string outputDirectory;
+    std::vector<std::string> inputs;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--glslang") == 0 && i + 1 < argc) {
+            glslang = argv[++i];
+        } else if (strcmp(argv[i], "--spirv-opt") == 0 && i + 1 < argc) {
+            optimizer = argv[++i];
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outputDirectory = argv[++i];
+        } else {
+            inputs.emplace_back(argv[i]);
+        }
+    }
+    if (outputDirectory.empty() || inputs.empty()) {
+        printf("Usage: %s --glslang PATH --spirv-opt PATH --out DIR SHADER...\n", argv[0]);
+        return 1;
+    }
+    std::error_code error;
+    std::filesystem::create_directories(outputDirectory, error);
+    if (error) {
+        printf("Unable to create %s: %s\n", outputDirectory.c_str(), error.message().c_str());
+        return 1;
+    }
+
+    bool ok = true;
+    for (const std::string &input: inputs) {
+        ok = compileVariants(input, glslang, optimizer, outputDirectory) && ok;
+    }
+    return ok ? 0 : 1;
+}
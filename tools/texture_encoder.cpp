@@ -0,0 +1,136 @@
+// Codificador offline: imagen (cualquier formato de SDL_image) -> DDS comprimido por bloques o
+// contenedor .tex (ver TextureFile.h), con la cadena de mips precalculada.
+// Uso: texture_encoder INPUT OUTPUT.dds|OUTPUT.tex [--format rgba8|bc1|bc3|bc4|bc5|bc7] [--threads N] [--no-mips]
+//                       [--mip-filter box|kaiser|lanczos] [--linear] [--alpha-cutoff A]
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "BlockCompression.h"
+#include "CompressedTexture.h"
+#include "JobSystem.h"
+#include "MipGenerator.h"
+#include "TextureFile.h"
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        printf("Usage: %s INPUT OUTPUT.dds|OUTPUT.tex [--format rgba8|bc1|bc3|bc4|bc5|bc7] [--threads N] [--no-mips]\n"
+               "       [--mip-filter box|kaiser|lanczos] [--linear] [--alpha-cutoff A]\n", argv[0]);
+        return 1;
+    }
+    const std::string input = argv[1];
+    const std::string output = argv[2];
+    const bool textureFile = output.size() > 4 && output.compare(output.size() - 4, 4, ".tex") == 0;
+    BlockFormat format = BLOCK_FORMAT_BC7;
+    bool compress = true;
+    int threads = SDL_GetNumLogicalCPUCores();
+    bool mips = true;
+    MipOptions mipOptions;
+    bool linear = false;
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            if (strcmp(argv[++i], "rgba8") == 0) {
+                compress = false;
+            } else if (!parseBlockFormat(argv[i], format)) {
+                printf("Unknown format '%s'\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::max(atoi(argv[++i]), 1);
+        } else if (strcmp(argv[i], "--no-mips") == 0) {
+            mips = false;
+        } else if (strcmp(argv[i], "--mip-filter") == 0 && i + 1 < argc) {
+            if (!parseMipFilter(argv[++i], mipOptions.filter)) {
+                printf("Unknown mip filter '%s'\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--linear") == 0) {
+            linear = true;
+        } else if (strcmp(argv[i], "--alpha-cutoff") == 0 && i + 1 < argc) {
+            mipOptions.alphaCutoff = static_cast<float>(atof(argv[++i]));
+        } else {
+            printf("Unknown option '%s'\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (!compress && !textureFile) {
+        printf("rgba8 is only available for .tex output\n");
+        return 1;
+    }
+
+    SDL_Surface *surface = IMG_Load(input.c_str());
+    if (!surface) {
+        printf("Unable to load image %s! SDL_image Error: %s\n", input.c_str(), SDL_GetError());
+        return 1;
+    }
+    SDL_Surface *converted = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA32);
+    SDL_DestroySurface(surface);
+    if (!converted) {
+        printf("Unable to convert %s: %s\n", input.c_str(), SDL_GetError());
+        return 1;
+    }
+
+    const int width = converted->w;
+    const int height = converted->h;
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+    for (int y = 0; y < height; y++) {
+        memcpy(pixels.data() + static_cast<size_t>(y) * width * 4,
+               static_cast<const uint8_t *>(converted->pixels) + static_cast<size_t>(y) * converted->pitch,
+               static_cast<size_t>(width) * 4);
+    }
+    SDL_DestroySurface(converted);
+
+    // BC4/BC5 guardan datos (alturas, normales): se filtran sin conversion sRGB
+    mipOptions.srgb = !linear && (!compress || (format != BLOCK_FORMAT_BC4 && format != BLOCK_FORMAT_BC5));
+    JobSystem jobs(threads);
+    std::vector<std::vector<uint8_t> > levels;
+    if (mips) {
+        const uint64_t start = SDL_GetTicksNS();
+        generateMips(pixels.data(), width, height, mipOptions, levels, &jobs);
+        const double seconds = static_cast<double>(SDL_GetTicksNS() - start) / 1000000000.0;
+        printf("mips: %s%s, %zu levels, %.1f MPix/s\n", mipFilterName(mipOptions.filter),
+               mipOptions.srgb ? " (sRGB)" : "", levels.size(),
+               static_cast<double>(width) * height / 1000000.0 / seconds);
+    } else {
+        levels.emplace_back(std::move(pixels));
+    }
+    if (!compress) {
+        printf("%s: rgba8 %dx%d, %zu levels\n", output.c_str(), width, height, levels.size());
+        return writeTextureFile(output, TEXTURE_FILE_RGBA8, width, height, levels) ? 0 : 1;
+    }
+
+    CompressedImage image = {format, width, height, {}};
+    std::vector<uint8_t> decoded;
+    uint64_t encodeNS = 0;
+    size_t encodedPixels = 0;
+    for (size_t level = 0; level < levels.size(); level++) {
+        const int levelWidth = std::max(width >> level, 1);
+        const int levelHeight = std::max(height >> level, 1);
+        std::vector<uint8_t> &blocks = image.levels.emplace_back(blockFormatLevelBytes(format, levelWidth, levelHeight));
+        const uint64_t start = SDL_GetTicksNS();
+        compressImage(format, levels[level].data(), levelWidth, levelHeight, blocks.data(), &jobs);
+        encodeNS += SDL_GetTicksNS() - start;
+        encodedPixels += static_cast<size_t>(levelWidth) * levelHeight;
+
+        decoded.resize(levels[level].size());
+        decompressImage(format, blocks.data(), levelWidth, levelHeight, decoded.data());
+        printf("level %zu: %dx%d, %.2f dB\n", level, levelWidth, levelHeight,
+               computePsnr(levels[level].data(), decoded.data(), static_cast<size_t>(levelWidth) * levelHeight,
+                           blockFormatChannels(format)));
+    }
+
+    const double seconds = static_cast<double>(encodeNS) / 1000000000.0;
+    printf("%s: %s %dx%d, %zu levels, %.1f MPix/s on %d threads\n", output.c_str(), blockFormatName(format),
+           width, height, image.levels.size(), static_cast<double>(encodedPixels) / 1000000.0 / seconds,
+           jobs.getThreadCount());
+    if (textureFile) {
+        return writeTextureFile(output, format + 1, width, height, image.levels) ? 0 : 1;
+    }
+    return writeDds(output, image) ? 0 : 1;
+}